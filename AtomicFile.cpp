@@ -0,0 +1,21 @@
+// AtomicFile.cpp
+#include "AtomicFile.h"
+#include <LittleFS.h>
+
+bool AtomicFile::write(const char* path, const char* tempPath, const void* header, size_t headerSize,
+                       const void* body, size_t bodySize) {
+    File file = LittleFS.open(tempPath, "w");
+    if (!file) {
+        Serial.println("❌ Ошибка записи: " + String(tempPath));
+        return false;
+    }
+    bool written = file.write((const uint8_t*)header, headerSize) == headerSize &&
+                   (bodySize == 0 || file.write((const uint8_t*)body, bodySize) == bodySize);
+    file.close();
+    if (!written) {
+        LittleFS.remove(tempPath);
+        return false;
+    }
+    LittleFS.remove(path);
+    return LittleFS.rename(tempPath, path);
+}
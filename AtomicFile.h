@@ -0,0 +1,16 @@
+// AtomicFile.h
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <Arduino.h>
+
+// Замена файла целиком: данные пишутся во временный файл, который затем
+// подменяет старый. Сбой посреди записи оставляет прежнюю версию
+class AtomicFile {
+public:
+    // Заголовок и необязательное тело подряд; false - старый файл не тронут
+    static bool write(const char* path, const char* tempPath, const void* header, size_t headerSize,
+                      const void* body = nullptr, size_t bodySize = 0);
+};
+
+#endif
@@ -0,0 +1,52 @@
+// Bh1750Driver.cpp
+#include "Bh1750Driver.h"
+
+// Время преобразования - максимум по даташиту (180 мс HIGH_RES, 24 мс LOW_RES при
+// MTreg 69), пропорционально MTreg
+static const LuxRange RANGES[] = {
+    {"H2 MT254", 663, 1000, 5000,  0},
+    {"H MT69",   180, 500,  30000, 3000},
+    {"H MT31",   81,  250,  60000, 20000},
+    {"L MT31",   11,  100,  0,     45000},
+};
+static const uint8_t RANGE_COUNT = sizeof(RANGES) / sizeof(RANGES[0]);
+static const BH1750::Mode MODES[RANGE_COUNT] = {
+    BH1750::ONE_TIME_HIGH_RES_MODE_2, BH1750::ONE_TIME_HIGH_RES_MODE,
+    BH1750::ONE_TIME_HIGH_RES_MODE, BH1750::ONE_TIME_LOW_RES_MODE
+};
+static const uint8_t MTREGS[RANGE_COUNT] = {254, BH1750_DEFAULT_MTREG, 31, 31};
+// Шкала 16-битного АЦП в lux: 65535 / 1.2 * 69 / MTreg, в режиме HIGH_RES_2 вдвое меньше
+static const float FULL_SCALE_LUX[RANGE_COUNT] = {7417, 54612, 121556, 121556};
+
+Bh1750Driver::Bh1750Driver() : LuxDriver(RANGES, RANGE_COUNT) {}
+
+bool Bh1750Driver::begin(uint8_t addr) {
+    address = addr;
+    // begin() в одиночном режиме сразу запускает первое преобразование
+    if (!meter.begin(MODES[range], addr)) return false;
+    return MTREGS[range] == BH1750_DEFAULT_MTREG || meter.setMTreg(MTREGS[range]);
+}
+
+uint32_t Bh1750Driver::start() {
+    // Одиночное преобразование: команда уходит на шину, ждать результат не нужно
+    return meter.configure(MODES[range]) ? RANGES[range].conversionMs : 0;
+}
+
+bool Bh1750Driver::ready() {
+    return meter.measurementReady();
+}
+
+void Bh1750Driver::waitReady() {
+    meter.measurementReady(true);
+}
+
+float Bh1750Driver::read() {
+    float lux = meter.readLightLevel();
+    saturated = lux >= FULL_SCALE_LUX[range] * 0.98f;
+    return lux;
+}
+
+bool Bh1750Driver::applyRange(uint8_t index) {
+    // Режим уходит на шину с каждым start(), MTreg - только при смене
+    return MTREGS[index] == MTREGS[range] || meter.setMTreg(MTREGS[index]);
+}
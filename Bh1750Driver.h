@@ -0,0 +1,33 @@
+// Bh1750Driver.h
+#ifndef BH1750_DRIVER_H
+#define BH1750_DRIVER_H
+
+#include <Arduino.h>
+#include <BH1750.h>
+#include "LuxDriver.h"
+
+// GY-30 (BH1750) в одиночных преобразованиях. Диапазоны - режим и MTreg:
+// HIGH_RES_2 с MTreg 254 дает 0.11 lx на отсчет в сумерках, LOW_RES с MTreg 31 -
+// преобразование за 11 мс и шкалу до 120 клк на солнце. Смена MTreg в библиотеке
+// занимает ~10 мс, но случается только на границе диапазона
+class Bh1750Driver : public LuxDriver {
+public:
+    static const uint8_t ADDRESS_LOW = 0x23;    // ADDR на GND
+    static const uint8_t ADDRESS_HIGH = 0x5C;   // ADDR на VCC
+
+    Bh1750Driver();
+    const char* getName() const override { return "BH1750"; }
+    bool begin(uint8_t address) override;
+    uint32_t start() override;
+    bool ready() override;
+    void waitReady() override;
+    float read() override;
+
+protected:
+    bool applyRange(uint8_t index) override;
+
+private:
+    BH1750 meter;
+};
+
+#endif
@@ -0,0 +1,68 @@
+// BootProfile.cpp
+#include "BootProfile.h"
+#include <esp_system.h>
+
+static BootPhase phases[BootProfile::MAX_PHASES];
+static uint8_t phaseCount = 0;
+static uint32_t setupStart = 0;
+static uint32_t lastMark = 0;
+static uint32_t setupMs = 0;
+static uint32_t controlMs = 0;
+static const char* sensorProbe = "none";
+
+void BootProfile::begin() {
+    setupStart = lastMark = millis();
+}
+
+void BootProfile::phase(const char* name) {
+    uint32_t now = millis();
+    uint8_t n = __atomic_load_n(&phaseCount, __ATOMIC_RELAXED);
+    if (n < MAX_PHASES) {
+        phases[n].name = name;
+        phases[n].ms = now - lastMark;
+        __atomic_store_n(&phaseCount, n + 1, __ATOMIC_RELEASE);
+    }
+    lastMark = now;
+}
+
+void BootProfile::finish() {
+    // Ноль значит "еще идет": setup() быстрее миллисекунды тоже не ноль
+    uint32_t ms = millis() - setupStart;
+    __atomic_store_n(&setupMs, ms ? ms : 1, __ATOMIC_RELEASE);
+}
+
+void BootProfile::setSensorProbe(const char* how) {
+    __atomic_store_n(&sensorProbe, how, __ATOMIC_RELEASE);
+}
+
+void BootProfile::markControl() {
+    if (controlMs) return;
+    uint32_t now = millis();
+    __atomic_store_n(&controlMs, now ? now : 1, __ATOMIC_RELEASE);
+}
+
+bool BootProfile::hasControl() {
+    return __atomic_load_n(&controlMs, __ATOMIC_ACQUIRE) != 0;
+}
+
+bool BootProfile::isColdBoot() {
+    return esp_reset_reason() == ESP_RST_POWERON;
+}
+
+uint8_t BootProfile::getPhases(BootPhase* out) {
+    uint8_t n = __atomic_load_n(&phaseCount, __ATOMIC_ACQUIRE);
+    memcpy(out, phases, n * sizeof(BootPhase));
+    return n;
+}
+
+uint32_t BootProfile::getSetupMs() {
+    return __atomic_load_n(&setupMs, __ATOMIC_ACQUIRE);
+}
+
+uint32_t BootProfile::getControlMs() {
+    return __atomic_load_n(&controlMs, __ATOMIC_ACQUIRE);
+}
+
+const char* BootProfile::getSensorProbe() {
+    return __atomic_load_n(&sensorProbe, __ATOMIC_ACQUIRE);
+}
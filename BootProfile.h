@@ -0,0 +1,34 @@
+// BootProfile.h
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+struct BootPhase {
+    const char* name;       // литерал из setup()
+    uint32_t ms;
+};
+
+// Длительность фаз setup() и время от загрузки до первого решения по реле.
+// Пишет только основной цикл, веб-задача читает: готовые фазы публикуются
+// счетчиком с release, поэтому читатель видит только заполненные записи
+class BootProfile {
+public:
+    static const uint8_t MAX_PHASES = 12;
+
+    static void begin();                     // начало setup()
+    static void phase(const char* name);     // закончилась фаза: время с прошлой отметки
+    static void finish();                    // конец setup()
+    static void setSensorProbe(const char* how);   // "cached", "mux", "scan" или "none"
+    // Первое решение по реле зоны 0 после загрузки; повторные вызовы ничего не меняют
+    static void markControl();
+    static bool hasControl();
+
+    static bool isColdBoot();                // включение питания, а не сброс
+    static uint8_t getPhases(BootPhase* out);   // out на MAX_PHASES
+    static uint32_t getSetupMs();            // 0 - setup() еще идет
+    static uint32_t getControlMs();          // millis() первого решения, 0 - его еще не было
+    static const char* getSensorProbe();
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Clock.cpp
+#include "Clock.h"
+#include "DebugLogger.h"
+#include "EventTrace.h"
+#include <esp_timer.h>
+#include <time.h>
+
+static uint32_t bootTime = 0;                  // UTC в момент загрузки, 0 - не задано
+static ClockSource source = CLOCK_SOURCE_NONE;
+
+static uint32_t uptimeSeconds() {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+// Дни от 1970-01-01 по григорианскому календарю, без таблиц и mktime()
+// (mktime() зависит от TZ, а нам нужен UTC)
+static int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yearOfEra = (uint32_t)(year - era * 400);
+    uint32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int32_t)dayOfEra - 719468;
+}
+
+void Clock::begin() {
+    // UTC без перехода на летнее время; местное смещение - настройка timezoneOffset.
+    // Без доступа в интернет (точка доступа) запрос просто не завершится
+    configTime(0, 0, "pool.ntp.org", "time.google.com");
+}
+
+void Clock::sync() {
+    struct tm utc;
+    if (!getLocalTime(&utc, 0)) return;
+    uint32_t t = (uint32_t)(daysFromCivil(utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday) * 86400L +
+                            utc.tm_hour * 3600 + utc.tm_min * 60 + utc.tm_sec);
+    set(t, CLOCK_SOURCE_SNTP);
+}
+
+bool Clock::set(uint32_t utc, ClockSource newSource) {
+    if (utc < MIN_VALID_TIME) return false;
+    int32_t correction = isSet() ? (int32_t)(utc - now()) : 0;
+    ClockSource oldSource = source;
+    __atomic_store_n(&bootTime, utc - uptimeSeconds(), __ATOMIC_RELAXED);
+    __atomic_store_n(&source, newSource, __ATOMIC_RELAXED);
+
+    // SNTP повторяется каждые CLOCK_SYNC_INTERVAL - мелкие поправки не засоряют лог
+    if (oldSource != newSource || correction > 2 || correction < -2) {
+        EventTrace::record(TRACE_CLOCK_SET, newSource, correction);
+        EVENT_LOGF(LOG_MODULE_MAIN, "🕒 Часы установлены (%s): %lu, поправка %ld с",
+                   getSourceName(newSource), (unsigned long)utc, (long)correction);
+    }
+    return true;
+}
+
+bool Clock::isSet() {
+    return __atomic_load_n(&bootTime, __ATOMIC_RELAXED) != 0;
+}
+
+uint32_t Clock::now() {
+    uint32_t base = __atomic_load_n(&bootTime, __ATOMIC_RELAXED);
+    return base ? base + uptimeSeconds() : 0;
+}
+
+ClockSource Clock::getSource() {
+    return __atomic_load_n(&source, __ATOMIC_RELAXED);
+}
+
+const char* Clock::getSourceName(ClockSource clockSource) {
+    switch (clockSource) {
+        case CLOCK_SOURCE_SNTP: return "sntp";
+        case CLOCK_SOURCE_API: return "api";
+        default: return "none";
+    }
+}
+
+bool Clock::getLocal(int32_t offsetMinutes, LocalTime& local) {
+    uint32_t utc = now();
+    if (!utc) return false;
+    int64_t t = (int64_t)utc + offsetMinutes * 60;
+    uint32_t days = (uint32_t)(t / 86400);
+    local.weekday = (days + 3) % 7;   // 1970-01-01 - четверг
+    local.minute = (uint16_t)((t % 86400) / 60);
+    return true;
+}
@@ -0,0 +1,36 @@
+// Clock.h
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <Arduino.h>
+
+enum ClockSource : uint8_t {
+    CLOCK_SOURCE_NONE,    // время не известно
+    CLOCK_SOURCE_SNTP,
+    CLOCK_SOURCE_API      // POST /api/clock
+};
+
+struct LocalTime {
+    uint8_t weekday;      // 0 - понедельник
+    uint16_t minute;      // минута суток
+};
+
+// Часы реального времени (UTC). Хранится одно слово - время загрузки в секундах,
+// текущее время = оно + 64-битный таймер с загрузки, поэтому читать можно из любой задачи.
+// Источники: SNTP (запрос при begin(), результат забирает sync()) и API
+class Clock {
+public:
+    static const uint32_t MIN_VALID_TIME = 1704067200;   // 2024-01-01: раньше - часы не заданы
+
+    static void begin();
+    static void sync();                                 // основной цикл, раз в CLOCK_SYNC_INTERVAL
+    static bool set(uint32_t utc, ClockSource source);  // основной цикл
+    static bool isSet();
+    static uint32_t now();                              // UTC, 0 - не задано
+    static ClockSource getSource();
+    static const char* getSourceName(ClockSource source);
+    // Местное время со смещением offsetMinutes от UTC; false - часы не заданы
+    static bool getLocal(int32_t offsetMinutes, LocalTime& local);
+};
+
+#endif
@@ -1,17 +1,51 @@
 // Config.cpp
 #include "Config.h"
+#include "ConfigStore.h"
 #include "DebugLogger.h"
+#include <stddef.h>
 
 Settings config;
+Schedule lightSchedule;
+
+const SettingField SETTING_FIELDS[SETTING_COUNT] = {
+    {"lightThreshold",    SETTING_TYPE_FLOAT,    offsetof(Settings, lightThreshold),    0,    100000,   TRACE_CONFIG_THRESHOLD},
+    {"checkInterval",     SETTING_TYPE_UINT,     offsetof(Settings, checkInterval),     100,  3600000,  TRACE_CONFIG_CHECK_INTERVAL},
+    {"sensorLogInterval", SETTING_TYPE_UINT,     offsetof(Settings, sensorLogInterval), 1000, 86400000, TRACE_CONFIG_SENSOR_LOG_INTERVAL},
+    {"sampleMaxAge",      SETTING_TYPE_UINT,     offsetof(Settings, sampleMaxAge),      100,  600000,   TRACE_CONFIG_SAMPLE_MAX_AGE},
+    {"autoMode",          SETTING_TYPE_BOOL,     offsetof(Settings, autoMode),          0,    1,        TRACE_CONFIG_AUTO_MODE},
+    {"manualOn",          SETTING_TYPE_BOOL,     offsetof(Settings, manualOn),          0,    1,        TRACE_CONFIG_MANUAL_ON},
+    {"debugEnabled",      SETTING_TYPE_BOOL,     offsetof(Settings, debugEnabled),      0,    1,        TRACE_CONFIG_DEBUG},
+    // Не меньше двух сегментов лога по 4 КБ
+    {"maxLogSize",        SETTING_TYPE_UINT,     offsetof(Settings, maxLogSize),        8192, 1048576,  TRACE_CONFIG_MAX_LOG_SIZE},
+    // Применяется при следующей загрузке: смена размера кольца стирает показания
+    {"sensorStoreSize",   SETTING_TYPE_UINT,     offsetof(Settings, sensorStoreSize),   8192, 1048576,  TRACE_CONFIG_SENSOR_STORE_SIZE},
+    {"schedule",          SETTING_TYPE_SCHEDULE, offsetof(Settings, schedule),          0,    0,        TRACE_CONFIG_SCHEDULE},
+    {"hysteresis",        SETTING_TYPE_FLOAT,    offsetof(Settings, hysteresis),        0,    10000,    TRACE_CONFIG_HYSTERESIS},
+    {"minOnTime",         SETTING_TYPE_UINT,     offsetof(Settings, minOnTime),         0,    86400000, TRACE_CONFIG_MIN_ON_TIME},
+    {"minOffTime",        SETTING_TYPE_UINT,     offsetof(Settings, minOffTime),        0,    86400000, TRACE_CONFIG_MIN_OFF_TIME},
+    {"filterAlpha",       SETTING_TYPE_FLOAT,    offsetof(Settings, filterAlpha),       0.01, 1,        TRACE_CONFIG_FILTER_ALPHA},
+    {"timezoneOffset",    SETTING_TYPE_INT,      offsetof(Settings, timezoneOffset),    -720, 840,      TRACE_CONFIG_TIMEZONE},
+    {"dliMode",           SETTING_TYPE_BOOL,     offsetof(Settings, dliMode),           0,    1,        TRACE_CONFIG_DLI_MODE},
+    {"dliTarget",         SETTING_TYPE_FLOAT,    offsetof(Settings, dliTarget),         0,    100,      TRACE_CONFIG_DLI_TARGET},
+    {"luxToPpfd",         SETTING_TYPE_FLOAT,    offsetof(Settings, luxToPpfd),         0.001, 1,       TRACE_CONFIG_LUX_TO_PPFD},
+    {"lampPpfd",          SETTING_TYPE_FLOAT,    offsetof(Settings, lampPpfd),          0,    3000,     TRACE_CONFIG_LAMP_PPFD},
+    {"dayStart",          SETTING_TYPE_UINT,     offsetof(Settings, dayStart),          0,    1439,     TRACE_CONFIG_DAY_START},
+    {"dimMode",           SETTING_TYPE_BOOL,     offsetof(Settings, dimMode),           0,    1,        TRACE_CONFIG_DIM_MODE},
+    {"dimTarget",         SETTING_TYPE_FLOAT,    offsetof(Settings, dimTarget),         0,    100000,   TRACE_CONFIG_DIM_TARGET},
+    {"dimKp",             SETTING_TYPE_FLOAT,    offsetof(Settings, dimKp),             0,    10,       TRACE_CONFIG_DIM_KP},
+    {"dimKi",             SETTING_TYPE_FLOAT,    offsetof(Settings, dimKi),             0,    10,       TRACE_CONFIG_DIM_KI},
+    {"failSafe",          SETTING_TYPE_UINT,     offsetof(Settings, failSafe),          0,    2,        TRACE_CONFIG_FAIL_SAFE},
+};
 
 void loadConfig() {
-    // Временная заглушка - позже реализуем EEPROM
-    Serial.println("⚙️ Загружены настройки по умолчанию");
+    if (!ConfigStore::load(config)) {
+        Serial.println("⚙️ Загружены настройки по умолчанию");
+    }
+    compileSchedule();
 }
 
 void saveConfig() {
-    // Временная заглушка
-    Serial.println("⚙️ Настройки сохранены (заглушка)");
+    ConfigStore::markDirty();
 }
 
 void printConfig() {
@@ -24,4 +58,116 @@ void printConfig() {
     Serial.println("Режим: " + String(config.autoMode ? "Авто" : "Ручной"));
     Serial.println("Отладка: " + String(config.debugEnabled ? "ВКЛ" : "ВЫКЛ"));
     Serial.println("=================================");
-}
\ No newline at end of file
+}
+
+bool isValidSchedule(const char* text) {
+    return Schedule::compile(text, nullptr);
+}
+
+// Проверенный текст всегда разбирается; если нет - остается прежняя карта
+void compileSchedule() {
+    if (!Schedule::compile(config.schedule, &lightSchedule)) {
+        Serial.println("⚠️ Некорректное расписание: " + String(config.schedule));
+    }
+}
+
+size_t getSettingSize(SettingType type) {
+    switch (type) {
+        case SETTING_TYPE_FLOAT: return sizeof(float);
+        case SETTING_TYPE_UINT: return sizeof(uint32_t);
+        case SETTING_TYPE_INT: return sizeof(int32_t);
+        case SETTING_TYPE_BOOL: return sizeof(bool);
+        case SETTING_TYPE_SCHEDULE: return sizeof(Settings::schedule);
+    }
+    return 0;
+}
+
+// Расписание в трассировке - минуты света в неделю
+float getSettingValue(SettingId id, const Settings& settings) {
+    const SettingField& field = SETTING_FIELDS[id];
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(&settings) + field.offset;
+    switch (field.type) {
+        case SETTING_TYPE_FLOAT: return *reinterpret_cast<const float*>(source);
+        case SETTING_TYPE_UINT: return *reinterpret_cast<const uint32_t*>(source);
+        case SETTING_TYPE_INT: return *reinterpret_cast<const int32_t*>(source);
+        case SETTING_TYPE_BOOL: return *reinterpret_cast<const bool*>(source) ? 1 : 0;
+        case SETTING_TYPE_SCHEDULE: {
+            Schedule schedule;
+            if (!Schedule::compile(reinterpret_cast<const char*>(source), &schedule)) return 0;
+            return schedule.getMinutesPerWeek();
+        }
+    }
+    return 0;
+}
+
+uint32_t applySettings(const Settings& source, uint32_t mask) {
+    uint32_t changed = 0;
+    for (uint8_t id = 0; id < SETTING_COUNT; id++) {
+        if (!(mask & (1UL << id))) continue;
+        const SettingField& field = SETTING_FIELDS[id];
+        uint8_t* target = reinterpret_cast<uint8_t*>(&config) + field.offset;
+        const uint8_t* value = reinterpret_cast<const uint8_t*>(&source) + field.offset;
+        size_t size = getSettingSize(field.type);
+        if (memcmp(target, value, size) == 0) continue;
+        
+        float before = getSettingValue((SettingId)id, config);
+        memcpy(target, value, size);
+        changed |= 1UL << id;
+        EventTrace::recordFloat(TRACE_CONFIG_CHANGE, field.trace, getSettingValue((SettingId)id, config));
+        EVENT_LOGF(LOG_MODULE_MAIN, "⚙️ %s: %.2f -> %.2f", field.name, before, getSettingValue((SettingId)id, config));
+    }
+    
+    if (changed & (1UL << SETTING_MAX_LOG_SIZE)) DebugLogger::setMaxLogSize(config.maxLogSize);
+    if (changed & (1UL << SETTING_SCHEDULE)) compileSchedule();
+    if (changed) saveConfig();
+    return changed;
+}
+
+static const char* const ZONE_MODE_NAMES[] = {"auto", "on", "off"};
+
+float getZoneThreshold(const Settings& settings, uint8_t zone) {
+    return zone == 0 ? settings.lightThreshold : settings.zoneThreshold[zone];
+}
+
+ZoneMode getZoneMode(const Settings& settings, uint8_t zone) {
+    if (zone == 0) return settings.autoMode ? ZONE_MODE_AUTO : settings.manualOn ? ZONE_MODE_ON : ZONE_MODE_OFF;
+    return (ZoneMode)settings.zoneMode[zone];
+}
+
+const char* getZoneModeName(ZoneMode mode) {
+    return mode <= ZONE_MODE_OFF ? ZONE_MODE_NAMES[mode] : "unknown";
+}
+
+bool parseZoneMode(const char* name, ZoneMode& mode) {
+    for (uint8_t m = ZONE_MODE_AUTO; m <= ZONE_MODE_OFF; m++) {
+        if (strcmp(name, ZONE_MODE_NAMES[m]) == 0) {
+            mode = (ZoneMode)m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Зона 0 меняется через applySettings(): ее поля - обычные настройки
+uint8_t applyZoneSettings(const Settings& source, uint8_t thresholdMask, uint8_t modeMask) {
+    uint8_t changed = 0;
+    for (uint8_t zone = 1; zone < MAX_ZONES; zone++) {
+        uint8_t bit = 1 << zone;
+        if ((thresholdMask & bit) && config.zoneThreshold[zone] != source.zoneThreshold[zone]) {
+            EVENT_LOGF(LOG_MODULE_MAIN, "⚙️ Зона %u, порог: %.2f -> %.2f", zone,
+                       config.zoneThreshold[zone], source.zoneThreshold[zone]);
+            config.zoneThreshold[zone] = source.zoneThreshold[zone];
+            EventTrace::recordFloat(TRACE_CONFIG_CHANGE, TRACE_CONFIG_ZONE_THRESHOLD | zone << 8, config.zoneThreshold[zone]);
+            changed |= 1 << zone;
+        }
+        if ((modeMask & bit) && config.zoneMode[zone] != source.zoneMode[zone]) {
+            EVENT_LOGF(LOG_MODULE_MAIN, "⚙️ Зона %u, режим: %s -> %s", zone,
+                       getZoneModeName((ZoneMode)config.zoneMode[zone]), getZoneModeName((ZoneMode)source.zoneMode[zone]));
+            config.zoneMode[zone] = source.zoneMode[zone];
+            EventTrace::recordFloat(TRACE_CONFIG_CHANGE, TRACE_CONFIG_ZONE_MODE | zone << 8, config.zoneMode[zone]);
+            changed |= 1 << zone;
+        }
+    }
+    if (changed) saveConfig();
+    return changed;
+}
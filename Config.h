@@ -3,6 +3,8 @@
 #define CONFIG_H
 
 #include <Arduino.h>
+#include "EventTrace.h"
+#include "Schedule.h"
 
 // === Пины ESP32 ===
 const uint8_t RELAY_PIN = 4;
@@ -10,24 +12,174 @@ const uint8_t I2C_SDA = 13;
 const uint8_t I2C_SCL = 14;
 const uint8_t STATUS_LED = 2;
 const uint8_t RGB_LED_PIN = 5;
+const uint8_t DIM_PIN = 25;        // ШИМ-вход диммируемого драйвера лампы зоны 0
+
+// === Зоны: реле + датчик BH1750 за мультиплексором TCA9548A ===
+// Без мультиплексора зона одна - датчик прямо на шине, как раньше
+const uint8_t MAX_ZONES = 8;
+const uint8_t ZONE_RELAY_PINS[MAX_ZONES] = {RELAY_PIN, 16, 17, 18, 19, 21, 22, 23};
+const uint8_t I2C_MUX_ADDRESS = 0x70;        // TCA9548A, A0-A2 на GND
+const uint32_t I2C_MUX_CLOCK = 400000;       // TCA9548A и BH1750 держат fast mode
+
+enum ZoneMode : uint8_t {
+    ZONE_MODE_AUTO,       // порог, расписание, минимальное время вкл/выкл
+    ZONE_MODE_ON,
+    ZONE_MODE_OFF
+};
+
+// Реле зоны в авторежиме, пока ее датчик потерян (SENSOR_LOST) и снимок устарел
+enum FailSafeMode : uint8_t {
+    FAIL_SAFE_HOLD,       // последнее состояние
+    FAIL_SAFE_OFF,
+    FAIL_SAFE_SCHEDULE    // включено внутри фотопериода
+};
+
+// === Периоды фоновых задач (мс) ===
+const uint32_t BLINK_INTERVAL = 1000;
+const uint32_t RGB_UPDATE_INTERVAL = 500;
+const uint32_t SENSOR_SAMPLE_INTERVAL = 500;  // опрос датчика в общий кэш; диапазон датчика меняет его от 100 до 1000
+const uint32_t SENSOR_HEALTH_INTERVAL = 250;  // проверка, не пора ли восстанавливать потерянный датчик
+const uint32_t WEB_POLL_INTERVAL = 10;  // задержка ответа на HTTP не больше этого (задача веб-сервера)
+const uint32_t COMMAND_POLL_INTERVAL = 1000;  // страховочный опрос команд; обычно задачу будит SharedState::post()
+const uint32_t EVENT_PUSH_INTERVAL = 250;         // проверка изменений для подписчиков /api/events
+const uint32_t EVENT_HEARTBEAT_INTERVAL = 15000;  // событие heartbeat, если изменений нет
+const uint32_t CONFIG_COMMIT_POLL_INTERVAL = 1000;   // проверка отложенной записи настроек
+const uint32_t CONFIG_COMMIT_DELAY = 5000;           // запись после 5 с без изменений...
+const uint32_t CONFIG_COMMIT_MAX_DELAY = 60000;      // ...но не позже минуты от первого
+const uint32_t CLOCK_SYNC_INTERVAL = 60000;          // забрать время SNTP
+const uint32_t HISTORY_CHECKPOINT_INTERVAL = 30UL * 60 * 1000;   // история в RAM -> LittleFS
+
+// === Диммер: ШИМ LEDC и ПИ-регулятор ===
+const uint8_t DIM_LEDC_CHANNEL = 0;
+const uint32_t DIM_PWM_FREQUENCY = 5000;     // Гц; 80 МГц / 2^12 допускает до ~19 кГц
+const uint8_t DIM_PWM_BITS = 12;
+const uint16_t DIM_DUTY_MAX = (1 << DIM_PWM_BITS) - 1;
+const uint32_t DIM_CONTROL_INTERVAL = 100;   // мс: шаг ПИ-регулятора и плавного изменения
+const uint32_t DIM_RAMP_TIME = 2000;         // мс от нуля до полной яркости
+
+// === Восстановление датчика ===
+const uint8_t SENSOR_LOST_FAILURES = 3;       // ошибок подряд до SENSOR_LOST
+const uint32_t SENSOR_BACKOFF_MIN = 1000;     // мс до первой попытки, дальше вдвое больше
+const uint32_t SENSOR_BACKOFF_MAX = 60000;
+const uint8_t I2C_CLEAR_PULSES = 9;           // тактов SCL, чтобы ведомый отпустил SDA
+
+// === Режим DLI ===
+const float DLI_HYSTERESIS_RATIO = 0.05;     // выключенная лампа включается, когда прогноз ниже цели на 5%
+const uint32_t DLI_NATURAL_TAU = 15UL * 60 * 1000;   // постоянная времени среднего естественного света, мс
+
+// === Поток событий /api/events ===
+const uint8_t MAX_EVENT_CLIENTS = 4;
+const float EVENT_LUX_DEADBAND = 5.0;        // lux: изменение меньше max(5 lux, 2%) не отправляется
+const float EVENT_LUX_DEADBAND_RATIO = 0.02;
+const uint32_t EVENT_WRITE_TIMEOUT = 100;    // мс на запись кадра; не успел - подписчик отключается
 
 // === Настройки по умолчанию ===
 struct Settings {
     float lightThreshold = 500.0;
-    uint32_t checkInterval = 10000;
+    uint32_t checkInterval = 1000;   // дребезг гасят фильтр, гистерезис и minOnTime/minOffTime
     uint32_t sensorLogInterval = 5000;
+    uint32_t sampleMaxAge = 2000;    // старше - снимок освещенности недействителен
     bool autoMode = true;
     bool manualOn = false;
     bool debugEnabled = true;
     uint32_t maxLogSize = 50 * 1024; // 50KB - ДОБАВЛЯЕМ
-    String schedule = "08:00-20:00";
+    uint32_t sensorStoreSize = 512 * 1024; // кольцо показаний: 128 сегментов по 340 записей
+    char schedule[64] = "08:00-20:00";   // фотопериод, формат в Schedule.h
+    float hysteresis = 50.0;         // lux: ширина полосы вокруг порога
+    uint32_t minOnTime = 60000;      // реле не выключается раньше, мс
+    uint32_t minOffTime = 60000;     // реле не включается раньше, мс
+    float filterAlpha = 0.2;         // EMA на отсчет при опросе раз в SENSOR_SAMPLE_INTERVAL; 1 - без сглаживания
+    int32_t timezoneOffset = 180;    // минуты от UTC для расписания (MSK)
+    bool dliMode = false;            // авторежим добирает dliTarget вместо порога lux
+    float dliTarget = 12.0;          // mol/m² в сутки
+    float luxToPpfd = 0.0185;        // µmol/m²/s на lux (солнце; для белых LED ~0.015)
+    float lampPpfd = 100.0;          // µmol/m²/s лампы у датчика
+    uint32_t dayStart = 0;           // граница суток DLI, минута местного времени
+    bool dimMode = false;            // авторежим держит dimTarget ШИМ-диммером
+    float dimTarget = 600.0;         // lux: уставка ПИ-регулятора
+    // Лампа lampPpfd по умолчанию дает у датчика ~5400 lux: с dimKp от ~0.01
+    // контур с П-частью уже раскачивается
+    float dimKp = 0.005;             // % скважности на lux ошибки
+    float dimKi = 0.02;              // % скважности на lux ошибки в секунду
+    uint32_t failSafe = FAIL_SAFE_HOLD;   // FailSafeMode
+    // Зоны 1..MAX_ZONES-1; у зоны 0 - lightThreshold, autoMode и manualOn.
+    // Меняются через /api/zone, в таблицу SETTING_FIELDS не входят
+    float zoneThreshold[MAX_ZONES] = {500.0, 500.0, 500.0, 500.0, 500.0, 500.0, 500.0, 500.0};
+    uint8_t zoneMode[MAX_ZONES] = {};   // ZoneMode
+    // Где датчик работал в прошлый раз: с этого начинается следующая загрузка.
+    // Пишет setup(), в /api/settings не входит
+    uint8_t sensorAddress = 0;       // адрес I2C прямо на шине, 0 - неизвестно
+    uint32_t sensorBusClock = 0;     // Гц
     // УБИРАЕМ wifiSSID и wifiPassword отсюда
 };
 
 extern Settings config;
+extern Schedule lightSchedule;   // config.schedule, разобранное compileSchedule()
+
+// Поля Settings, которые меняются через /api/settings; индекс - бит в маске applySettings()
+enum SettingId : uint8_t {
+    SETTING_LIGHT_THRESHOLD,
+    SETTING_CHECK_INTERVAL,
+    SETTING_SENSOR_LOG_INTERVAL,
+    SETTING_SAMPLE_MAX_AGE,
+    SETTING_AUTO_MODE,
+    SETTING_MANUAL_ON,
+    SETTING_DEBUG_ENABLED,
+    SETTING_MAX_LOG_SIZE,
+    SETTING_SENSOR_STORE_SIZE,
+    SETTING_SCHEDULE,
+    SETTING_HYSTERESIS,
+    SETTING_MIN_ON_TIME,
+    SETTING_MIN_OFF_TIME,
+    SETTING_FILTER_ALPHA,
+    SETTING_TIMEZONE_OFFSET,
+    SETTING_DLI_MODE,
+    SETTING_DLI_TARGET,
+    SETTING_LUX_TO_PPFD,
+    SETTING_LAMP_PPFD,
+    SETTING_DAY_START,
+    SETTING_DIM_MODE,
+    SETTING_DIM_TARGET,
+    SETTING_DIM_KP,
+    SETTING_DIM_KI,
+    SETTING_FAIL_SAFE,
+    SETTING_COUNT
+};
+
+enum SettingType : uint8_t {
+    SETTING_TYPE_FLOAT,
+    SETTING_TYPE_UINT,
+    SETTING_TYPE_INT,
+    SETTING_TYPE_BOOL,
+    SETTING_TYPE_SCHEDULE
+};
+
+struct SettingField {
+    const char* name;
+    SettingType type;
+    size_t offset;              // offsetof(Settings, ...)
+    double min;                 // диапазон для чисел
+    double max;
+    TraceConfigField trace;
+};
+
+extern const SettingField SETTING_FIELDS[SETTING_COUNT];
 
 void loadConfig();
-void saveConfig();
+void saveConfig();   // только помечает config измененным, запись откладывает ConfigStore
 void printConfig();
+bool isValidSchedule(const char* text);
+void compileSchedule();          // после загрузки или изменения config.schedule
+size_t getSettingSize(SettingType type);
+float getSettingValue(SettingId id, const Settings& settings);   // для лога и трассировки
+// Переносит в config поля из mask (биты SettingId), пишет изменения в трассировку
+// и лог, сохраняет настройки. Вызывается только из основного цикла
+uint32_t applySettings(const Settings& source, uint32_t mask);
+// То же для зон 1..: порог зон из thresholdMask, режим - из modeMask (бит - номер зоны)
+uint8_t applyZoneSettings(const Settings& source, uint8_t thresholdMask, uint8_t modeMask);
+float getZoneThreshold(const Settings& settings, uint8_t zone);
+ZoneMode getZoneMode(const Settings& settings, uint8_t zone);
+const char* getZoneModeName(ZoneMode mode);
+bool parseZoneMode(const char* name, ZoneMode& mode);
 
 #endif
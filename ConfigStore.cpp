@@ -0,0 +1,293 @@
+// ConfigStore.cpp
+#include "ConfigStore.h"
+#include "DebugLogger.h"
+#include <LittleFS.h>
+
+static const uint32_t SLOT_MAGIC = 0x47464350;   // "PCFG"
+static const uint16_t FORMAT_VERSION = 1;
+static const char* SLOT_PATHS[2] = {"/config-a.bin", "/config-b.bin"};
+
+struct __attribute__((packed)) SlotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;      // байт полей после заголовка
+    uint32_t sequence;
+    uint32_t crc;         // CRC32 полей и sequence
+};
+
+// Зона 1..MAX_ZONES-1 - запись с id ZONE_RECORD | зона: порог (float) и режим (байт)
+static const uint8_t ZONE_RECORD = 0x80;
+static const uint8_t ZONE_RECORD_SIZE = sizeof(float) + 1;
+// Последний рабочий датчик: адрес (байт) и скорость шины (uint32)
+static const uint8_t SENSOR_BUS_RECORD = 0x40;
+static const uint8_t SENSOR_BUS_RECORD_SIZE = 1 + sizeof(uint32_t);
+
+// Все поля с заголовками по 2 байта: числа и флаги не длиннее 4 байт, расписание
+// одно и не длиннее своего поля. Сейчас около 270 байт - буфер на стеке любой задачи
+static const size_t MAX_FIELD_SIZE = sizeof(uint32_t);
+static const size_t MAX_FIELDS_PAYLOAD = SETTING_COUNT * (2 + MAX_FIELD_SIZE) + sizeof(Settings::schedule) - MAX_FIELD_SIZE;
+static const size_t MAX_PAYLOAD = MAX_FIELDS_PAYLOAD + (MAX_ZONES - 1) * (2 + ZONE_RECORD_SIZE) +
+                                  2 + SENSOR_BUS_RECORD_SIZE;
+
+static uint32_t sequence = 0;
+static int8_t activeSlot = -1;      // слот с последней записью, -1 - нет
+static uint32_t committedCrc = 0;   // CRC содержимого активного слота
+
+static uint32_t dirtySince = 0;     // millis() первого несохраненного изменения
+static uint32_t lastChange = 0;
+static bool dirty = false;
+
+static uint32_t statRequests = 0;
+static uint32_t statWrites = 0;
+static uint32_t statSkipped = 0;
+static uint32_t statErrors = 0;
+
+static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static uint32_t slotCrc(const uint8_t* payload, size_t length, uint32_t seq) {
+    return crc32(payload, length, crc32((const uint8_t*)&seq, sizeof(seq)));
+}
+
+// 0 - поля не помещаются в MAX_PAYLOAD (новый длинный тип без правки оценки)
+static size_t encode(const Settings& settings, uint8_t* out) {
+    size_t n = 0;
+    for (uint8_t id = 0; id < SETTING_COUNT; id++) {
+        const SettingField& field = SETTING_FIELDS[id];
+        const uint8_t* value = reinterpret_cast<const uint8_t*>(&settings) + field.offset;
+        size_t size = getSettingSize(field.type);
+        // Расписание - только строка с нулем, а не все поле
+        if (field.type == SETTING_TYPE_SCHEDULE) size = strnlen((const char*)value, size - 1) + 1;
+        if (n + 2 + size > MAX_FIELDS_PAYLOAD) return 0;
+        out[n++] = id;
+        out[n++] = (uint8_t)size;
+        memcpy(out + n, value, size);
+        n += size;
+    }
+    for (uint8_t zone = 1; zone < MAX_ZONES; zone++) {
+        out[n++] = ZONE_RECORD | zone;
+        out[n++] = ZONE_RECORD_SIZE;
+        memcpy(out + n, &settings.zoneThreshold[zone], sizeof(float));
+        out[n + sizeof(float)] = settings.zoneMode[zone];
+        n += ZONE_RECORD_SIZE;
+    }
+    if (settings.sensorAddress) {
+        out[n++] = SENSOR_BUS_RECORD;
+        out[n++] = SENSOR_BUS_RECORD_SIZE;
+        out[n] = settings.sensorAddress;
+        memcpy(out + n + 1, &settings.sensorBusClock, sizeof(uint32_t));
+        n += SENSOR_BUS_RECORD_SIZE;
+    }
+    return n;
+}
+
+// Адрес 7-битный, скорость - в пределах, которые держит контроллер I2C ESP32
+static bool decodeSensorBus(const uint8_t* value, uint8_t size, Settings& settings) {
+    if (size != SENSOR_BUS_RECORD_SIZE) return false;
+    uint32_t clock;
+    memcpy(&clock, value + 1, sizeof(clock));
+    if (value[0] == 0 || value[0] > 0x7F || clock < 10000 || clock > 1000000) return false;
+    settings.sensorAddress = value[0];
+    settings.sensorBusClock = clock;
+    return true;
+}
+
+// Порог в тех же пределах, что lightThreshold
+static bool decodeZone(uint8_t zone, const uint8_t* value, uint8_t size, Settings& settings) {
+    if (zone == 0 || zone >= MAX_ZONES || size != ZONE_RECORD_SIZE) return false;
+    const SettingField& threshold = SETTING_FIELDS[SETTING_LIGHT_THRESHOLD];
+    float v;
+    memcpy(&v, value, sizeof(v));
+    uint8_t mode = value[sizeof(float)];
+    if (!(v >= threshold.min && v <= threshold.max) || mode > ZONE_MODE_OFF) return false;
+    settings.zoneThreshold[zone] = v;
+    settings.zoneMode[zone] = mode;
+    return true;
+}
+
+// Значение проверяется так же, как в /api/settings: поврежденный или
+// записанный другой версией прошивки слот не подставит недопустимое значение
+static bool isValidValue(const SettingField& field, const uint8_t* value, size_t size) {
+    switch (field.type) {
+        case SETTING_TYPE_FLOAT: {
+            float v;
+            memcpy(&v, value, sizeof(v));
+            return v >= field.min && v <= field.max;
+        }
+        case SETTING_TYPE_UINT: {
+            uint32_t v;
+            memcpy(&v, value, sizeof(v));
+            return v >= field.min && v <= field.max;
+        }
+        case SETTING_TYPE_INT: {
+            int32_t v;
+            memcpy(&v, value, sizeof(v));
+            return v >= field.min && v <= field.max;
+        }
+        case SETTING_TYPE_BOOL:
+            return value[0] <= 1;
+        case SETTING_TYPE_SCHEDULE:
+            return memchr(value, '\0', size) && isValidSchedule((const char*)value);
+    }
+    return false;
+}
+
+// Строка расписания может быть короче поля: прежние прошивки хранили char[12]
+static bool isValidSize(SettingType type, size_t size) {
+    if (type == SETTING_TYPE_SCHEDULE) return size > 0 && size <= getSettingSize(type);
+    return size == getSettingSize(type);
+}
+
+static uint8_t decode(const uint8_t* payload, size_t length, Settings& settings) {
+    uint8_t loaded = 0;
+    size_t n = 0;
+    while (n + 2 <= length) {
+        uint8_t id = payload[n];
+        uint8_t size = payload[n + 1];
+        n += 2;
+        if (n + size > length) break;
+        if (id & ZONE_RECORD) {
+            if (decodeZone(id & ~ZONE_RECORD, payload + n, size, settings)) loaded++;
+        } else if (id == SENSOR_BUS_RECORD) {
+            if (decodeSensorBus(payload + n, size, settings)) loaded++;
+        } else if (id < SETTING_COUNT && isValidSize(SETTING_FIELDS[id].type, size) &&
+            isValidValue(SETTING_FIELDS[id], payload + n, size)) {
+            uint8_t* target = reinterpret_cast<uint8_t*>(&settings) + SETTING_FIELDS[id].offset;
+            memset(target, 0, getSettingSize(SETTING_FIELDS[id].type));
+            memcpy(target, payload + n, size);
+            loaded++;
+        }
+        n += size;
+    }
+    return loaded;
+}
+
+// Только заголовок: поля читает readPayload() у выбранного слота
+static bool readHeader(uint8_t slot, SlotHeader& header) {
+    File file = LittleFS.open(SLOT_PATHS[slot], "r");
+    if (!file) return false;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == SLOT_MAGIC && header.version == FORMAT_VERSION &&
+                 header.length <= MAX_PAYLOAD;
+    file.close();
+    return valid;
+}
+
+static bool readPayload(uint8_t slot, const SlotHeader& header, uint8_t* payload) {
+    File file = LittleFS.open(SLOT_PATHS[slot], "r");
+    if (!file) return false;
+    bool valid = file.seek(sizeof(SlotHeader)) &&
+                 file.read(payload, header.length) == header.length &&
+                 slotCrc(payload, header.length, header.sequence) == header.crc;
+    file.close();
+    return valid;
+}
+
+// Вызывается до DebugLogger::begin(): размеры логов берутся из настроек
+bool ConfigStore::load(Settings& settings) {
+    if (!LittleFS.begin(true)) return false;
+
+    SlotHeader headers[2];
+    bool valid[2];
+    for (uint8_t slot = 0; slot < 2; slot++) valid[slot] = readHeader(slot, headers[slot]);
+
+    // Сначала более новый слот; номер записи сравнивается разностью, чтобы
+    // пережить переполнение. Не сошлась CRC - остается другой
+    uint8_t order[2] = {0, 1};
+    if (valid[0] && valid[1] && (int32_t)(headers[1].sequence - headers[0].sequence) > 0) {
+        order[0] = 1;
+        order[1] = 0;
+    }
+    uint8_t payload[MAX_PAYLOAD];
+    int8_t best = -1;
+    for (uint8_t i = 0; i < 2 && best < 0; i++) {
+        uint8_t slot = order[i];
+        if (valid[slot] && readPayload(slot, headers[slot], payload)) best = slot;
+    }
+    if (best < 0) return false;
+
+    uint8_t loaded = decode(payload, headers[best].length, settings);
+    activeSlot = best;
+    sequence = headers[best].sequence;
+    committedCrc = headers[best].crc;
+    Serial.println("⚙️ Настройки из слота " + String(best ? "B" : "A") + " (запись " + String(sequence) +
+                   ", полей " + String(loaded) + ")");
+    return true;
+}
+
+void ConfigStore::markDirty() {
+    uint32_t now = millis();
+    if (!__atomic_exchange_n(&dirty, true, __ATOMIC_ACQ_REL)) __atomic_store_n(&dirtySince, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&lastChange, now, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&statRequests, 1, __ATOMIC_RELAXED);
+}
+
+bool ConfigStore::commit(bool force) {
+    if (!__atomic_load_n(&dirty, __ATOMIC_ACQUIRE)) return false;
+    uint32_t now = millis();
+    if (!force && now - __atomic_load_n(&lastChange, __ATOMIC_RELAXED) < CONFIG_COMMIT_DELAY &&
+        now - __atomic_load_n(&dirtySince, __ATOMIC_RELAXED) < CONFIG_COMMIT_MAX_DELAY) {
+        return false;
+    }
+    // Пометка снимается до кодирования: изменение во время записи поставит ее снова
+    uint32_t since = __atomic_load_n(&dirtySince, __ATOMIC_RELAXED);
+    __atomic_store_n(&dirty, false, __ATOMIC_RELEASE);
+
+    uint8_t payload[MAX_PAYLOAD];
+    SlotHeader header;
+    header.magic = SLOT_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.length = encode(config, payload);
+    if (header.length == 0) {
+        __atomic_fetch_add(&statErrors, 1, __ATOMIC_RELAXED);
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "❌ Настройки длиннее %u байт, запись невозможна", (unsigned)MAX_PAYLOAD);
+        return false;
+    }
+    header.sequence = sequence + 1;
+    header.crc = slotCrc(payload, header.length, header.sequence);
+
+    // Изменения взаимно погасились (порог туда и обратно) - флеш не трогаем
+    if (activeSlot >= 0 && slotCrc(payload, header.length, sequence) == committedCrc) {
+        __atomic_fetch_add(&statSkipped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    uint8_t slot = activeSlot == 0 ? 1 : 0;
+    File file = LittleFS.open(SLOT_PATHS[slot], "w");
+    bool written = file && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                   file.write(payload, header.length) == header.length;
+    if (file) file.close();
+    if (!written) {
+        __atomic_fetch_add(&statErrors, 1, __ATOMIC_RELAXED);
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "❌ Ошибка записи настроек в %s", SLOT_PATHS[slot]);
+        // Изменения не записаны: следующий опрос повторит попытку, срок - от первого изменения
+        __atomic_store_n(&dirtySince, since, __ATOMIC_RELAXED);
+        __atomic_store_n(&dirty, true, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    activeSlot = slot;
+    sequence = header.sequence;
+    committedCrc = header.crc;
+    __atomic_fetch_add(&statWrites, 1, __ATOMIC_RELAXED);
+    DEBUG_LOGF(LOG_MODULE_MAIN, "💾 Настройки записаны в слот %s (запись %lu)",
+               slot ? "B" : "A", (unsigned long)sequence);
+    return true;
+}
+
+ConfigStoreStats ConfigStore::getStats() {
+    ConfigStoreStats stats;
+    stats.requests = __atomic_load_n(&statRequests, __ATOMIC_RELAXED);
+    stats.writes = __atomic_load_n(&statWrites, __ATOMIC_RELAXED);
+    stats.skipped = __atomic_load_n(&statSkipped, __ATOMIC_RELAXED);
+    stats.errors = __atomic_load_n(&statErrors, __ATOMIC_RELAXED);
+    stats.sequence = __atomic_load_n(&sequence, __ATOMIC_RELAXED);
+    stats.dirty = __atomic_load_n(&dirty, __ATOMIC_RELAXED);
+    return stats;
+}
@@ -0,0 +1,34 @@
+// ConfigStore.h
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+struct ConfigStoreStats {
+    uint32_t requests;    // вызовы saveConfig()
+    uint32_t writes;      // записи слота на флеш
+    uint32_t skipped;     // отложенная запись не понадобилась: содержимое не изменилось
+    uint32_t errors;
+    uint32_t sequence;    // номер последней записи
+    bool dirty;
+};
+
+// Хранение Settings на LittleFS в двух слотах A/B.
+// Слот: заголовок с версией формата, номером записи и CRC32, затем поля
+// в виде [SettingId][размер][значение]. Запись идет в слот, который не является
+// текущим, поэтому сбой питания посреди записи оставляет предыдущую версию.
+// При загрузке берется действительный слот с большим номером; незнакомые поля
+// пропускаются, отсутствующие остаются по умолчанию.
+// saveConfig() только помечает настройки измененными: commit() пишет их, когда
+// изменения затихли на CONFIG_COMMIT_DELAY, но не позже CONFIG_COMMIT_MAX_DELAY
+// от первого изменения. Серия запросов API дает одну запись
+class ConfigStore {
+public:
+    static bool load(Settings& settings);   // false - сохраненных настроек нет
+    static void markDirty();                // любая задача
+    static bool commit(bool force = false); // основной цикл; true - слот записан
+    static ConfigStoreStats getStats();
+};
+
+#endif
@@ -0,0 +1,80 @@
+// ControlEngine.cpp
+#include "ControlEngine.h"
+
+ControlEngine controlEngine;
+
+void ControlEngine::addSample(uint8_t zone, float lux, const Settings& settings, uint32_t now) {
+    uint32_t dt = now - lastSampleAt[zone];
+    if (count[zone] > 0 && dt > settings.sampleMaxAge) count[zone] = 0;
+    lastSampleAt[zone] = now;
+
+    if (count[zone] == 0) next[zone] = 0;
+    window[zone][next[zone]] = lux;
+    next[zone] = (next[zone] + 1) % MEDIAN_WINDOW;
+    if (count[zone] < MEDIAN_WINDOW) count[zone]++;
+
+    // Окно из пяти значений: сортировка вставками копии дешевле любой структуры
+    uint8_t n = count[zone];
+    float sorted[MEDIAN_WINDOW];
+    for (uint8_t i = 0; i < n; i++) {
+        float v = window[zone][i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    float m = n & 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    // filterAlpha задан для опроса раз в SENSOR_SAMPLE_INTERVAL; период следует за
+    // диапазоном датчика, и постоянная времени EMA не должна от него зависеть
+    float alpha = settings.filterAlpha;
+    if (dt != SENSOR_SAMPLE_INTERVAL && alpha < 1.0f) {
+        alpha = 1.0f - powf(1.0f - alpha, (float)dt / SENSOR_SAMPLE_INTERVAL);
+    }
+    filtered[zone] = n == 1 ? m : filtered[zone] + alpha * (m - filtered[zone]);
+    raw[zone] = lux;
+    median[zone] = m;
+    samples[zone]++;
+}
+
+bool ControlEngine::decide(uint8_t zone, bool relayState, uint32_t stateAgeMs, float threshold, float lampLux,
+                           const Settings& settings) {
+    float half = settings.hysteresis / 2;
+    bool wanted = relayState;
+    // Выключаемся, когда света хватит и без лампы
+    if (relayState && filtered[zone] - lampLux > threshold + half) wanted = false;
+    else if (!relayState && filtered[zone] < threshold - half) wanted = true;
+    return applyDwell(zone, relayState, wanted, stateAgeMs, settings);
+}
+
+float ControlEngine::getLampLux(const Settings& settings) {
+    return settings.luxToPpfd > 0 ? settings.lampPpfd / settings.luxToPpfd : 0;
+}
+
+bool ControlEngine::applyDwell(uint8_t zone, bool relayState, bool wanted, uint32_t stateAgeMs, const Settings& settings) {
+    if (wanted == relayState) {
+        holding[zone] = false;
+        return relayState;
+    }
+    uint32_t minTime = relayState ? settings.minOnTime : settings.minOffTime;
+    if (stateAgeMs < minTime) {
+        if (!holding[zone]) dwellHolds[zone]++;
+        holding[zone] = true;
+        return relayState;
+    }
+    holding[zone] = false;
+    return wanted;
+}
+
+ControlStats ControlEngine::getStats(uint8_t zone) const {
+    ControlStats stats;
+    stats.raw = raw[zone];
+    stats.median = median[zone];
+    stats.filtered = filtered[zone];
+    stats.samples = samples[zone];
+    stats.switches = switches[zone];
+    stats.dwellHolds = dwellHolds[zone];
+    return stats;
+}
@@ -0,0 +1,63 @@
+// ControlEngine.h
+#ifndef CONTROL_ENGINE_H
+#define CONTROL_ENGINE_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+struct ControlStats {
+    float raw = -1.0;            // последнее измерение
+    float median = -1.0;         // медиана окна MEDIAN_WINDOW
+    float filtered = -1.0;       // EMA медианы - по нему принимается решение
+    uint32_t samples = 0;
+    uint32_t switches = 0;       // переключения реле авторежимом
+    uint32_t dwellHolds = 0;     // переключения, отложенные минимальным временем вкл/выкл
+};
+
+// Решение авторежима по отфильтрованной освещенности, для каждой зоны отдельно.
+// Каждое измерение проходит скользящую медиану (выбросы, блики) и EMA (шум, облака),
+// работа на измерение постоянная. Реле включается ниже threshold - hysteresis/2,
+// выключается выше threshold + hysteresis/2 и держит состояние не меньше
+// minOnTime/minOffTime. Датчик видит и саму лампу: пока она горит, для выключения
+// из показания вычитается ее вклад, иначе любой свет в полосе шириной с лампу
+// включает и выключает реле с периодом minOnTime + minOffTime. Ручной режим фильтр не использует.
+// Состояние зон лежит массивами по полям: цикл по зонам идет по соседним словам
+class ControlEngine {
+public:
+    static const uint8_t MEDIAN_WINDOW = 5;
+
+    // Каждое новое измерение датчика; разрыв дольше sampleMaxAge начинает фильтр заново
+    void addSample(uint8_t zone, float lux, const Settings& settings, uint32_t now);
+    bool hasSignal(uint8_t zone) const { return count[zone] > 0; }
+    // Нужное состояние реле; stateAgeMs - сколько реле уже в текущем состоянии,
+    // lampLux - прибавка лампы зоны к показанию датчика сейчас (0, если выключена)
+    bool decide(uint8_t zone, bool relayState, uint32_t stateAgeMs, float threshold, float lampLux,
+                const Settings& settings);
+    // Вклад лампы на полной яркости у датчика: lampPpfd в lux
+    static float getLampLux(const Settings& settings);
+    // Минимальное время вкл/выкл для решения другого режима (DLI)
+    bool applyDwell(uint8_t zone, bool relayState, bool wanted, uint32_t stateAgeMs, const Settings& settings);
+    void recordSwitch(uint8_t zone) { switches[zone]++; }
+    // Последнее решение отложено минимальным временем вкл/выкл
+    bool isHolding(uint8_t zone) const { return holding[zone]; }
+    float getFiltered(uint8_t zone) const { return filtered[zone]; }
+    ControlStats getStats(uint8_t zone) const;
+
+private:
+    float window[MAX_ZONES][MEDIAN_WINDOW];
+    uint8_t next[MAX_ZONES] = {};
+    uint8_t count[MAX_ZONES] = {};
+    uint32_t lastSampleAt[MAX_ZONES] = {};
+    bool holding[MAX_ZONES] = {};      // текущее ожидание уже посчитано в dwellHolds
+
+    float raw[MAX_ZONES] = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0};
+    float median[MAX_ZONES] = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0};
+    float filtered[MAX_ZONES] = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0};
+    uint32_t samples[MAX_ZONES] = {};
+    uint32_t switches[MAX_ZONES] = {};
+    uint32_t dwellHolds[MAX_ZONES] = {};
+};
+
+extern ControlEngine controlEngine;
+
+#endif
@@ -0,0 +1,126 @@
+// Dashboard.h - сгенерировано web/gen_dashboard.py из web/index.html, не редактировать
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <Arduino.h>
+
+// index.html: 4573 байт, gzip: 1808 байт
+const char DASHBOARD_ETAG[] = "\"9d8b5d38b9b2d5cd\"";
+const size_t DASHBOARD_GZ_SIZE = 1808;
+const uint8_t DASHBOARD_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x58, 0xdb, 0x6e, 0xdb, 0x46,
+    0x10, 0x7d, 0xd7, 0x57, 0x4c, 0x14, 0x20, 0xa4, 0x50, 0x89, 0x92, 0xed, 0xb8, 0x40, 0x75, 0x2b,
+    0x5c, 0x27, 0x46, 0x53, 0x38, 0x71, 0x50, 0x39, 0x0f, 0x7d, 0xa4, 0xc8, 0x95, 0xc4, 0x94, 0xe2,
+    0x12, 0xcb, 0xa5, 0x6d, 0xd5, 0x10, 0x90, 0x0b, 0x82, 0xf6, 0xa1, 0x68, 0x3e, 0xa1, 0xe8, 0x1f,
+    0x18, 0x46, 0x8c, 0xa6, 0x4d, 0xea, 0xfe, 0x02, 0xf5, 0x47, 0x9d, 0xd9, 0x25, 0xc5, 0x8b, 0x1d,
+    0x23, 0x69, 0x81, 0xc2, 0x50, 0x24, 0xee, 0xce, 0x9e, 0xb9, 0xec, 0xd9, 0x33, 0xcb, 0xf4, 0x6f,
+    0xdd, 0x3b, 0xd8, 0x3d, 0xfc, 0xee, 0xf1, 0x7d, 0x98, 0xc9, 0xb9, 0x3f, 0xac, 0xf5, 0xb3, 0x2f,
+    0x66, 0xbb, 0xf8, 0x25, 0x3d, 0xe9, 0xb3, 0xe1, 0xe3, 0xd9, 0x42, 0xf2, 0x5d, 0x1e, 0x48, 0xc1,
+    0x7d, 0x9f, 0x89, 0x7e, 0x5b, 0x0f, 0xd7, 0xfa, 0x73, 0x26, 0x6d, 0x08, 0xec, 0x39, 0x1b, 0xd4,
+    0x8f, 0x3c, 0x76, 0x1c, 0x72, 0x21, 0xeb, 0xe0, 0xa0, 0x21, 0x0b, 0xe4, 0xa0, 0x7e, 0xec, 0xb9,
+    0x72, 0x36, 0x70, 0xd9, 0x91, 0xe7, 0xb0, 0x96, 0x7a, 0x68, 0x82, 0x17, 0x78, 0xd2, 0xb3, 0xfd,
+    0x56, 0xe4, 0xd8, 0x3e, 0x1b, 0x6c, 0xd4, 0x11, 0x24, 0x92, 0x0b, 0x02, 0x1b, 0x73, 0x77, 0x01,
+    0xa7, 0x30, 0xc1, 0xd5, 0xad, 0x89, 0x3d, 0xf7, 0xfc, 0x45, 0x17, 0x76, 0x04, 0xda, 0xf6, 0x60,
+    0x6e, 0x8b, 0xa9, 0x17, 0x74, 0x61, 0xb3, 0x13, 0x9e, 0xf4, 0x60, 0x6c, 0x3b, 0xdf, 0x4f, 0x05,
+    0x8f, 0x03, 0xb7, 0x0b, 0xb7, 0x27, 0x1d, 0xfa, 0xeb, 0xc1, 0xb2, 0x66, 0x39, 0xb6, 0x70, 0x11,
+    0xa0, 0x38, 0x7d, 0x3c, 0xf3, 0x24, 0xeb, 0x41, 0x68, 0xbb, 0xae, 0x17, 0x4c, 0x33, 0x80, 0x0c,
+    0x6e, 0x43, 0xc3, 0x71, 0xe1, 0x32, 0xd1, 0x12, 0xb6, 0xeb, 0xc5, 0x51, 0x3e, 0x78, 0xd2, 0x8a,
+    0x66, 0xb6, 0xcb, 0x8f, 0xbb, 0xd0, 0x81, 0xcd, 0xf0, 0x04, 0xb6, 0xf1, 0x23, 0xa6, 0x63, 0xdb,
+    0xec, 0x34, 0xd5, 0x9f, 0xb5, 0xd1, 0x50, 0x5e, 0x23, 0x69, 0xcb, 0x38, 0xca, 0x02, 0x8f, 0xbc,
+    0x1f, 0x18, 0x62, 0x58, 0x9b, 0x6c, 0x5e, 0xf6, 0x03, 0x3a, 0xc6, 0xb1, 0x0c, 0xd0, 0x74, 0x1d,
+    0x8f, 0x9a, 0x29, 0x07, 0xb5, 0x9d, 0xc7, 0xd4, 0x85, 0x80, 0x07, 0xec, 0x4a, 0x84, 0xca, 0xc2,
+    0x89, 0x45, 0xc4, 0xd1, 0x22, 0xe4, 0x1e, 0x56, 0x5b, 0x64, 0xe0, 0x2d, 0x1e, 0x54, 0x4a, 0x70,
+    0xfb, 0xee, 0xee, 0xce, 0xde, 0x36, 0x7a, 0x77, 0xb8, 0x4f, 0x0b, 0xd2, 0x92, 0x64, 0xe6, 0x93,
+    0x49, 0xd5, 0x7e, 0x72, 0xf7, 0xee, 0xd6, 0xd6, 0xe7, 0x1f, 0xb0, 0xb7, 0x63, 0xc9, 0xab, 0x0b,
+    0x36, 0x37, 0xbe, 0xf8, 0x7c, 0x6f, 0xeb, 0x9a, 0x05, 0x3e, 0x9f, 0x56, 0x6d, 0x3b, 0x9d, 0x3c,
+    0x92, 0xdb, 0x6a, 0xe3, 0x4a, 0xb5, 0xb8, 0x3e, 0xd7, 0x12, 0x25, 0xe6, 0x3c, 0xe0, 0x51, 0x68,
+    0x3b, 0xe8, 0x62, 0xc6, 0xbc, 0xe9, 0x4c, 0xd2, 0xae, 0xaa, 0xa5, 0xfc, 0x88, 0x89, 0x89, 0xcf,
+    0x8f, 0x5b, 0x68, 0x15, 0x39, 0x44, 0x55, 0x8a, 0xa2, 0xdf, 0x4e, 0xf9, 0xd5, 0x6f, 0xa7, 0x9c,
+    0x26, 0xa2, 0x11, 0xc3, 0x37, 0xae, 0xf2, 0x1a, 0xc7, 0x6a, 0xb5, 0xbe, 0xeb, 0x1d, 0x81, 0xe3,
+    0xdb, 0x51, 0x34, 0xa8, 0x13, 0xa7, 0x88, 0xa3, 0xb3, 0xcd, 0xe1, 0x68, 0x11, 0x49, 0x36, 0x87,
+    0x91, 0xda, 0x6f, 0x34, 0xdd, 0x1c, 0x6a, 0x4b, 0xcf, 0x1d, 0xd4, 0x35, 0x09, 0xea, 0xc3, 0x7d,
+    0x6e, 0x53, 0x32, 0x96, 0x65, 0xf5, 0xdb, 0x38, 0x47, 0x4e, 0xd5, 0xd7, 0x87, 0x30, 0x53, 0xdf,
+    0x29, 0xda, 0x38, 0x96, 0x12, 0xf7, 0x2f, 0x35, 0x23, 0xaa, 0xe8, 0x1d, 0xad, 0x03, 0x0f, 0x1c,
+    0xdf, 0x73, 0xbe, 0xc7, 0xb5, 0x7a, 0x81, 0x69, 0x08, 0xe6, 0xdb, 0x0b, 0xa3, 0x09, 0x52, 0xc4,
+    0xac, 0x51, 0x1f, 0x1e, 0x3c, 0x82, 0x6f, 0x69, 0xa4, 0xdf, 0xd6, 0x20, 0x1f, 0x46, 0x9b, 0x4c,
+    0x6e, 0x82, 0x9b, 0xd8, 0x7e, 0xa4, 0xf0, 0xf6, 0xf6, 0x3e, 0x12, 0x90, 0x18, 0x71, 0x1d, 0xe2,
+    0x9c, 0xbb, 0x2c, 0x8f, 0x6f, 0xe7, 0xc9, 0xe1, 0x01, 0x3c, 0xc4, 0xa1, 0x9b, 0xf0, 0x6e, 0x80,
+    0xc9, 0xe2, 0x7a, 0xb8, 0xf3, 0xe8, 0xc9, 0xce, 0x7e, 0x15, 0xe9, 0xe6, 0x22, 0x8f, 0x98, 0x94,
+    0xb8, 0x29, 0xd9, 0x9e, 0xf9, 0xf6, 0x98, 0xf9, 0xc3, 0x7d, 0xa2, 0x0e, 0xc8, 0x99, 0x60, 0xd1,
+    0x8c, 0xfb, 0x2e, 0x98, 0x7e, 0x7c, 0xd2, 0xe8, 0xf6, 0xdb, 0x7a, 0xb6, 0xd6, 0xf7, 0x82, 0x30,
+    0xc6, 0xf9, 0x45, 0x88, 0xd2, 0x16, 0xc4, 0xf3, 0x31, 0x13, 0x75, 0xb5, 0xd3, 0xeb, 0x15, 0x75,
+    0x38, 0xb2, 0xfd, 0x18, 0x67, 0xb7, 0x3b, 0x9d, 0x7a, 0x9e, 0xcd, 0x3a, 0x83, 0x38, 0x74, 0x6d,
+    0xc9, 0x32, 0xdf, 0x26, 0xc6, 0x3e, 0xb2, 0x8f, 0x3e, 0x3e, 0xe8, 0x7d, 0x3e, 0x2d, 0x92, 0x2c,
+    0x35, 0xc0, 0x13, 0xa5, 0xc3, 0xc0, 0x1f, 0x39, 0xdd, 0x80, 0x9e, 0x0a, 0x9c, 0xab, 0x86, 0x22,
+    0xd8, 0x84, 0x82, 0x26, 0x48, 0x8a, 0xe3, 0x5b, 0xfd, 0x08, 0xda, 0xc5, 0x95, 0x78, 0xf0, 0xe8,
+    0x78, 0xa1, 0x1c, 0xd6, 0xda, 0x6d, 0x48, 0x7e, 0x4b, 0x2e, 0x57, 0xcf, 0x57, 0x2f, 0xf0, 0xdf,
+    0xd7, 0xc9, 0x5f, 0xc9, 0xdb, 0xe4, 0x02, 0x92, 0xbf, 0x57, 0xcf, 0x92, 0xb7, 0xab, 0x57, 0xc9,
+    0x65, 0xf2, 0x06, 0xbf, 0x5f, 0xe0, 0x00, 0xce, 0xa2, 0x45, 0xf2, 0x27, 0x7e, 0xde, 0x43, 0xdb,
+    0x0e, 0xbd, 0x36, 0x3b, 0x42, 0xfd, 0x8f, 0xc0, 0x54, 0xe3, 0xef, 0x56, 0x3f, 0xd3, 0x1c, 0xe0,
+    0xf2, 0xdf, 0x93, 0xf7, 0xc9, 0x85, 0x02, 0x3a, 0x5f, 0xfd, 0x44, 0x70, 0x08, 0xfe, 0x5a, 0x21,
+    0xa0, 0xd5, 0xeb, 0x46, 0x4f, 0xf9, 0xbc, 0x54, 0x2e, 0xd0, 0xaf, 0xc6, 0x4a, 0xf5, 0x15, 0x87,
+    0xce, 0x92, 0xdf, 0x21, 0x39, 0x87, 0x2d, 0xc0, 0xa9, 0x16, 0x20, 0xd8, 0x19, 0xae, 0x3c, 0x5b,
+    0x3d, 0x47, 0xc0, 0xcb, 0xe4, 0x0f, 0x8a, 0xec, 0xe5, 0xea, 0xc5, 0xea, 0xe7, 0xa6, 0x06, 0xfc,
+    0x33, 0x39, 0x2b, 0xc4, 0x06, 0x68, 0x74, 0x81, 0x11, 0xab, 0x74, 0x56, 0x2f, 0x71, 0x02, 0xe3,
+    0xa8, 0xf9, 0x4c, 0x02, 0xe1, 0x33, 0x18, 0xc0, 0xe9, 0xb2, 0xa7, 0x9e, 0x43, 0x94, 0x82, 0x43,
+    0x6f, 0xce, 0x04, 0x8e, 0x05, 0x31, 0x6a, 0x88, 0x1a, 0xc5, 0xf2, 0xcb, 0xfb, 0x94, 0x15, 0x8e,
+    0x76, 0x7a, 0xb5, 0xda, 0x24, 0x0e, 0x1c, 0xe9, 0x61, 0x91, 0x05, 0x0b, 0x50, 0xaf, 0xcc, 0x06,
+    0x9c, 0xd6, 0x00, 0xbc, 0x09, 0x98, 0x0a, 0xcf, 0x42, 0x36, 0xc1, 0x60, 0x30, 0x00, 0x54, 0x3d,
+    0x36, 0xf1, 0x02, 0xe6, 0x36, 0xd0, 0x52, 0xc6, 0x22, 0xe8, 0xa1, 0x99, 0xcb, 0x9d, 0x78, 0x8e,
+    0x58, 0xd6, 0x94, 0xc9, 0xfb, 0x3e, 0xa3, 0x9f, 0x5f, 0x2d, 0x1e, 0xb8, 0xa6, 0xa1, 0x73, 0x35,
+    0x1a, 0x96, 0x17, 0x04, 0x4c, 0x7c, 0x7d, 0xf8, 0x70, 0x1f, 0x06, 0x68, 0x0f, 0x60, 0x14, 0x49,
+    0x90, 0x89, 0x8d, 0x3a, 0x9f, 0x5d, 0xe8, 0x8f, 0x87, 0x06, 0x7c, 0x96, 0x39, 0x56, 0x07, 0x79,
+    0xa4, 0x72, 0xfa, 0x12, 0x8c, 0x83, 0x47, 0x06, 0x74, 0xf1, 0x6b, 0x6f, 0xcf, 0x68, 0xa0, 0x8d,
+    0x81, 0xdb, 0x3d, 0xd4, 0x1b, 0x8d, 0x4b, 0x3e, 0x8c, 0xbc, 0xaf, 0x75, 0x35, 0x45, 0x5e, 0x67,
+    0x64, 0x49, 0xbe, 0xe7, 0x9d, 0x30, 0xd7, 0xdc, 0x54, 0x60, 0x80, 0x43, 0x1f, 0x09, 0x48, 0xe7,
+    0xb5, 0x1a, 0x29, 0x09, 0x07, 0x8d, 0x53, 0x9c, 0x24, 0x0f, 0x2a, 0x52, 0x7d, 0xbe, 0x3f, 0x29,
+    0xd8, 0xc3, 0xec, 0x44, 0x56, 0x02, 0xce, 0xcf, 0xf6, 0xa7, 0xc5, 0xfa, 0x24, 0x94, 0xb8, 0xfd,
+    0x15, 0xb0, 0x58, 0x0d, 0x2a, 0xa4, 0x88, 0x39, 0x05, 0xa4, 0x5e, 0x6d, 0x59, 0x60, 0x83, 0x1d,
+    0x86, 0xfe, 0x42, 0x77, 0x08, 0x13, 0x8f, 0xbf, 0x9d, 0xd3, 0x82, 0x9e, 0x0a, 0x21, 0xdd, 0x2a,
+    0x72, 0x03, 0xee, 0xdc, 0x81, 0x6b, 0xe6, 0x2b, 0x69, 0x68, 0xac, 0x1b, 0xd8, 0xb3, 0xb6, 0x44,
+    0x02, 0x29, 0x6d, 0x42, 0xae, 0x96, 0x61, 0x89, 0x7c, 0x4b, 0xfc, 0x1c, 0x8c, 0x9f, 0x32, 0x47,
+    0x5a, 0x98, 0xb6, 0x37, 0x0d, 0xf4, 0x76, 0x34, 0x95, 0x69, 0x83, 0x2c, 0x32, 0x4a, 0x97, 0x53,
+    0x4b, 0xf5, 0x4c, 0xe7, 0xa6, 0x63, 0x99, 0x30, 0xe9, 0xcc, 0x4c, 0xa3, 0x70, 0x4c, 0x8d, 0x86,
+    0x0a, 0x11, 0x3d, 0xb2, 0xc0, 0x44, 0xa7, 0x21, 0x0f, 0x22, 0x0c, 0x63, 0x08, 0xd9, 0x6f, 0xeb,
+    0x69, 0xc4, 0x03, 0xb3, 0x51, 0x34, 0x2b, 0xd4, 0xac, 0xe2, 0x12, 0x31, 0x85, 0x7c, 0x8c, 0xe7,
+    0x11, 0x35, 0xae, 0x70, 0xc2, 0x6e, 0xad, 0x8f, 0x68, 0xa3, 0x74, 0x5a, 0x23, 0x26, 0x1f, 0xd0,
+    0x5d, 0x08, 0x73, 0x37, 0x8b, 0xd1, 0x36, 0x61, 0x0b, 0xaf, 0x1d, 0x57, 0xb0, 0x79, 0x58, 0x86,
+    0x76, 0x7c, 0x66, 0x8b, 0x35, 0x40, 0xee, 0x83, 0x4a, 0x72, 0x55, 0x14, 0x8a, 0x58, 0xd8, 0xac,
+    0x02, 0xac, 0xa7, 0xd2, 0x87, 0xa8, 0x18, 0xe8, 0xb1, 0x17, 0xe0, 0x0d, 0xd2, 0x52, 0x13, 0x23,
+    0x1e, 0x0b, 0x87, 0x65, 0x32, 0x50, 0xc9, 0x8d, 0x7c, 0x20, 0x4a, 0x84, 0x72, 0xa4, 0xcc, 0xc8,
+    0x0d, 0x3b, 0x86, 0xc2, 0xc2, 0xb4, 0xcc, 0x5a, 0x59, 0x8d, 0xc2, 0x02, 0xc1, 0x1c, 0xe6, 0x1d,
+    0x21, 0x89, 0x06, 0x80, 0xae, 0xb1, 0xd4, 0xa7, 0x25, 0xb1, 0xba, 0x47, 0x1c, 0x0a, 0xf8, 0x31,
+    0xfa, 0x28, 0xe7, 0x8c, 0x77, 0x23, 0x02, 0xd1, 0xfe, 0x2c, 0xbc, 0x84, 0xa9, 0x15, 0xfb, 0x1e,
+    0x5e, 0x72, 0x50, 0x7b, 0xd6, 0x5a, 0xd4, 0x04, 0xa6, 0x41, 0x33, 0x3f, 0xb4, 0xb2, 0x48, 0xf3,
+    0x6f, 0x46, 0x07, 0x8f, 0xac, 0xd0, 0x16, 0x11, 0x33, 0x99, 0xa5, 0x38, 0x44, 0xd0, 0x8d, 0x1b,
+    0xb1, 0xf1, 0x22, 0x26, 0xe4, 0x98, 0xd9, 0xf2, 0x3f, 0xc1, 0x63, 0xb3, 0x28, 0x14, 0x88, 0xc4,
+    0xfe, 0x02, 0xbb, 0xc4, 0x85, 0x52, 0xff, 0x37, 0xa8, 0xff, 0xef, 0x56, 0xbf, 0xac, 0x7e, 0xc4,
+    0x26, 0x71, 0x81, 0x8a, 0x4f, 0x7d, 0x06, 0x3b, 0xc5, 0x19, 0x76, 0x28, 0xe4, 0xa5, 0x14, 0xa8,
+    0x9b, 0x9a, 0x14, 0x40, 0x4d, 0x01, 0xb0, 0x49, 0x5c, 0xac, 0x5e, 0xe9, 0x7e, 0xf1, 0x8c, 0x9a,
+    0xcb, 0xba, 0x09, 0xe5, 0x69, 0xe0, 0x55, 0x5c, 0x08, 0x2e, 0xf2, 0x3a, 0x2b, 0x0e, 0x5f, 0xdd,
+    0xc7, 0xb4, 0x0d, 0xe8, 0x45, 0x02, 0xaf, 0x9c, 0xa9, 0x1c, 0x53, 0x3b, 0x28, 0xc4, 0x6b, 0xed,
+    0xee, 0x1f, 0x8c, 0xee, 0xdf, 0x6b, 0x10, 0x6d, 0x89, 0x5a, 0x3c, 0x96, 0x66, 0x89, 0x48, 0x4d,
+    0xbc, 0x11, 0x6b, 0xde, 0x02, 0x6d, 0x15, 0x12, 0x8e, 0xba, 0xe3, 0xaf, 0x79, 0x47, 0x7b, 0xaf,
+    0xda, 0xe6, 0x8f, 0xba, 0x0b, 0xbf, 0xd1, 0x9d, 0x16, 0xdb, 0xea, 0x05, 0x3d, 0x9c, 0x63, 0x2f,
+    0x7c, 0x05, 0xeb, 0x3a, 0x63, 0x4a, 0x98, 0xfd, 0xa5, 0x6a, 0x81, 0x6f, 0x55, 0x2b, 0x4c, 0xbb,
+    0x39, 0x35, 0xd1, 0x73, 0x44, 0x78, 0x9e, 0xbc, 0x4b, 0x2e, 0xb1, 0x73, 0x9e, 0x17, 0xeb, 0x86,
+    0xc5, 0x2a, 0x14, 0xa2, 0x78, 0xbc, 0x32, 0xa6, 0x51, 0xa6, 0x39, 0xc3, 0xd0, 0x4b, 0x4e, 0xbd,
+    0x21, 0x6c, 0x6d, 0x53, 0xf8, 0xd5, 0x0a, 0xc1, 0xb2, 0x09, 0xdb, 0x3a, 0xaf, 0xd2, 0x09, 0x52,
+    0xd7, 0x3d, 0xba, 0x6f, 0x35, 0xf5, 0xc5, 0x4a, 0x1f, 0x23, 0xea, 0xbd, 0xea, 0xc5, 0x50, 0x37,
+    0x68, 0x5d, 0x5b, 0xb2, 0x52, 0xe5, 0x4c, 0xaf, 0xad, 0x0d, 0x7a, 0xcb, 0x48, 0x8d, 0x40, 0xe8,
+    0xae, 0xa8, 0x05, 0x70, 0xd9, 0x53, 0x7a, 0xc7, 0xf0, 0xf2, 0x58, 0x59, 0xa9, 0xee, 0x95, 0xa5,
+    0x85, 0x59, 0x3f, 0xaa, 0xac, 0x2d, 0x8a, 0x5c, 0x1a, 0x26, 0xb2, 0x56, 0x6f, 0x3e, 0xbe, 0xfe,
+    0xce, 0x38, 0xf6, 0x1d, 0xe3, 0xf1, 0xc1, 0xe8, 0xd0, 0x68, 0xaa, 0x31, 0x7a, 0xc9, 0x60, 0x02,
+    0x5f, 0x5d, 0x4e, 0x8d, 0x5d, 0xfd, 0x22, 0xdc, 0x3a, 0x44, 0xaf, 0x06, 0x5a, 0x11, 0xaf, 0x3d,
+    0xc7, 0xa6, 0x8c, 0xdb, 0xa4, 0x83, 0xc6, 0x52, 0x2f, 0xa1, 0x10, 0xba, 0xa0, 0x98, 0x1e, 0x49,
+    0x81, 0x65, 0xf2, 0x26, 0x0b, 0x93, 0x06, 0x49, 0x26, 0x97, 0x0d, 0x2d, 0x93, 0xba, 0xe4, 0x65,
+    0x15, 0xbe, 0x5e, 0xa2, 0xd7, 0x57, 0x4e, 0x2d, 0x6b, 0x4a, 0x25, 0xf2, 0xce, 0x32, 0xf8, 0x84,
+    0x06, 0xd2, 0xab, 0x8a, 0x7c, 0x0a, 0xfd, 0xbf, 0x14, 0xe0, 0x54, 0xe6, 0x8d, 0x5d, 0x09, 0xc0,
+    0x9e, 0xcf, 0x6d, 0x69, 0xe6, 0xfd, 0x70, 0xf9, 0x89, 0xe5, 0x29, 0x5d, 0x83, 0xaf, 0x34, 0x30,
+    0xba, 0x43, 0xff, 0x9b, 0xf6, 0x45, 0x9a, 0x94, 0xcb, 0xc1, 0x0d, 0xed, 0x59, 0x3b, 0xd0, 0x57,
+    0xbb, 0x43, 0x76, 0x22, 0xb3, 0xee, 0x4c, 0xe3, 0x5a, 0x37, 0x96, 0x3a, 0xe0, 0x72, 0x12, 0xbd,
+    0x5a, 0xa5, 0xbd, 0xf4, 0x6a, 0xa5, 0x44, 0x7a, 0xf4, 0x86, 0x9b, 0x5e, 0xd9, 0xf1, 0x5e, 0xa2,
+    0xdf, 0x6d, 0xdb, 0xfa, 0x7f, 0x71, 0xfe, 0x01, 0xa7, 0xe1, 0xc4, 0xa3, 0xdd, 0x11, 0x00, 0x00,
+};
+
+#endif
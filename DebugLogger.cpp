@@ -1,64 +1,313 @@
 // DebugLogger.cpp
 #include "DebugLogger.h"
 #include "Config.h"
+#include "EventTrace.h"
+#include "Metrics.h"
+#include "SensorStore.h"
 #include <LittleFS.h>
+#include <atomic>
+#include <stdarg.h>
 
 uint32_t DebugLogger::maxLogSize = 1024 * 50; // 50KB по умолчанию
+DebugLogger::SegmentState DebugLogger::segments[SYSTEM_LOG + 1];
+uint8_t DebugLogger::moduleLevels[LOG_MODULE_COUNT] = {
+    LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG
+};
+
+// === Очередь логов: ограниченное MPSC-кольцо без блокировок (схема Вьюкова) ===
+// Слот свободен для записи позиции pos, когда sequence == pos,
+// и готов к чтению, когда sequence == pos + 1
+struct LogSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t timestamp;
+    uint8_t type;
+    uint16_t length;
+    char text[DebugLogger::ENTRY_TEXT_SIZE];
+};
+
+struct LogBatchEntry {
+    uint32_t timestamp;
+    uint8_t type;
+    uint16_t length;
+    char text[DebugLogger::ENTRY_TEXT_SIZE];
+};
+
+static const uint8_t LOG_BATCH_SIZE = 16;
+
+static LogSlot logRing[DebugLogger::QUEUE_SIZE];
+static std::atomic<uint32_t> enqueuePos(0);
+static std::atomic<uint32_t> dequeuePos(0);   // пишет только фоновая задача
+static LogBatchEntry writeBatch[LOG_BATCH_SIZE];
+static TaskHandle_t writerHandle = nullptr;
+
+static std::atomic<uint32_t> statEnqueued(0);
+static std::atomic<uint32_t> statWritten(0);
+static std::atomic<uint32_t> statDropped(0);
+static std::atomic<uint32_t> statTruncated(0);
+static std::atomic<uint32_t> statBatches(0);
+static std::atomic<uint16_t> statHighWater(0);
+
+// Очистку выполняет фоновая задача: она единственная пишет сегменты
+static std::atomic<uint8_t> pendingClear(0);
+
+// Кольцо размечается в begin(); до этого записи отбрасываются
+static std::atomic<bool> logRingReady(false);
+// Фоновая задача уже разбужена заполнением очереди и еще не начала выборку
+static std::atomic<bool> drainRequested(false);
 
 void DebugLogger::begin() {
+    if (!logRingReady.load(std::memory_order_acquire)) {
+        for (uint16_t i = 0; i < QUEUE_SIZE; i++) {
+            logRing[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        logRingReady.store(true, std::memory_order_release);
+    }
+    
     if (!LittleFS.begin(true)) {
         Serial.println("❌ Ошибка инициализации LittleFS");
-        return;
+    } else {
+        // Создаем папку для логов если нужно
+        LittleFS.mkdir("/logs");
+        loadSegments(DEBUG_LOG);
+        loadSegments(EVENT_LOG);
+        loadSegments(SYSTEM_LOG);
+        
+        if (!SensorStore::begin(config.sensorStoreSize)) {
+            Serial.println("❌ Ошибка инициализации хранилища показаний");
+        }
     }
     
-    // Создаем папку для логов если нужно
-    LittleFS.mkdir("/logs");
+    // Фоновая запись на ядре 0 с низким приоритетом: loop() работает на ядре 1
+    if (writerHandle == nullptr) {
+        xTaskCreatePinnedToCore(writerTask, "logWriter", 4096, nullptr, 1, &writerHandle, 0);
+    }
     
-    SYSTEM_LOG("🚀 Система логирования инициализирована");
-    DEBUG_LOG("📁 Файловая система готова");
+    SYSTEM_LOGF(LOG_MODULE_LOGGER, "🚀 Система логирования инициализирована");
+    DEBUG_LOGF(LOG_MODULE_LOGGER, "📁 Файловая система готова");
 }
 
+// Только копирует сообщение в очередь; Serial и файл - в фоновой задаче
 void DebugLogger::log(const String& message, LogType type) {
-    unsigned long seconds = millis() / 1000;
-    unsigned long minutes = seconds / 60;
-    unsigned long hours = minutes / 60;
-    String timestamp = String(hours) + ":" + String(minutes % 60) + ":" + String(seconds % 60);
+    enqueue(type, message.c_str(), message.length());
+}
+
+void DebugLogger::logf(LogType type, const char* format, ...) {
+    char text[ENTRY_TEXT_SIZE + 1];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (n < 0) return;
     
-    String logEntry = "[" + timestamp + "] " + message;
+    // Длинное сообщение обрезается в enqueue() по границе символа UTF-8
+    size_t length = (size_t)n < sizeof(text) ? (size_t)n : sizeof(text) - 1;
+    enqueue(type, text, length);
+}
+
+bool DebugLogger::isEnabled(LogModule module, LogLevel level) {
+    if (module >= LOG_MODULE_COUNT || level < moduleLevels[module]) return false;
+    return level != LOG_LEVEL_DEBUG || config.debugEnabled;
+}
+
+void DebugLogger::setModuleLevel(LogModule module, LogLevel level) {
+    if (module >= LOG_MODULE_COUNT) return;
+    moduleLevels[module] = level;
+}
+
+LogLevel DebugLogger::getModuleLevel(LogModule module) {
+    return module < LOG_MODULE_COUNT ? (LogLevel)moduleLevels[module] : LOG_LEVEL_NONE;
+}
+
+const char* DebugLogger::getModuleName(LogModule module) {
+    switch(module) {
+        case LOG_MODULE_MAIN: return "main";
+        case LOG_MODULE_SENSOR: return "sensor";
+        case LOG_MODULE_RELAY: return "relay";
+        case LOG_MODULE_WEB: return "web";
+        case LOG_MODULE_LOGGER: return "logger";
+        default: return "unknown";
+    }
+}
+
+bool DebugLogger::enqueue(LogType type, const char* text, size_t length) {
+    if (!logRingReady.load(std::memory_order_acquire)) {
+        statDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    LogSlot* slot;
+    for (;;) {
+        slot = &logRing[pos & (QUEUE_SIZE - 1)];
+        uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            statDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
     
-    // Всегда выводим в Serial для отладки
-    Serial.println(logEntry);
+    if (length > ENTRY_TEXT_SIZE) {
+        // Не разрезаем многобайтный символ UTF-8
+        length = ENTRY_TEXT_SIZE;
+        while (length > 0 && ((uint8_t)text[length] & 0xC0) == 0x80) length--;
+        statTruncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot->timestamp = millis();
+    slot->type = (uint8_t)type;
+    slot->length = (uint16_t)length;
+    memcpy(slot->text, text, length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    statEnqueued.fetch_add(1, std::memory_order_relaxed);
     
-    // Пишем в файл если не debug или debug включен
-    if (type != DEBUG_LOG || config.debugEnabled) {
-        writeToFile(logEntry + "\n", getFilename(type));
+    uint16_t depth = (uint16_t)(pos + 1 - dequeuePos.load(std::memory_order_acquire));
+    if (depth > statHighWater.load(std::memory_order_relaxed)) {
+        statHighWater.store(depth, std::memory_order_relaxed);
+    }
+    // Очередь заполнена наполовину - не ждем FLUSH_INTERVAL; будим один раз,
+    // даже если пачка сообщений перескочила ровно половину
+    if (depth >= QUEUE_SIZE / 2 && writerHandle != nullptr &&
+        !drainRequested.exchange(true, std::memory_order_acq_rel)) {
+        xTaskNotifyGive(writerHandle);
     }
+    return true;
 }
 
-void DebugLogger::logSensor(float lux, bool relayState) {
-    String timestamp = String(millis());
-    String logEntry = "[" + timestamp + "] LUX:" + String(lux, 2) + 
-                     " RELAY:" + (relayState ? "ON" : "OFF");
+uint8_t DebugLogger::dequeueBatch(LogBatchEntry* batch, uint8_t maxEntries) {
+    uint8_t count = 0;
+    uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+    while (count < maxEntries) {
+        LogSlot& slot = logRing[pos & (QUEUE_SIZE - 1)];
+        uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != pos + 1) break;
+        
+        LogBatchEntry& entry = batch[count++];
+        entry.timestamp = slot.timestamp;
+        entry.type = slot.type;
+        entry.length = slot.length;
+        memcpy(entry.text, slot.text, slot.length);
+        
+        slot.sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
+        pos++;
+        dequeuePos.store(pos, std::memory_order_release);
+    }
+    return count;
+}
+
+void DebugLogger::writerTask(void* param) {
+    (void)param;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_INTERVAL));
+        drainRequested.store(false, std::memory_order_release);
+        drainQueue();
+    }
+}
+
+static size_t formatEntry(const LogBatchEntry& entry, char* out, size_t size) {
+    unsigned long seconds = entry.timestamp / 1000;
+    unsigned long minutes = seconds / 60;
+    unsigned long hours = minutes / 60;
+    int n = snprintf(out, size, "[%lu:%lu:%lu] %.*s", hours, minutes % 60, seconds % 60,
+                     (int)entry.length, entry.text);
+    if (n < 0) return 0;
+    return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+void DebugLogger::drainQueue() {
+    uint8_t clearMask = pendingClear.exchange(0);
+    for (uint8_t type = DEBUG_LOG; type <= SYSTEM_LOG; type++) {
+        if (clearMask & (1 << type)) removeSegments((LogType)type);
+    }
     
-    writeToFile(logEntry + "\n", getFilename(SENSOR_LOG));
+    uint8_t count;
+    while ((count = dequeueBatch(writeBatch, LOG_BATCH_SIZE)) > 0) {
+        char line[ENTRY_TEXT_SIZE + 24];
+        for (uint8_t i = 0; i < count; i++) {
+            size_t n = formatEntry(writeBatch[i], line, sizeof(line));
+            Serial.write((const uint8_t*)line, n);
+            Serial.println();
+        }
+        
+        // Один открытый файл на тип лога на весь пакет
+        writeToFile(DEBUG_LOG, writeBatch, count);
+        writeToFile(EVENT_LOG, writeBatch, count);
+        writeToFile(SYSTEM_LOG, writeBatch, count);
+        
+        statWritten.fetch_add(count, std::memory_order_relaxed);
+        statBatches.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool DebugLogger::flush(uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (dequeuePos.load(std::memory_order_acquire) != enqueuePos.load(std::memory_order_acquire) ||
+           pendingClear.load(std::memory_order_acquire) != 0) {
+        if (writerHandle == nullptr || millis() - start >= timeoutMs) return false;
+        xTaskNotifyGive(writerHandle);
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return true;
+}
+
+LogQueueStats DebugLogger::getQueueStats() {
+    LogQueueStats stats;
+    stats.enqueued = statEnqueued.load(std::memory_order_relaxed);
+    stats.written = statWritten.load(std::memory_order_relaxed);
+    stats.dropped = statDropped.load(std::memory_order_relaxed);
+    stats.truncated = statTruncated.load(std::memory_order_relaxed);
+    stats.batches = statBatches.load(std::memory_order_relaxed);
+    stats.depth = (uint16_t)(enqueuePos.load(std::memory_order_relaxed) -
+                             dequeuePos.load(std::memory_order_acquire));
+    stats.highWater = statHighWater.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Показания пишутся двоичными записями в SensorStore, а не текстом в sensor.log
+void DebugLogger::logSensor(float lux, bool relayState) {
+    SensorStore::append(lux, relayState, config.autoMode);
     
     // Дублируем в debug если включено
-    if (config.debugEnabled) {
-        DEBUG_LOG("📊 " + logEntry);
-    }
+    DEBUG_LOGF(LOG_MODULE_SENSOR, "📊 [%lu] LUX:%.2f RELAY:%s",
+               (unsigned long)millis(), lux, relayState ? "ON" : "OFF");
+}
+
+static void appendChunk(const char* data, size_t length, void* context) {
+    String* result = static_cast<String*>(context);
+    result->concat(data, length);
+}
+
+struct SensorTailContext {
+    DebugLogger::ChunkCallback callback;
+    void* context;
+};
+
+static void sendSensorLine(const SensorRecord& record, void* context) {
+    SensorTailContext* ctx = static_cast<SensorTailContext*>(context);
+    char line[96];
+    int n = snprintf(line, sizeof(line), "[%lu] LUX:%.2f RELAY:%s MODE:%s BOOT:%u\n",
+                     (unsigned long)record.timestamp, record.lux,
+                     (record.flags & SENSOR_FLAG_RELAY) ? "ON" : "OFF",
+                     (record.flags & SENSOR_FLAG_AUTO) ? "AUTO" : "MANUAL",
+                     (unsigned)record.bootCount);
+    if (n > 0) ctx->callback(line, n, ctx->context);
 }
 
-void DebugLogger::writeToFile(const String& message, const String& filename) {
-    // Определяем тип лога по имени файла
-    LogType type = DEBUG_LOG;
-    if (filename == "sensor.log") type = SENSOR_LOG;
-    else if (filename == "events.log") type = EVENT_LOG;
-    else if (filename == "system.log") type = SYSTEM_LOG;
+void DebugLogger::writeToFile(LogType type, const LogBatchEntry* batch, uint8_t count) {
+    // Debug пишем в файл только если отладка включена
+    if (type == DEBUG_LOG && !config.debugEnabled) return;
     
-    // Проверяем и ротируем если нужно
-    rotateLogIfNeeded(type);
+    bool hasEntries = false;
+    for (uint8_t i = 0; i < count && !hasEntries; i++) {
+        hasEntries = batch[i].type == type;
+    }
+    if (!hasEntries) return;
     
-    String fullPath = "/logs/" + filename;
+    uint32_t started = Metrics::start();
+    SegmentState& state = segments[type];
+    String fullPath = segmentPath(type, state.head);
     
     File file = LittleFS.open(fullPath, "a");
     if (!file) {
@@ -66,11 +315,33 @@ void DebugLogger::writeToFile(const String& message, const String& filename) {
         return;
     }
     
-    file.print(message);
+    char line[ENTRY_TEXT_SIZE + 24];
+    for (uint8_t i = 0; i < count; i++) {
+        if (batch[i].type != type) continue;
+        size_t n = formatEntry(batch[i], line, sizeof(line) - 1);
+        line[n++] = '\n';
+        
+        // Строка не делится между сегментами
+        if (state.headBytes > 0 && state.headBytes + n > SEGMENT_SIZE) {
+            file.close();
+            rotateLog(type);
+            file = LittleFS.open(segmentPath(type, state.head), "a");
+            if (!file) return;
+        }
+        file.write((const uint8_t*)line, n);
+        state.headBytes += n;
+        Metrics::count(METRIC_LOG_BYTES, n);
+    }
     file.close();
-    
-    // Выводим в Serial для отладки
-    Serial.print("LOG: " + filename + " - " + message);
+    Metrics::record(METRIC_LOG_WRITE, started);
+}
+
+String DebugLogger::getLogDir(LogType type) {
+    return String("/logs/") + getLogName(type);
+}
+
+String DebugLogger::segmentPath(LogType type, uint32_t sequence) {
+    return getLogDir(type) + "/" + String(sequence) + ".log";
 }
 
 String DebugLogger::getFilename(LogType type) {
@@ -85,136 +356,220 @@ String DebugLogger::getFilename(LogType type) {
 
 void DebugLogger::enableDebug(bool enable) {
     config.debugEnabled = enable;
+    EventTrace::recordFloat(TRACE_CONFIG_CHANGE, TRACE_CONFIG_DEBUG, enable ? 1 : 0);
     saveConfig();
-    EVENT_LOG("🔧 Отладка " + String(enable ? "включена" : "выключена"));
+    EVENT_LOGF(LOG_MODULE_LOGGER, "🔧 Отладка %s", enable ? "включена" : "выключена");
 }
 
 String DebugLogger::getLog(LogType type, uint16_t maxLines) {
-    String fullPath = "/logs/" + getFilename(type);
     String result = "";
-    uint16_t lineCount = 0;
+    readTail(type, maxLines, appendChunk, &result);
+    return result;
+}
+
+uint16_t DebugLogger::readTail(LogType type, uint16_t maxLines, ChunkCallback callback, void* context) {
+    if (maxLines == 0) return 0;
     
-    File file = LittleFS.open(fullPath, "r");
-    if (!file) {
-        return "Файл не найден: " + fullPath;
+    if (type == SENSOR_LOG) {
+        SensorTailContext ctx = {callback, context};
+        return SensorStore::readLatest(maxLines, sendSensorLine, &ctx);
     }
     
-    // Читаем файл и берем последние maxLines строк
-    while (file.available() && lineCount < maxLines) {
-        result = file.readStringUntil('\n') + "\n" + result;
-        lineCount++;
+    // Снимок границ: фоновая задача может добавить сегмент во время чтения
+    const SegmentState& state = segments[type];
+    uint32_t first = state.first;
+    uint32_t head = state.head;
+    
+    char block[256];
+    uint32_t startSeq = first;
+    uint32_t startPos = 0;
+    uint32_t endSize = 0;       // размер головного сегмента на момент поиска
+    uint16_t newlines = 0;      // последний '\n' завершает последнюю строку
+    bool atEnd = true;
+    bool found = false;
+    
+    // Проход 1: блоками с конца ищем начало maxLines-й строки с конца
+    for (uint32_t seq = head + 1; seq-- > first && !found;) {
+        File file = LittleFS.open(segmentPath(type, seq), "r");
+        if (!file) continue;
+        uint32_t pos = file.size();
+        if (seq == head) endSize = pos;
+        
+        while (pos > 0 && !found) {
+            uint32_t chunk = pos < sizeof(block) ? pos : sizeof(block);
+            pos -= chunk;
+            file.seek(pos);
+            if (file.read((uint8_t*)block, chunk) != chunk) break;
+            
+            for (uint32_t i = chunk; i-- > 0;) {
+                if (block[i] != '\n') {
+                    atEnd = false;
+                    continue;
+                }
+                if (atEnd) {
+                    atEnd = false;
+                    continue;
+                }
+                if (++newlines == maxLines) {
+                    startSeq = seq;
+                    startPos = pos + i + 1;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        file.close();
     }
     
-    file.close();
-    return result;
+    // Проход 2: от найденной позиции вперед до конца, тем же буфером
+    uint16_t lines = 0;
+    for (uint32_t seq = startSeq; seq <= head; seq++) {
+        File file = LittleFS.open(segmentPath(type, seq), "r");
+        if (!file) continue;
+        uint32_t left = (seq == head ? endSize : file.size());
+        uint32_t pos = (seq == startSeq ? startPos : 0);
+        left = left > pos ? left - pos : 0;
+        file.seek(pos);
+        
+        while (left > 0) {
+            uint32_t chunk = left < sizeof(block) ? left : sizeof(block);
+            size_t got = file.read((uint8_t*)block, chunk);
+            if (got == 0) break;
+            for (size_t i = 0; i < got; i++) {
+                if (block[i] == '\n') lines++;
+            }
+            callback(block, got, context);
+            left -= got;
+        }
+        file.close();
+    }
+    return lines;
+}
+
+const char* DebugLogger::getLogName(LogType type) {
+    switch(type) {
+        case DEBUG_LOG: return "debug";
+        case SENSOR_LOG: return "sensor";
+        case EVENT_LOG: return "events";
+        case SYSTEM_LOG: return "system";
+        default: return "unknown";
+    }
+}
+
+bool DebugLogger::parseLogType(const String& name, LogType& type) {
+    for (uint8_t t = DEBUG_LOG; t <= SYSTEM_LOG; t++) {
+        if (name == getLogName((LogType)t)) {
+            type = (LogType)t;
+            return true;
+        }
+    }
+    return false;
 }
 
 void DebugLogger::clearLog(LogType type) {
-    String fullPath = "/logs/" + getFilename(type);
-    LittleFS.remove(fullPath);
-    EVENT_LOG("🧹 Очищен лог: " + getFilename(type));
+    if (type == SENSOR_LOG) {
+        SensorStore::clear();
+        EVENT_LOGF(LOG_MODULE_LOGGER, "🧹 Очищено хранилище показаний");
+        return;
+    }
+    
+    pendingClear.fetch_or(1 << type);
+    flush();
+    EVENT_LOGF(LOG_MODULE_LOGGER, "🧹 Очищен лог: %s", getLogName(type));
 }
 
 void DebugLogger::setMaxLogSize(uint32_t maxSize) {
     maxLogSize = maxSize;
-    SYSTEM_LOG("🔧 Макс. размер лога установлен: " + String(maxSize) + " байт");
+    SYSTEM_LOGF(LOG_MODULE_LOGGER, "🔧 Макс. размер лога установлен: %lu байт", (unsigned long)maxSize);
 }
 
 uint32_t DebugLogger::getLogSize(LogType type) {
-    String fullPath = "/logs/" + getFilename(type);
-    
-    if (!LittleFS.exists(fullPath)) {
-        return 0;
+    if (type == SENSOR_LOG) {
+        return SensorStore::getCount() * sizeof(SensorRecord);
     }
     
-    File file = LittleFS.open(fullPath, "r");
-    if (!file) {
-        return 0;
+    uint32_t size = 0;
+    const SegmentState& state = segments[type];
+    for (uint32_t seq = state.first; seq <= state.head; seq++) {
+        File file = LittleFS.open(segmentPath(type, seq), "r");
+        if (!file) continue;
+        size += file.size();
+        file.close();
     }
-    
-    uint32_t size = file.size();
-    file.close();
     return size;
 }
 
-void DebugLogger::rotateLogIfNeeded(LogType type) {
-    String filename = getFilename(type);
-    String fullPath = "/logs/" + filename;
-    
-    if (!LittleFS.exists(fullPath)) {
-        return;
-    }
-    
-    File file = LittleFS.open(fullPath, "r");
-    if (!file) {
-        return;
-    }
-    
-    uint32_t currentSize = file.size();
-    file.close();
-    
-    // Если файл меньше максимального размера - ничего не делаем
-    if (currentSize <= maxLogSize) {
-        return;
-    }
-    
-    // Логируем в Serial (не в файл, чтобы избежать рекурсии)
-    Serial.println("🔄 Ротация лога: " + filename + " (" + String(currentSize) + " байт)");
-    
-    // Читаем весь файл
-    String allContent = "";
-    File sourceFile = LittleFS.open(fullPath, "r");
-    if (!sourceFile) {
-        Serial.println("❌ Ошибка чтения файла для ротации");
-        return;
-    }
+uint16_t DebugLogger::getSegmentCount() {
+    uint32_t count = maxLogSize / SEGMENT_SIZE;
+    return count < 2 ? 2 : count;
+}
+
+// Восстанавливает first/head по именам файлов в папке лога
+void DebugLogger::loadSegments(LogType type) {
+    SegmentState& state = segments[type];
+    state.first = 0;
+    state.head = 0;
+    state.headBytes = 0;
     
-    allContent = sourceFile.readString();
-    sourceFile.close();
+    String dirPath = getLogDir(type);
+    LittleFS.mkdir(dirPath);
     
-    // Считаем общее количество строк
-    int totalLines = 0;
-    for (size_t i = 0; i < allContent.length(); i++) {
-        if (allContent[i] == '\n') {
-            totalLines++;
+    bool found = false;
+    File dir = LittleFS.open(dirPath);
+    if (dir && dir.isDirectory()) {
+        File entry;
+        while ((entry = dir.openNextFile())) {
+            String name = entry.name();
+            int slash = name.lastIndexOf('/');
+            if (slash >= 0) name = name.substring(slash + 1);
+            uint32_t seq = name.toInt();
+            uint32_t size = entry.size();
+            entry.close();
+            if (!name.endsWith(".log") || (seq == 0 && !name.startsWith("0"))) continue;
+            
+            if (!found || seq < state.first) state.first = seq;
+            if (!found || seq >= state.head) {
+                state.head = seq;
+                state.headBytes = size;
+            }
+            found = true;
         }
     }
+    dir.close();
     
-    // Если строк меньше 100, ничего не делаем
-    if (totalLines <= 100) {
-        Serial.println("📊 Строк меньше 100, ротация не нужна");
-        return;
-    }
-    
-    // Берем последние 80 строк (оставляем запас)
-    int linesToKeep = 80;
-    int linesFound = 0;
-    String keptContent = "";
-    
-    // Идем с конца файла
-    for (int i = allContent.length() - 1; i >= 0; i--) {
-        if (allContent[i] == '\n') {
-            linesFound++;
-            if (linesFound > linesToKeep) {
-                // Нашли достаточно строк, останавливаемся
-                keptContent = allContent.substring(i + 1);
-                break;
-            }
-        }
-        
-        // Если дошли до начала файла
-        if (i == 0) {
-            keptContent = allContent;
+    // Лог старого формата одним файлом становится первым сегментом
+    String legacyPath = "/logs/" + getFilename(type);
+    if (!found && LittleFS.exists(legacyPath)) {
+        LittleFS.rename(legacyPath, segmentPath(type, 0));
+        File file = LittleFS.open(segmentPath(type, 0), "r");
+        if (file) {
+            state.headBytes = file.size();
+            file.close();
         }
     }
+}
+
+// Ротация: новый сегмент и удаление самых старых, без чтения и копирования данных
+void DebugLogger::rotateLog(LogType type) {
+    Metrics::count(METRIC_LOG_ROTATIONS);
+    SegmentState& state = segments[type];
+    state.head++;
+    state.headBytes = 0;
     
-    // Перезаписываем файл
-    File newFile = LittleFS.open(fullPath, "w");
-    if (newFile) {
-        newFile.print(keptContent);
-        newFile.close();
-        Serial.println("✅ Лог усечен: " + String(keptContent.length()) + " байт, " + String(linesToKeep) + " строк сохранено");
-    } else {
-        Serial.println("❌ Ошибка записи при ротации");
+    // При уменьшении maxLogSize лишние сегменты удаляются здесь же
+    uint16_t count = getSegmentCount();
+    while (state.head - state.first >= count) {
+        LittleFS.remove(segmentPath(type, state.first));
+        state.first++;
+    }
+}
+
+void DebugLogger::removeSegments(LogType type) {
+    SegmentState& state = segments[type];
+    for (uint32_t seq = state.first; seq <= state.head; seq++) {
+        LittleFS.remove(segmentPath(type, seq));
     }
+    state.first = state.head + 1;
+    state.head = state.first;
+    state.headBytes = 0;
 }
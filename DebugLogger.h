@@ -11,27 +11,110 @@ enum LogType {
     SYSTEM_LOG
 };
 
+// Уровни по важности; уровень записи определяется типом лога
+enum LogLevel : uint8_t {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_EVENT = 1,
+    LOG_LEVEL_SYSTEM = 2,
+    LOG_LEVEL_NONE = 3
+};
+
+// Модули с собственным порогом уровня во время работы
+enum LogModule : uint8_t {
+    LOG_MODULE_MAIN,      // PhytoController.ino
+    LOG_MODULE_SENSOR,
+    LOG_MODULE_RELAY,
+    LOG_MODULE_WEB,
+    LOG_MODULE_LOGGER,
+    LOG_MODULE_COUNT
+};
+
+// Минимальный уровень сборки: вызовы ниже него вырезаются компилятором вместе с аргументами.
+// Для релиза: -DLOG_MIN_LEVEL=LOG_LEVEL_EVENT
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+constexpr uint8_t LOG_COMPILE_LEVEL = LOG_MIN_LEVEL;
+
+// Счетчики очереди логов
+struct LogQueueStats {
+    uint32_t enqueued;    // принято в очередь
+    uint32_t written;     // выведено фоновой задачей
+    uint32_t dropped;     // отброшено: очередь переполнена
+    uint32_t truncated;   // обрезано: сообщение длиннее слота
+    uint32_t batches;     // пакетов записи
+    uint16_t depth;       // сейчас в очереди
+    uint16_t highWater;   // максимальная глубина очереди
+};
+
+struct LogBatchEntry;
+
 class DebugLogger {
 public:
+    typedef void (*ChunkCallback)(const char* data, size_t length, void* context);
+
+    static const uint16_t QUEUE_SIZE = 64;         // слотов, степень двойки
+    static const uint16_t ENTRY_TEXT_SIZE = 160;   // байт текста в слоте
+    static const uint32_t FLUSH_INTERVAL = 200;    // мс между пакетами фоновой записи
+    static const uint32_t SEGMENT_SIZE = 4096;     // байт в сегменте лога
+
     static void begin();
     static void log(const String& message, LogType type = DEBUG_LOG);
+    // Форматирование в буфер на стеке, без кучи; вызывать через макросы *_LOGF
+    static void logf(LogType type, const char* format, ...) __attribute__((format(printf, 2, 3)));
+    // Проверка до форматирования: порог модуля и config.debugEnabled для DEBUG
+    static bool isEnabled(LogModule module, LogLevel level);
+    static void setModuleLevel(LogModule module, LogLevel level);
+    static LogLevel getModuleLevel(LogModule module);
+    static const char* getModuleName(LogModule module);
     static void logSensor(float lux, bool relayState);
     static void enableDebug(bool enable);
     static String getLog(LogType type, uint16_t maxLines = 50);
+    // Последние maxLines строк лога, от старых к новым, порциями через callback;
+    // память не зависит ни от размера лога, ни от maxLines
+    static uint16_t readTail(LogType type, uint16_t maxLines, ChunkCallback callback, void* context);
+    static bool parseLogType(const String& name, LogType& type);
+    static const char* getLogName(LogType type);
     static void clearLog(LogType type);
     static void setMaxLogSize(uint32_t maxSize); // 🔄 Новая функция
     static uint32_t getLogSize(LogType type);    // 🔄 Новая функция
+    static LogQueueStats getQueueStats();
+    static bool flush(uint32_t timeoutMs = 1000);   // дождаться записи очереди
 
 private:
-    static void writeToFile(const String& message, const String& filename);
+    static bool enqueue(LogType type, const char* text, size_t length);
+    static uint8_t dequeueBatch(LogBatchEntry* batch, uint8_t maxEntries);
+    static void writerTask(void* param);
+    static void drainQueue();
+    static void writeToFile(LogType type, const LogBatchEntry* batch, uint8_t count);
     static String getFilename(LogType type);
-    static void rotateLogIfNeeded(LogType type); // 🔄 Новая функция
-    static uint32_t maxLogSize; // 🔄 Максимальный размер лога в байтах
+    static String getLogDir(LogType type);
+    static String segmentPath(LogType type, uint32_t sequence);
+    static void loadSegments(LogType type);
+    static void rotateLog(LogType type);
+    static void removeSegments(LogType type);
+    static uint16_t getSegmentCount();
+    
+    // Текстовый лог - цепочка файлов <тип>/<sequence>.log; пишется только в конец
+    struct SegmentState {
+        uint32_t first;       // самый старый сегмент
+        uint32_t head;        // сегмент, в который идет запись
+        uint32_t headBytes;   // его размер
+    };
+    static SegmentState segments[SYSTEM_LOG + 1];
+    static uint32_t maxLogSize; // 🔄 Суммарный размер сегментов одного лога в байтах
+    static uint8_t moduleLevels[LOG_MODULE_COUNT];
 };
 
-// Макросы для логирования
-#define DEBUG_LOG(message) DebugLogger::log(message, DEBUG_LOG)
-#define EVENT_LOG(message) DebugLogger::log(message, EVENT_LOG)
-#define SYSTEM_LOG(message) DebugLogger::log(message, SYSTEM_LOG)
+// Макросы для логирования: DEBUG_LOGF(LOG_MODULE_SENSOR, "lux=%.2f", lux).
+// Аргументы вычисляются только если запись пройдет оба порога
+#define LOG_AT(module, type, level, format, ...) do { \
+    if ((level) >= LOG_COMPILE_LEVEL && DebugLogger::isEnabled(module, level)) \
+        DebugLogger::logf(type, format, ##__VA_ARGS__); \
+} while (0)
+
+#define DEBUG_LOGF(module, format, ...) LOG_AT(module, DEBUG_LOG, LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define EVENT_LOGF(module, format, ...) LOG_AT(module, EVENT_LOG, LOG_LEVEL_EVENT, format, ##__VA_ARGS__)
+#define SYSTEM_LOGF(module, format, ...) LOG_AT(module, SYSTEM_LOG, LOG_LEVEL_SYSTEM, format, ##__VA_ARGS__)
 
 #endif
@@ -0,0 +1,116 @@
+// EventTrace.cpp
+#include "EventTrace.h"
+#include "SensorStore.h"
+#include <LittleFS.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+
+static const uint32_t RING_MAGIC = 0x474E5254;   // "TRNG"
+
+// Содержимое RTC-памяти после включения питания случайно - проверяется по magic
+struct TraceRing {
+    uint32_t magic;
+    uint32_t head;          // сквозной номер следующей записи
+    uint16_t resetReason;   // причина сброса загрузки, писавшей кольцо
+    TraceRecord records[EventTrace::CAPACITY];
+};
+
+static RTC_NOINIT_ATTR TraceRing traceRing;
+
+static bool isCrashReset(esp_reset_reason_t reason) {
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT ||
+           reason == ESP_RST_WDT || reason == ESP_RST_BROWNOUT;
+}
+
+void EventTrace::begin() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool valid = traceRing.magic == RING_MAGIC && reason != ESP_RST_POWERON;
+    
+    if (valid && isCrashReset(reason)) {
+        Serial.println("💥 Сохраняем трассировку после сбоя (причина сброса " + String((int)reason) + ")");
+        snapshot(TRACE_SNAPSHOT_CRASH);
+    }
+    
+    // После программного сброса история продолжается, граница - событие boot
+    if (!valid) {
+        traceRing.head = 0;
+        traceRing.magic = RING_MAGIC;
+    }
+    traceRing.resetReason = (uint16_t)reason;
+    
+    record(TRACE_BOOT, (uint16_t)reason, SensorStore::getBootCount());
+}
+
+void EventTrace::record(TraceEvent event, uint16_t arg, int32_t value) {
+    // Слот занимается атомарно: писать могут задачи на обоих ядрах
+    uint32_t pos = __atomic_fetch_add(&traceRing.head, 1, __ATOMIC_RELAXED);
+    TraceRecord& slot = traceRing.records[pos & (CAPACITY - 1)];
+    slot.timestamp = millis();
+    slot.event = event;
+    slot.arg = arg;
+    slot.value.i = value;
+}
+
+void EventTrace::recordFloat(TraceEvent event, uint16_t arg, float value) {
+    int32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    record(event, arg, bits);
+}
+
+// Заголовок и записи от старых к новым; кольцо отдается прямо из памяти, не более двух кусков
+uint32_t EventTrace::stream(uint16_t reason, ChunkCallback callback, void* context) {
+    uint32_t head = __atomic_load_n(&traceRing.head, __ATOMIC_RELAXED);
+    TraceFileHeader header;
+    header.magic = TRACE_FILE_MAGIC;
+    header.version = TRACE_FILE_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.count = head < CAPACITY ? head : CAPACITY;
+    header.dropped = head - header.count;
+    header.reason = reason;
+    header.resetReason = traceRing.resetReason;
+    callback((const uint8_t*)&header, sizeof(header), context);
+    
+    uint32_t first = (head - header.count) & (CAPACITY - 1);
+    uint32_t tail = CAPACITY - first < header.count ? CAPACITY - first : header.count;
+    callback((const uint8_t*)&traceRing.records[first], tail * sizeof(TraceRecord), context);
+    if (tail < header.count) {
+        callback((const uint8_t*)&traceRing.records[0], (header.count - tail) * sizeof(TraceRecord), context);
+    }
+    return header.count;
+}
+
+void EventTrace::read(ChunkCallback callback, void* context) {
+    stream(0, callback, context);
+}
+
+static void writeChunk(const uint8_t* data, size_t length, void* context) {
+    static_cast<File*>(context)->write(data, length);
+}
+
+bool EventTrace::snapshot(TraceSnapshotReason reason) {
+    const char* path = getSnapshotPath(reason);
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        Serial.println("❌ Ошибка записи трассировки: " + String(path));
+        return false;
+    }
+    uint32_t count = stream(reason, writeChunk, &file);
+    file.close();
+    
+    record(TRACE_SNAPSHOT, reason, count);
+    return true;
+}
+
+const char* EventTrace::getSnapshotPath(TraceSnapshotReason reason) {
+    return reason == TRACE_SNAPSHOT_CRASH ? "/logs/trace-crash.bin" : "/logs/trace.bin";
+}
+
+uint32_t EventTrace::getCount() {
+    uint32_t head = __atomic_load_n(&traceRing.head, __ATOMIC_RELAXED);
+    return head < CAPACITY ? head : CAPACITY;
+}
+
+uint32_t EventTrace::getDropped() {
+    return __atomic_load_n(&traceRing.head, __ATOMIC_RELAXED) - getCount();
+}
+
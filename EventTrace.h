@@ -0,0 +1,151 @@
+// EventTrace.h
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <Arduino.h>
+
+// Коды событий трассировки: X(имя, код, "текст", тип значения).
+// Коды записаны в снимках на флеше - существующие не менять, только добавлять
+#define TRACE_EVENT_LIST(X) \
+    X(TRACE_BOOT,             1, "boot",             TRACE_VALUE_INT)   /* arg: причина сброса */ \
+    X(TRACE_RELAY_ON,         2, "relay_on",         TRACE_VALUE_INT)   /* arg: зона, value: мс в выключенном состоянии */ \
+    X(TRACE_RELAY_OFF,        3, "relay_off",        TRACE_VALUE_INT)   /* arg: зона, value: мс во включенном состоянии */ \
+    X(TRACE_SENSOR_OK,        4, "sensor_ok",        TRACE_VALUE_FLOAT) /* первое чтение после ошибок, arg: зона, value: lux */ \
+    X(TRACE_SENSOR_FAIL,      5, "sensor_fail",      TRACE_VALUE_INT)   /* arg: TraceSensorStage | зона << 8 */ \
+    X(TRACE_SENSOR_RECONNECT, 6, "sensor_reconnect", TRACE_VALUE_INT)   /* arg: 1 - успешно | зона << 8 */ \
+    X(TRACE_HTTP_REQUEST,     7, "http_request",     TRACE_VALUE_INT)   /* arg: TraceRoute, value: мкс обработки */ \
+    X(TRACE_CONFIG_CHANGE,    8, "config_change",    TRACE_VALUE_FLOAT) /* arg: TraceConfigField (у полей зон | зона << 8), value: новое значение */ \
+    X(TRACE_SNAPSHOT,         9, "snapshot",         TRACE_VALUE_INT)   /* arg: TraceSnapshotReason */ \
+    X(TRACE_CONTROL_DECISION,10, "control_decision", TRACE_VALUE_FLOAT) /* arg: 1 - включить | зона << 8, value: lux */ \
+    X(TRACE_CLOCK_SET,       11, "clock_set",        TRACE_VALUE_INT)   /* arg: ClockSource, value: поправка, с */ \
+    X(TRACE_SENSOR_RANGE,    12, "sensor_range",     TRACE_VALUE_FLOAT) /* arg: новый диапазон | зона << 8, value: lux */ \
+    X(TRACE_SENSOR_HEALTH,   13, "sensor_health",    TRACE_VALUE_INT)   /* arg: SensorHealthState | зона << 8, value: мс с потери датчика */
+
+enum TraceValueType : uint8_t {
+    TRACE_VALUE_INT,
+    TRACE_VALUE_FLOAT
+};
+
+enum TraceEvent : uint16_t {
+#define TRACE_EVENT_ENUM(name, code, text, type) name = code,
+    TRACE_EVENT_LIST(TRACE_EVENT_ENUM)
+#undef TRACE_EVENT_ENUM
+};
+
+enum TraceSensorStage : uint16_t {
+    TRACE_SENSOR_START = 1,    // не удалось запустить преобразование
+    TRACE_SENSOR_READ = 2      // ошибка чтения результата
+};
+
+enum TraceRoute : uint16_t {
+    TRACE_ROUTE_CONTROL = 1,
+    TRACE_ROUTE_SETTINGS = 2,
+    TRACE_ROUTE_TRACE = 3,
+    TRACE_ROUTE_NOT_FOUND = 4,
+    TRACE_ROUTE_CLOCK = 5,
+    TRACE_ROUTE_ZONE = 6
+};
+
+enum TraceConfigField : uint16_t {
+    TRACE_CONFIG_THRESHOLD = 1,
+    TRACE_CONFIG_AUTO_MODE = 2,
+    TRACE_CONFIG_DEBUG = 3,
+    TRACE_CONFIG_CHECK_INTERVAL = 4,
+    TRACE_CONFIG_SENSOR_LOG_INTERVAL = 5,
+    TRACE_CONFIG_SAMPLE_MAX_AGE = 6,
+    TRACE_CONFIG_MANUAL_ON = 7,
+    TRACE_CONFIG_MAX_LOG_SIZE = 8,
+    TRACE_CONFIG_SENSOR_STORE_SIZE = 9,
+    TRACE_CONFIG_SCHEDULE = 10,    // value: минут света в неделю
+    TRACE_CONFIG_HYSTERESIS = 11,
+    TRACE_CONFIG_MIN_ON_TIME = 12,
+    TRACE_CONFIG_MIN_OFF_TIME = 13,
+    TRACE_CONFIG_FILTER_ALPHA = 14,
+    TRACE_CONFIG_TIMEZONE = 15,
+    TRACE_CONFIG_DLI_MODE = 16,
+    TRACE_CONFIG_DLI_TARGET = 17,
+    TRACE_CONFIG_LUX_TO_PPFD = 18,
+    TRACE_CONFIG_LAMP_PPFD = 19,
+    TRACE_CONFIG_DAY_START = 20,
+    TRACE_CONFIG_ZONE_THRESHOLD = 21,
+    TRACE_CONFIG_ZONE_MODE = 22,
+    TRACE_CONFIG_DIM_MODE = 23,
+    TRACE_CONFIG_DIM_TARGET = 24,
+    TRACE_CONFIG_DIM_KP = 25,
+    TRACE_CONFIG_DIM_KI = 26,
+    TRACE_CONFIG_FAIL_SAFE = 27
+};
+
+enum TraceSnapshotReason : uint16_t {
+    TRACE_SNAPSHOT_REQUEST = 1,   // по запросу /api/trace/snapshot
+    TRACE_SNAPSHOT_RESTART = 2,   // обработчик ESP.restart()
+    TRACE_SNAPSHOT_CRASH = 3      // при загрузке после паники, WDT или просадки питания
+};
+
+// Запись трассировки фиксированного размера
+struct __attribute__((packed)) TraceRecord {
+    uint32_t timestamp;   // millis()
+    uint16_t event;       // TraceEvent
+    uint16_t arg;
+    union {
+        int32_t i;
+        float f;
+    } value;
+};
+
+// Заголовок снимка /logs/trace*.bin и ответа /api/trace; далее count записей от старых к новым
+struct __attribute__((packed)) TraceFileHeader {
+    uint32_t magic;         // TRACE_FILE_MAGIC
+    uint16_t version;
+    uint16_t recordSize;    // sizeof(TraceRecord)
+    uint32_t count;
+    uint32_t dropped;       // записей вытеснено из кольца до снимка
+    uint16_t reason;        // TraceSnapshotReason, 0 - живое кольцо
+    uint16_t resetReason;   // esp_reset_reason() загрузки, к которой относится кольцо
+};
+
+const uint32_t TRACE_FILE_MAGIC = 0x31525450;   // "PTR1"
+const uint16_t TRACE_FILE_VERSION = 1;
+
+// Двоичная трассировка событий для разбора после сбоя.
+// Кольцо лежит в RTC-памяти и переживает программный сброс, панику и WDT:
+// после такой загрузки begin() сохраняет его в /logs/trace-crash.bin
+class EventTrace {
+public:
+    static const uint16_t CAPACITY = 256;    // степень двойки; 3 КБ из 8 КБ RTC slow memory
+
+    typedef void (*ChunkCallback)(const uint8_t* data, size_t length, void* context);
+
+    static void begin();
+    static void record(TraceEvent event, uint16_t arg = 0, int32_t value = 0);
+    static void recordFloat(TraceEvent event, uint16_t arg, float value);
+    static bool snapshot(TraceSnapshotReason reason);
+    // Живое кольцо в формате файла снимка, порциями через callback
+    static void read(ChunkCallback callback, void* context);
+
+    static const char* getSnapshotPath(TraceSnapshotReason reason);
+    // Inline: заголовок без зависимостей используется и декодером host/tools/trace_decode
+    static const char* getEventName(uint16_t event) {
+        switch (event) {
+#define TRACE_EVENT_NAME(name, code, text, type) case code: return text;
+            TRACE_EVENT_LIST(TRACE_EVENT_NAME)
+#undef TRACE_EVENT_NAME
+            default: return "unknown";
+        }
+    }
+    static TraceValueType getValueType(uint16_t event) {
+        switch (event) {
+#define TRACE_EVENT_TYPE(name, code, text, type) case code: return type;
+            TRACE_EVENT_LIST(TRACE_EVENT_TYPE)
+#undef TRACE_EVENT_TYPE
+            default: return TRACE_VALUE_INT;
+        }
+    }
+    static uint32_t getCount();
+    static uint32_t getDropped();
+
+private:
+    static uint32_t stream(uint16_t reason, ChunkCallback callback, void* context);
+};
+
+#endif
@@ -0,0 +1,240 @@
+// History.cpp
+#include "History.h"
+#include "AtomicFile.h"
+#include <LittleFS.h>
+#include <esp_timer.h>
+
+static const uint32_t FILE_MAGIC = 0x54534948;   // "HIST"
+static const uint16_t FILE_VERSION = 1;
+static const char* FILE_PATH = "/history.bin";
+static const char* TEMP_PATH = "/history.tmp";
+
+struct LevelInfo {
+    const char* name;
+    uint32_t seconds;
+    uint16_t capacity;
+};
+
+static const LevelInfo LEVELS[HISTORY_LEVELS] = {
+    {"1m", 60, 24 * 60},
+    {"15m", 15 * 60, 7 * 24 * 4},
+    {"1h", 60 * 60, 60 * 24},
+};
+
+// Интервал хранится тремя словами, чтобы читатель брал их атомарно по одному:
+// min | max << 16, биты суммы, count | relayOn << 16
+static const uint8_t BUCKET_WORDS = 3;
+static const uint32_t TOTAL_BUCKETS = 24 * 60 + 7 * 24 * 4 + 60 * 24;
+
+// Как Seqlock из SharedState.h, но на уровень целиком: копировать 40 КБ ради
+// одного ответа незачем, читатель берет кусок интервалов и проверяет счетчик
+struct Level {
+    uint32_t sequence;    // нечетный - идет запись
+    uint32_t head;        // номер последнего интервала (время / seconds)
+    uint32_t* words;
+};
+
+static uint32_t bucketWords[TOTAL_BUCKETS * BUCKET_WORDS];
+static Level levels[HISTORY_LEVELS];
+static uint32_t timeBase = 0;   // секунды истории на момент загрузки
+
+struct __attribute__((packed)) FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bucketCount;   // проверка, что размеры уровней не менялись
+    uint32_t time;
+    uint32_t heads[HISTORY_LEVELS];
+};
+
+static const uint16_t EMPTY_MIN = 0xFFFF;
+
+static void clearSlot(uint32_t* slot) {
+    __atomic_store_n(&slot[0], (uint32_t)EMPTY_MIN, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot[1], 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot[2], 0u, __ATOMIC_RELAXED);
+}
+
+static void clearAll() {
+    uint32_t offset = 0;
+    for (uint8_t i = 0; i < HISTORY_LEVELS; i++) {
+        levels[i].sequence = 0;
+        levels[i].head = History::now() / LEVELS[i].seconds;
+        levels[i].words = &bucketWords[offset];
+        for (uint16_t b = 0; b < LEVELS[i].capacity; b++) clearSlot(&levels[i].words[b * BUCKET_WORDS]);
+        offset += LEVELS[i].capacity * BUCKET_WORDS;
+    }
+}
+
+static bool loadCheckpoint() {
+    File file = LittleFS.open(FILE_PATH, "r");
+    if (!file) return false;
+
+    FileHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == FILE_MAGIC && header.version == FILE_VERSION &&
+                 header.bucketCount == TOTAL_BUCKETS &&
+                 file.read((uint8_t*)bucketWords, sizeof(bucketWords)) == sizeof(bucketWords);
+    file.close();
+    if (!valid) return false;
+
+    timeBase = header.time;
+    for (uint8_t i = 0; i < HISTORY_LEVELS; i++) levels[i].head = header.heads[i];
+    return true;
+}
+
+void History::begin() {
+    clearAll();
+    if (loadCheckpoint()) {
+        Serial.println("📈 История загружена, время " + String(timeBase) + " с");
+    } else {
+        clearAll();
+        Serial.println("📈 История начата заново");
+    }
+}
+
+// Время с загрузки берется из 64-битного таймера: millis() переполняется через 49 дней
+uint32_t History::now() {
+    return timeBase + (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+void History::add(float lux, bool relayState) {
+    uint32_t t = now();
+    uint16_t value = lux <= 0 ? 0 : lux >= 65535 ? 65535 : (uint16_t)(lux + 0.5f);
+
+    for (uint8_t i = 0; i < HISTORY_LEVELS; i++) {
+        Level& level = levels[i];
+        uint16_t capacity = LEVELS[i].capacity;
+        uint32_t n = t / LEVELS[i].seconds;
+
+        __atomic_store_n(&level.sequence, level.sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        // Новые интервалы очищаются один раз, поэтому в среднем это O(1)
+        if (n > level.head) {
+            uint32_t gap = n - level.head < capacity ? n - level.head : capacity;
+            for (uint32_t k = 1; k <= gap; k++) clearSlot(&level.words[((n - gap + k) % capacity) * BUCKET_WORDS]);
+            __atomic_store_n(&level.head, n, __ATOMIC_RELAXED);
+        }
+
+        uint32_t* slot = &level.words[(n % capacity) * BUCKET_WORDS];
+        uint16_t minLux = slot[0] & 0xFFFF;
+        uint16_t maxLux = slot[0] >> 16;
+        if (value < minLux) minLux = value;
+        if (value > maxLux) maxLux = value;
+        float sum;
+        memcpy(&sum, &slot[1], sizeof(sum));
+        sum += lux > 0 ? lux : 0;
+        uint32_t sumBits;
+        memcpy(&sumBits, &sum, sizeof(sumBits));
+        uint16_t count = slot[2] & 0xFFFF;
+        uint16_t relayOn = slot[2] >> 16;
+        if (count < 0xFFFF) {
+            count++;
+            if (relayState) relayOn++;
+        }
+
+        __atomic_store_n(&slot[0], (uint32_t)minLux | ((uint32_t)maxLux << 16), __ATOMIC_RELAXED);
+        __atomic_store_n(&slot[1], sumBits, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot[2], (uint32_t)count | ((uint32_t)relayOn << 16), __ATOMIC_RELAXED);
+        __atomic_store_n(&level.sequence, level.sequence + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Сбой посреди записи не портит прежнюю точку
+bool History::checkpoint() {
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.bucketCount = TOTAL_BUCKETS;
+    header.time = now();
+    for (uint8_t i = 0; i < HISTORY_LEVELS; i++) header.heads[i] = levels[i].head;
+
+    return AtomicFile::write(FILE_PATH, TEMP_PATH, &header, sizeof(header), bucketWords, sizeof(bucketWords));
+}
+
+uint32_t History::getRange(HistoryResolution resolution, uint32_t& from, uint32_t to) {
+    const LevelInfo& info = LEVELS[resolution];
+    uint32_t head = __atomic_load_n(&levels[resolution].head, __ATOMIC_ACQUIRE);
+    uint32_t last = to / info.seconds;
+    if (last > head) last = head;
+    uint32_t oldest = head >= info.capacity ? head - info.capacity + 1 : 0;
+    uint32_t first = from / info.seconds;
+    if (first < oldest) first = oldest;
+    from = first * info.seconds;
+    return last >= first ? last - first + 1 : 0;
+}
+
+uint32_t History::read(HistoryResolution resolution, uint32_t from, uint32_t to,
+                       BucketCallback callback, void* context) {
+    const LevelInfo& info = LEVELS[resolution];
+    const Level& level = levels[resolution];
+    uint32_t count = getRange(resolution, from, to);
+    uint32_t first = from / info.seconds;
+
+    const uint8_t CHUNK = 32;
+    uint32_t words[CHUNK * BUCKET_WORDS];
+    for (uint32_t done = 0; done < count; done += CHUNK) {
+        uint8_t n = count - done < CHUNK ? count - done : CHUNK;
+        uint32_t head;
+        for (uint32_t retries = 0;; retries++) {
+            uint32_t before = __atomic_load_n(&level.sequence, __ATOMIC_ACQUIRE);
+            if (!(before & 1)) {
+                head = __atomic_load_n(&level.head, __ATOMIC_RELAXED);
+                for (uint8_t k = 0; k < n; k++) {
+                    const uint32_t* slot = &level.words[((first + done + k) % info.capacity) * BUCKET_WORDS];
+                    for (uint8_t w = 0; w < BUCKET_WORDS; w++) {
+                        words[k * BUCKET_WORDS + w] = __atomic_load_n(&slot[w], __ATOMIC_RELAXED);
+                    }
+                }
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&level.sequence, __ATOMIC_RELAXED) == before) break;
+            }
+            if ((retries & 0x3F) == 0x3F) vTaskDelay(1);
+        }
+
+        for (uint8_t k = 0; k < n; k++) {
+            uint32_t number = first + done + k;
+            const uint32_t* slot = &words[k * BUCKET_WORDS];
+            HistoryBucket bucket;
+            // Пока шел ответ, кольцо могло уйти вперед и затереть интервал
+            if (number + info.capacity <= head) {
+                bucket.minLux = 0;
+                bucket.maxLux = 0;
+                bucket.sumLux = 0;
+                bucket.count = 0;
+                bucket.relayOn = 0;
+            } else {
+                bucket.minLux = slot[0] & 0xFFFF;
+                bucket.maxLux = slot[0] >> 16;
+                memcpy(&bucket.sumLux, &slot[1], sizeof(bucket.sumLux));
+                bucket.count = slot[2] & 0xFFFF;
+                bucket.relayOn = slot[2] >> 16;
+                if (!bucket.count) bucket.minLux = 0;
+            }
+            callback(number * info.seconds, bucket, context);
+        }
+    }
+    return count;
+}
+
+bool History::parseResolution(const String& name, HistoryResolution& resolution) {
+    for (uint8_t i = 0; i < HISTORY_LEVELS; i++) {
+        if (name == LEVELS[i].name) {
+            resolution = (HistoryResolution)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* History::getName(HistoryResolution resolution) {
+    return LEVELS[resolution].name;
+}
+
+uint32_t History::getSeconds(HistoryResolution resolution) {
+    return LEVELS[resolution].seconds;
+}
+
+uint16_t History::getCapacity(HistoryResolution resolution) {
+    return LEVELS[resolution].capacity;
+}
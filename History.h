@@ -0,0 +1,58 @@
+// History.h
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+
+// Агрегат показаний за один интервал. min/max в целых lux (разрешение BH1750 - 1 lux),
+// среднее и доля включенного реле считаются из суммы и счетчиков
+struct __attribute__((packed)) HistoryBucket {
+    uint16_t minLux;
+    uint16_t maxLux;
+    float sumLux;
+    uint16_t count;       // 0 - за интервал показаний нет
+    uint16_t relayOn;     // показаний при включенном реле
+};
+
+// Заголовок ответа /api/history?format=bin, за ним count записей HistoryBucket
+struct __attribute__((packed)) HistoryBinaryHeader {
+    uint32_t from;        // начало первого интервала, секунды шкалы истории
+    uint32_t seconds;     // длина интервала
+    uint32_t count;
+};
+
+enum HistoryResolution : uint8_t {
+    HISTORY_MINUTE,       // 1 мин x 24 ч
+    HISTORY_QUARTER,      // 15 мин x 7 дней
+    HISTORY_HOUR,         // 1 ч x 60 дней
+    HISTORY_LEVELS
+};
+
+// История освещенности в RAM на нескольких разрешениях.
+// Каждое показание за O(1) добавляется сразу во все уровни; кольца фиксированного
+// размера, старые интервалы затираются. Шкала времени - секунды работы контроллера
+// с первого запуска: она продолжается после перезагрузки с контрольной точки на LittleFS.
+// Пишет только основной цикл; читать можно из любой задачи без блокировок
+class History {
+public:
+    typedef void (*BucketCallback)(uint32_t start, const HistoryBucket& bucket, void* context);
+
+    static void begin();                        // после LittleFS: загрузить контрольную точку
+    static void add(float lux, bool relayState);
+    static bool checkpoint();
+    static uint32_t now();
+
+    // Обходит интервалы, пересекающие [from, to], от старых к новым; пустые тоже (count = 0).
+    // Возвращает число интервалов
+    static uint32_t read(HistoryResolution resolution, uint32_t from, uint32_t to,
+                         BucketCallback callback, void* context);
+    // Границы ответа read(): начало первого и число интервалов
+    static uint32_t getRange(HistoryResolution resolution, uint32_t& from, uint32_t to);
+
+    static bool parseResolution(const String& name, HistoryResolution& resolution);
+    static const char* getName(HistoryResolution resolution);
+    static uint32_t getSeconds(HistoryResolution resolution);
+    static uint16_t getCapacity(HistoryResolution resolution);
+};
+
+#endif
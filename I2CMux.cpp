@@ -0,0 +1,47 @@
+// I2CMux.cpp
+#include "I2CMux.h"
+#include "Config.h"
+#include <Wire.h>
+
+static bool present = false;
+static int8_t current = -1;      // -1 - неизвестно (после ошибки или сброса)
+static uint32_t selects = 0;
+
+bool I2CMux::begin() {
+    Wire.beginTransmission(I2C_MUX_ADDRESS);
+    present = Wire.endTransmission() == 0;
+    current = -1;
+    return present;
+}
+
+bool I2CMux::isPresent() {
+    return present;
+}
+
+bool I2CMux::select(uint8_t channel) {
+    if (!present || channel >= CHANNELS) return false;
+    if (current == channel) return true;
+    Wire.beginTransmission(I2C_MUX_ADDRESS);
+    Wire.write((uint8_t)(1 << channel));
+    if (Wire.endTransmission() != 0) {
+        current = -1;
+        return false;
+    }
+    current = channel;
+    selects++;
+    return true;
+}
+
+uint8_t I2CMux::detect(uint8_t address) {
+    uint8_t count = 0;
+    for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+        if (!select(channel)) break;
+        Wire.beginTransmission(address);
+        if (Wire.endTransmission() == 0) count = channel + 1;
+    }
+    return count;
+}
+
+uint32_t I2CMux::getSelects() {
+    return selects;
+}
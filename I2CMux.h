@@ -0,0 +1,23 @@
+// I2CMux.h
+#ifndef I2C_MUX_H
+#define I2C_MUX_H
+
+#include <Arduino.h>
+
+// Мультиплексор I2C TCA9548A: одинаковые датчики (BH1750 0x23, VEML7700 0x10) на разных каналах.
+// Канал выбирается записью одного байта-маски; выбранный канал запоминается,
+// повторный выбор того же канала на шину не идет
+class I2CMux {
+public:
+    static const uint8_t CHANNELS = 8;
+
+    // Wire уже запущен; true - мультиплексор ответил на I2C_MUX_ADDRESS
+    static bool begin();
+    static bool isPresent();
+    static bool select(uint8_t channel);
+    // Число зон: последний канал, на котором отвечает address, плюс один
+    static uint8_t detect(uint8_t address);
+    static uint32_t getSelects();        // переключений канала с загрузки
+};
+
+#endif
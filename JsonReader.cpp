@@ -0,0 +1,357 @@
+// JsonReader.cpp
+#include "JsonReader.h"
+#include <math.h>
+#include <stdlib.h>
+
+JsonReader::JsonReader(const char* json, size_t length) : json(json), length(length) {}
+
+JsonToken JsonReader::fail(const char* message) {
+    if (!error) {
+        error = message;
+        errorPosition = pos;
+    }
+    token = JSON_ERROR;
+    return token;
+}
+
+void JsonReader::skipWhitespace() {
+    while (pos < length) {
+        char c = json[pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        pos++;
+    }
+}
+
+void JsonReader::afterValue() {
+    expect = depth == 0 ? EXPECT_DONE : EXPECT_COMMA_OR_END;
+}
+
+JsonToken JsonReader::next() {
+    if (error) return JSON_ERROR;
+
+    for (;;) {
+        skipWhitespace();
+        if (pos >= length) {
+            if (expect == EXPECT_DONE) {
+                token = JSON_END;
+                return token;
+            }
+            return fail("unexpected end of input");
+        }
+        char c = json[pos];
+
+        switch (expect) {
+            case EXPECT_DONE:
+                return fail("unexpected data after JSON value");
+
+            case EXPECT_COLON:
+                if (c != ':') return fail("expected ':'");
+                pos++;
+                expect = EXPECT_VALUE;
+                continue;
+
+            case EXPECT_COMMA_OR_END:
+                if (c == ',') {
+                    pos++;
+                    expect = inObject() ? EXPECT_KEY : EXPECT_VALUE;
+                    continue;
+                }
+                if (c == '}' && inObject()) return closeContainer(true);
+                if (c == ']' && !inObject()) return closeContainer(false);
+                return fail(inObject() ? "expected ',' or '}'" : "expected ',' or ']'");
+
+            case EXPECT_OBJECT_FIRST:
+                if (c == '}') return closeContainer(true);
+                // fallthrough
+            case EXPECT_KEY:
+                if (c != '"') return fail("expected string key");
+                if (parseString(JSON_KEY) == JSON_ERROR) return JSON_ERROR;
+                expect = EXPECT_COLON;
+                return token;
+
+            case EXPECT_ARRAY_FIRST:
+                if (c == ']') return closeContainer(false);
+                // fallthrough
+            case EXPECT_VALUE:
+                return parseValue();
+        }
+    }
+}
+
+JsonToken JsonReader::closeContainer(bool object) {
+    pos++;
+    depth--;
+    afterValue();
+    token = object ? JSON_OBJECT_END : JSON_ARRAY_END;
+    return token;
+}
+
+JsonToken JsonReader::parseValue() {
+    char c = json[pos];
+    rawStart = pos;
+    rawLength = 0;
+
+    if (c == '{' || c == '[') {
+        if (depth >= MAX_DEPTH) return fail("nesting too deep");
+        pos++;
+        bool object = c == '{';
+        if (object) objectBits |= 1UL << depth;
+        else objectBits &= ~(1UL << depth);
+        depth++;
+        expect = object ? EXPECT_OBJECT_FIRST : EXPECT_ARRAY_FIRST;
+        token = object ? JSON_OBJECT_START : JSON_ARRAY_START;
+        return token;
+    }
+
+    JsonToken result;
+    if (c == '"') result = parseString(JSON_STRING);
+    else if (c == '-' || (c >= '0' && c <= '9')) result = parseNumber();
+    else if (c == 't') result = parseLiteral("true", JSON_TRUE);
+    else if (c == 'f') result = parseLiteral("false", JSON_FALSE);
+    else if (c == 'n') result = parseLiteral("null", JSON_NULL);
+    else return fail("unexpected character");
+
+    if (result != JSON_ERROR) afterValue();
+    return result;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+JsonToken JsonReader::parseString(JsonToken kind) {
+    pos++;   // открывающая кавычка
+    size_t start = pos;
+    rawEscaped = false;
+
+    while (pos < length) {
+        uint8_t c = (uint8_t)json[pos];
+        if (c == '"') {
+            rawStart = start;
+            rawLength = pos - start;
+            pos++;
+            token = kind;
+            return token;
+        }
+        if (c < 0x20) return fail("control character in string");
+        if (c != '\\') {
+            pos++;
+            continue;
+        }
+
+        rawEscaped = true;
+        if (pos + 1 >= length) break;
+        char e = json[pos + 1];
+        if (e == 'u') {
+            for (size_t i = 2; i < 6; i++) {
+                if (pos + i >= length) return fail("unterminated string");
+                if (hexValue(json[pos + i]) < 0) {
+                    pos += i;
+                    return fail("invalid \\u escape");
+                }
+            }
+            pos += 6;
+        } else if (e == '"' || e == '\\' || e == '/' || e == 'b' || e == 'f' ||
+                   e == 'n' || e == 'r' || e == 't') {
+            pos += 2;
+        } else {
+            pos++;
+            return fail("invalid escape");
+        }
+    }
+    return fail("unterminated string");
+}
+
+JsonToken JsonReader::parseNumber() {
+    size_t start = pos;
+    if (json[pos] == '-') pos++;
+
+    // Целая часть: 0 или цифры без ведущего нуля
+    if (pos < length && json[pos] == '0') {
+        pos++;
+    } else if (pos < length && json[pos] >= '1' && json[pos] <= '9') {
+        while (pos < length && json[pos] >= '0' && json[pos] <= '9') pos++;
+    } else {
+        return fail("invalid number");
+    }
+
+    if (pos < length && json[pos] == '.') {
+        pos++;
+        if (pos >= length || json[pos] < '0' || json[pos] > '9') return fail("invalid number");
+        while (pos < length && json[pos] >= '0' && json[pos] <= '9') pos++;
+    }
+
+    if (pos < length && (json[pos] == 'e' || json[pos] == 'E')) {
+        pos++;
+        if (pos < length && (json[pos] == '+' || json[pos] == '-')) pos++;
+        if (pos >= length || json[pos] < '0' || json[pos] > '9') return fail("invalid number");
+        while (pos < length && json[pos] >= '0' && json[pos] <= '9') pos++;
+    }
+
+    rawStart = start;
+    rawLength = pos - start;
+    token = JSON_NUMBER;
+    return token;
+}
+
+JsonToken JsonReader::parseLiteral(const char* word, JsonToken kind) {
+    size_t n = strlen(word);
+    if (pos + n > length || memcmp(json + pos, word, n) != 0) return fail("invalid literal");
+    rawStart = pos;
+    rawLength = n;
+    pos += n;
+    token = kind;
+    return token;
+}
+
+size_t JsonReader::decode(char* out, size_t size, bool& fits) const {
+    const char* s = json + rawStart;
+    size_t n = 0;
+    fits = true;
+
+    for (size_t i = 0; i < rawLength; i++) {
+        char buf[4];
+        size_t len = 1;
+        buf[0] = s[i];
+
+        if (s[i] == '\\') {
+            char e = s[++i];
+            switch (e) {
+                case 'b': buf[0] = '\b'; break;
+                case 'f': buf[0] = '\f'; break;
+                case 'n': buf[0] = '\n'; break;
+                case 'r': buf[0] = '\r'; break;
+                case 't': buf[0] = '\t'; break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    for (int k = 1; k <= 4; k++) cp = (cp << 4) | hexValue(s[i + k]);
+                    i += 4;
+                    // Суррогатная пара 🌱 -> один 4-байтовый символ
+                    if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < rawLength &&
+                        s[i + 1] == '\\' && s[i + 2] == 'u') {
+                        uint32_t low = 0;
+                        for (int k = 3; k <= 6; k++) low = (low << 4) | hexValue(s[i + k]);
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    // NUL оборвал бы C-строку, одиночный суррогат - не UTF-8
+                    if (cp == 0 || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                        fits = false;
+                        if (out) out[n] = '\0';
+                        return n;
+                    }
+                    if (cp < 0x80) {
+                        buf[0] = (char)cp;
+                    } else if (cp < 0x800) {
+                        buf[0] = (char)(0xC0 | (cp >> 6));
+                        buf[1] = (char)(0x80 | (cp & 0x3F));
+                        len = 2;
+                    } else if (cp < 0x10000) {
+                        buf[0] = (char)(0xE0 | (cp >> 12));
+                        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        buf[2] = (char)(0x80 | (cp & 0x3F));
+                        len = 3;
+                    } else {
+                        buf[0] = (char)(0xF0 | (cp >> 18));
+                        buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+                        buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        buf[3] = (char)(0x80 | (cp & 0x3F));
+                        len = 4;
+                    }
+                    break;
+                }
+                default: buf[0] = e; break;   // " \ /
+            }
+        }
+
+        if (out) {
+            if (n + len >= size) {
+                fits = false;
+                out[n] = '\0';
+                return n;
+            }
+            memcpy(out + n, buf, len);
+        }
+        n += len;
+    }
+    if (out) out[n] = '\0';
+    return n;
+}
+
+bool JsonReader::keyIs(const char* name) const {
+    if (token != JSON_KEY && token != JSON_STRING) return false;
+    size_t nameLength = strlen(name);
+    if (!rawEscaped) {
+        return rawLength == nameLength && memcmp(json + rawStart, name, nameLength) == 0;
+    }
+    char decoded[64];
+    bool fits;
+    size_t n = decode(decoded, sizeof(decoded), fits);
+    return fits && n == nameLength && memcmp(decoded, name, nameLength) == 0;
+}
+
+bool JsonReader::copyString(char* out, size_t size) const {
+    if ((token != JSON_KEY && token != JSON_STRING) || size == 0) return false;
+    bool fits;
+    decode(out, size, fits);
+    return fits;
+}
+
+bool JsonReader::getFloat(float& out) const {
+    if (token != JSON_NUMBER) return false;
+    char text[32];
+    if (rawLength >= sizeof(text)) return false;
+    memcpy(text, json + rawStart, rawLength);
+    text[rawLength] = '\0';
+    char* end;
+    float v = strtof(text, &end);
+    if (end != text + rawLength || isinf(v)) return false;
+    out = v;
+    return true;
+}
+
+bool JsonReader::getUint32(uint32_t& out) const {
+    if (token != JSON_NUMBER || rawLength == 0) return false;
+    uint64_t v = 0;
+    for (size_t i = 0; i < rawLength; i++) {
+        char c = json[rawStart + i];
+        if (c < '0' || c > '9') return false;   // знак, дробь, экспонента
+        v = v * 10 + (c - '0');
+        if (v > 0xFFFFFFFFULL) return false;
+    }
+    out = (uint32_t)v;
+    return true;
+}
+
+bool JsonReader::getInt32(int32_t& out) const {
+    if (token != JSON_NUMBER || rawLength == 0) return false;
+    bool negative = json[rawStart] == '-';
+    int64_t v = 0;
+    for (size_t i = negative ? 1 : 0; i < rawLength; i++) {
+        char c = json[rawStart + i];
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+        if (v > 0x80000000LL) return false;
+    }
+    if (negative) v = -v;
+    if (v > 0x7FFFFFFFLL) return false;
+    out = (int32_t)v;
+    return true;
+}
+
+bool JsonReader::skipValue() {
+    JsonToken t = next();
+    if (t != JSON_OBJECT_START && t != JSON_ARRAY_START) return t != JSON_ERROR && t != JSON_END;
+
+    uint8_t target = depth - 1;
+    while (depth > target) {
+        t = next();
+        if (t == JSON_ERROR || t == JSON_END) return false;
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+// JsonReader.h
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <Arduino.h>
+
+enum JsonToken : uint8_t {
+    JSON_END,            // документ закончился
+    JSON_ERROR,          // см. getError() / getErrorPosition()
+    JSON_OBJECT_START,
+    JSON_OBJECT_END,
+    JSON_ARRAY_START,
+    JSON_ARRAY_END,
+    JSON_KEY,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL
+};
+
+// Потоковый (pull) разбор JSON по RFC 8259 без кучи: next() возвращает следующий токен,
+// строки и числа остаются ссылками на исходный текст. Грамматика проверяется полностью,
+// при ошибке запоминается сообщение и позиция
+class JsonReader {
+public:
+    static const uint8_t MAX_DEPTH = 16;
+
+    JsonReader(const char* json, size_t length);
+
+    JsonToken next();
+    JsonToken getToken() const { return token; }
+    uint8_t getDepth() const { return depth; }
+
+    // Текст текущего KEY/STRING (без кавычек, escape-последовательности не раскрыты) или NUMBER
+    const char* getRaw() const { return json + rawStart; }
+    size_t getRawLength() const { return rawLength; }
+    size_t getPosition() const { return rawStart; }
+
+    bool keyIs(const char* name) const;                 // сравнение KEY/STRING с раскрытием escape
+    // false - не помещается или содержит \u0000/одиночный суррогат; out все равно C-строка
+    bool copyString(char* out, size_t size) const;
+    bool getFloat(float& out) const;
+    bool getUint32(uint32_t& out) const;                // только целые без знака, без переполнения
+    bool getInt32(int32_t& out) const;                  // целые со знаком
+    bool skipValue();                                   // пропустить значение после KEY целиком
+
+    const char* getError() const { return error; }
+    size_t getErrorPosition() const { return errorPosition; }
+
+private:
+    enum Expect : uint8_t {
+        EXPECT_VALUE,
+        EXPECT_OBJECT_FIRST,    // ключ или '}'
+        EXPECT_ARRAY_FIRST,     // значение или ']'
+        EXPECT_KEY,
+        EXPECT_COLON,
+        EXPECT_COMMA_OR_END,
+        EXPECT_DONE
+    };
+
+    JsonToken fail(const char* message);
+    JsonToken parseValue();
+    JsonToken parseString(JsonToken kind);
+    JsonToken parseNumber();
+    JsonToken parseLiteral(const char* word, JsonToken kind);
+    JsonToken closeContainer(bool object);
+    void afterValue();
+    void skipWhitespace();
+    bool inObject() const { return depth > 0 && (objectBits & (1UL << (depth - 1))); }
+    // Раскрывает escape-последовательности; out == nullptr - только подсчет длины.
+    // fits = false - не поместилось или строку нельзя отдать как C-строку UTF-8
+    size_t decode(char* out, size_t size, bool& fits) const;
+
+    const char* json;
+    size_t length;
+    size_t pos = 0;
+    size_t rawStart = 0;
+    size_t rawLength = 0;
+    bool rawEscaped = false;
+
+    JsonToken token = JSON_END;
+    Expect expect = EXPECT_VALUE;
+    uint8_t depth = 0;
+    uint32_t objectBits = 0;   // бит на уровень: 1 - объект, 0 - массив
+
+    const char* error = nullptr;
+    size_t errorPosition = 0;
+};
+
+#endif
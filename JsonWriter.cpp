@@ -0,0 +1,225 @@
+// JsonWriter.cpp
+#include "JsonWriter.h"
+#include <math.h>
+
+JsonWriter::JsonWriter(char* buffer, size_t size, FlushCallback flush, void* context)
+    : buffer(buffer), size(size), flushCallback(flush), flushContext(context) {}
+
+void JsonWriter::put(char c) {
+    if (used >= size) {
+        if (flushCallback && used > 0) {
+            flush();
+        } else {
+            overflowed = true;
+            return;
+        }
+    }
+    buffer[used++] = c;
+}
+
+void JsonWriter::write(const char* data, size_t length) {
+    while (length > 0) {
+        if (used >= size) {
+            if (!flushCallback) {
+                overflowed = true;
+                return;
+            }
+            flush();
+        }
+        size_t chunk = size - used < length ? size - used : length;
+        memcpy(buffer + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void JsonWriter::flush() {
+    if (flushCallback && used > 0) {
+        flushCallback(buffer, used, flushContext);
+        used = 0;
+    }
+}
+
+const char* JsonWriter::c_str() {
+    // Завершающий ноль на месте последнего байта при переполнении
+    if (used < size) buffer[used] = '\0';
+    else if (size > 0) {
+        buffer[size - 1] = '\0';
+        overflowed = true;
+    }
+    return buffer;
+}
+
+// Запятая перед элементом массива или ключом, кроме первого на уровне
+void JsonWriter::separator() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth == 0) return;
+    uint32_t bit = 1UL << (depth - 1);
+    if (hasItems & bit) put(',');
+    hasItems |= bit;
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separator();
+    put('{');
+    if (depth < MAX_DEPTH) {
+        depth++;
+        hasItems &= ~(1UL << (depth - 1));
+    } else {
+        overflowed = true;
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    if (depth > 0) depth--;
+    put('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separator();
+    put('[');
+    if (depth < MAX_DEPTH) {
+        depth++;
+        hasItems &= ~(1UL << (depth - 1));
+    } else {
+        overflowed = true;
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    if (depth > 0) depth--;
+    put(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name) {
+    separator();
+    put('"');
+    writeEscaped(name, strlen(name));
+    put('"');
+    put(':');
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+    separator();
+    if (v) write("true", 4);
+    else write("false", 5);
+    return *this;
+}
+
+// Целые печатаются без snprintf: это самая частая операция ответов API
+void JsonWriter::writeUnsigned(unsigned long long v, uint8_t minDigits) {
+    char text[24];
+    size_t n = 0;
+    do {
+        text[sizeof(text) - 1 - n++] = '0' + v % 10;
+        v /= 10;
+    } while (v > 0 || n < minDigits);
+    write(text + sizeof(text) - n, n);
+}
+
+JsonWriter& JsonWriter::value(long long v) {
+    separator();
+    if (v < 0) {
+        put('-');
+        writeUnsigned(0ULL - (unsigned long long)v);
+    } else {
+        writeUnsigned(v);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long v) {
+    separator();
+    writeUnsigned(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(float v, uint8_t decimals) {
+    separator();
+    if (isnan(v) || isinf(v)) {
+        write("null", 4);
+        return *this;
+    }
+    
+    // Обычные показания: фиксированная точка в целых, как "%.*f"
+    static const uint32_t SCALE[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    double magnitude = fabs((double)v);
+    if (decimals < sizeof(SCALE) / sizeof(SCALE[0]) && magnitude < 1e9) {
+        unsigned long long scaled = (unsigned long long)(magnitude * SCALE[decimals] + 0.5);
+        if (v < 0 && scaled > 0) put('-');
+        writeUnsigned(scaled / SCALE[decimals]);
+        if (decimals > 0) {
+            put('.');
+            writeUnsigned(scaled % SCALE[decimals], decimals);
+        }
+        return *this;
+    }
+    
+    char text[48];
+    int n = snprintf(text, sizeof(text), "%.*f", (int)decimals, (double)v);
+    if (n < 0 || n >= (int)sizeof(text)) {
+        write("null", 4);
+        return *this;
+    }
+    write(text, n);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* s) {
+    return value(s, s ? strlen(s) : 0);
+}
+
+JsonWriter& JsonWriter::value(const char* s, size_t length) {
+    separator();
+    put('"');
+    if (s) writeEscaped(s, length);
+    put('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separator();
+    write("null", 4);
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(const char* json) {
+    separator();
+    write(json, strlen(json));
+    return *this;
+}
+
+void JsonWriter::writeEscaped(const char* s, size_t length) {
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        
+        // Неэкранируемые участки копируются целиком
+        write(s + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"':  write("\\\"", 2); break;
+            case '\\': write("\\\\", 2); break;
+            case '\n': write("\\n", 2); break;
+            case '\r': write("\\r", 2); break;
+            case '\t': write("\\t", 2); break;
+            default: {
+                char esc[7];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                write(esc, 6);
+            }
+        }
+    }
+    write(s + start, length - start);
+}
@@ -0,0 +1,70 @@
+// JsonWriter.h
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+// Запись JSON в буфер фиксированного размера, без кучи.
+// Запятые и кавычки расставляются сами. При заполнении буфер отдается
+// в flush-callback (например, чанком в WebServer); без callback лишнее
+// отбрасывается, а overflow() возвращает true
+class JsonWriter {
+public:
+    typedef void (*FlushCallback)(const char* data, size_t length, void* context);
+
+    static const uint8_t MAX_DEPTH = 16;
+
+    JsonWriter(char* buffer, size_t size, FlushCallback flush = nullptr, void* context = nullptr);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(bool v);
+    // Целые по фундаментальным типам: uint32_t на ESP32 и на хосте - разные typedef
+    JsonWriter& value(int v) { return value((long long)v); }
+    JsonWriter& value(unsigned int v) { return value((unsigned long long)v); }
+    JsonWriter& value(long v) { return value((long long)v); }
+    JsonWriter& value(unsigned long v) { return value((unsigned long long)v); }
+    JsonWriter& value(long long v);
+    JsonWriter& value(unsigned long long v);
+    JsonWriter& value(float v, uint8_t decimals = 2);   // NaN и бесконечность -> null
+    JsonWriter& value(const char* s);                   // строка с экранированием
+    JsonWriter& value(const char* s, size_t length);
+    JsonWriter& value(const String& s) { return value(s.c_str(), s.length()); }
+    JsonWriter& null();
+    // Готовый фрагмент JSON без проверки и экранирования
+    JsonWriter& raw(const char* json);
+
+    // Сокращения для полей объекта
+    template<typename T>
+    JsonWriter& field(const char* name, const T& v) { return key(name).value(v); }
+    JsonWriter& field(const char* name, float v, uint8_t decimals) { return key(name).value(v, decimals); }
+
+    void flush();                  // отдать накопленное в callback
+    const char* c_str();           // только без callback: весь документ в буфере
+    size_t length() const { return used; }
+    bool overflow() const { return overflowed; }
+
+private:
+    void separator();
+    void put(char c);
+    void write(const char* data, size_t length);
+    void writeUnsigned(unsigned long long v, uint8_t minDigits = 1);
+    void writeEscaped(const char* s, size_t length);
+
+    char* buffer;
+    size_t size;
+    size_t used = 0;
+    FlushCallback flushCallback;
+    void* flushContext;
+    bool overflowed = false;
+
+    uint8_t depth = 0;
+    uint32_t hasItems = 0;         // бит на уровень: нужен разделитель перед следующим элементом
+    bool afterKey = false;
+};
+
+#endif
@@ -0,0 +1,26 @@
+// LampDimmer.cpp
+#include "LampDimmer.h"
+#include "DebugLogger.h"
+
+LampDimmer::LampDimmer(uint8_t pin, uint8_t channel) : pin(pin), channel(channel) {}
+
+void LampDimmer::begin() {
+    ledcSetup(channel, DIM_PWM_FREQUENCY, DIM_PWM_BITS);
+    ledcAttachPin(pin, channel);
+    ledcWrite(channel, 0);
+    duty = 0;
+    target = 0;
+    DEBUG_LOGF(LOG_MODULE_RELAY, "✅ Диммер на пине %u: LEDC канал %u, %lu Гц, %u бит",
+               pin, channel, (unsigned long)DIM_PWM_FREQUENCY, DIM_PWM_BITS);
+}
+
+void LampDimmer::setTarget(uint16_t value) {
+    target = value > DIM_DUTY_MAX ? DIM_DUTY_MAX : value;
+}
+
+void LampDimmer::tick() {
+    if (duty == target) return;
+    if (target > duty) duty = target - duty > RAMP_STEP ? duty + RAMP_STEP : target;
+    else duty = duty - target > RAMP_STEP ? duty - RAMP_STEP : target;
+    ledcWrite(channel, duty);
+}
@@ -0,0 +1,30 @@
+// LampDimmer.h
+#ifndef LAMP_DIMMER_H
+#define LAMP_DIMMER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// ШИМ-вход диммируемого драйвера лампы на канале LEDC. Реле остается выключателем
+// питания драйвера, диммер задает яркость. Скважность идет к цели не быстрее
+// DIM_RAMP_TIME на полную шкалу: без бросков тока и скачков света
+class LampDimmer {
+public:
+    static const uint16_t RAMP_STEP = (uint32_t)DIM_DUTY_MAX * DIM_CONTROL_INTERVAL / DIM_RAMP_TIME;
+
+    LampDimmer(uint8_t pin, uint8_t channel);
+    void begin();
+    void setTarget(uint16_t duty);       // 0..DIM_DUTY_MAX
+    void tick();                         // раз в DIM_CONTROL_INTERVAL: один шаг к цели
+    uint16_t getDuty() const { return duty; }
+    uint16_t getTarget() const { return target; }
+    float getDutyPercent() const { return duty * 100.0f / DIM_DUTY_MAX; }
+
+private:
+    uint8_t pin;
+    uint8_t channel;
+    uint16_t duty = 0;
+    uint16_t target = 0;
+};
+
+#endif
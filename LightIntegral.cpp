@@ -0,0 +1,119 @@
+// LightIntegral.cpp
+#include "LightIntegral.h"
+#include "AtomicFile.h"
+#include "Clock.h"
+#include <LittleFS.h>
+
+LightIntegral lightIntegral;
+
+static const uint32_t FILE_MAGIC = 0x494C4450;   // "PDLI"
+static const uint16_t FILE_VERSION = 1;
+static const char* FILE_PATH = "/dli.bin";
+static const char* TEMP_PATH = "/dli.tmp";
+static const uint32_t SECONDS_PER_DAY = 86400;
+
+struct __attribute__((packed)) FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t day;
+    float today;
+    float yesterday;
+};
+
+// Сохраненные сутки восстанавливаются как есть; если за время выключения
+// наступили новые, их сменит первое измерение после установки часов
+void LightIntegral::begin() {
+    File file = LittleFS.open(FILE_PATH, "r");
+    if (!file) return;
+    FileHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == FILE_MAGIC && header.version == FILE_VERSION &&
+                 header.today >= 0;
+    file.close();
+    if (!valid) return;
+
+    today = header.today;
+    stats.today = header.today;
+    stats.yesterday = header.yesterday;
+    stats.day = header.day;
+    Serial.println("🌞 DLI восстановлен: " + String(header.today, 2) + " mol/m², сутки " + String(header.day));
+}
+
+uint32_t LightIntegral::currentDay(const Settings& settings) const {
+    uint32_t utc = Clock::now();
+    if (!utc) return 0;
+    return (utc + settings.timezoneOffset * 60 - settings.dayStart * 60) / SECONDS_PER_DAY;
+}
+
+// Итог уходит во вчерашний, только если новые сутки идут сразу за ним
+void LightIntegral::rollover(uint32_t day, uint32_t now) {
+    bool consecutive = day == 0 || stats.day == 0 || day == stats.day + 1;
+    stats.yesterday = consecutive ? (float)today : -1.0f;
+    today = 0.0;
+    stats.today = 0.0;
+    stats.day = day;
+    dayStartedAt = now;
+}
+
+void LightIntegral::addSample(float lux, bool relayState, const Settings& settings, uint32_t now) {
+    uint32_t day = currentDay(settings);
+    if (day != 0 && stats.day == 0) {
+        stats.day = day;   // часы установлены: накопленное относится к текущим суткам
+    } else if (day != 0 && day != stats.day) {
+        rollover(day, now);
+    } else if (day == 0 && now - dayStartedAt >= SECONDS_PER_DAY * 1000UL) {
+        rollover(0, now);
+    }
+
+    float ppfd = (lux > 0 ? lux : 0) * settings.luxToPpfd;
+    float natural = ppfd - (relayState ? settings.lampPpfd : 0);
+    if (natural < 0) natural = 0;
+    // Разрыв в измерениях не интегрируется: неизвестный свет не засчитывается
+    if (hasLast && now - lastSampleAt <= settings.sampleMaxAge) {
+        uint32_t dt = now - lastSampleAt;
+        today += (lastPpfd + ppfd) / 2 * (dt / 1000.0) / 1e6;
+        stats.today = (float)today;
+        // Облако на минуту не должно менять прогноз на часы вперед
+        stats.natural += (natural - stats.natural) * dt / (DLI_NATURAL_TAU + dt);
+    } else {
+        stats.natural = natural;
+    }
+    lastPpfd = ppfd;
+    lastSampleAt = now;
+    hasLast = true;
+    stats.ppfd = ppfd;
+}
+
+bool LightIntegral::isLampNeeded(bool relayState, const Schedule& schedule, const Settings& settings) {
+    // Минуты фотопериода до границы суток; граница может быть после полуночи
+    uint16_t remaining = 0;
+    LocalTime local;
+    if (Clock::getLocal(settings.timezoneOffset, local)) {
+        uint16_t boundary = settings.dayStart;
+        if (local.minute < boundary) {
+            remaining = schedule.countActive(local.weekday, local.minute, boundary);
+        } else {
+            remaining = schedule.countActive(local.weekday, local.minute, Schedule::MINUTES_PER_DAY) +
+                        schedule.countActive((local.weekday + 1) % 7, 0, boundary);
+        }
+    }
+
+    stats.remainingMinutes = remaining;
+    stats.projected = (float)(today + stats.natural * (remaining * 60.0) / 2 / 1e6);
+    // Облака качают прогноз около цели: включение требует запаса
+    float onBelow = relayState ? settings.dliTarget : settings.dliTarget * (1 - DLI_HYSTERESIS_RATIO);
+    stats.lampNeeded = stats.projected < onBelow;
+    return stats.lampNeeded;
+}
+
+bool LightIntegral::save() {
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.reserved = 0;
+    header.day = stats.day;
+    header.today = (float)today;
+    header.yesterday = stats.yesterday;
+    return AtomicFile::write(FILE_PATH, TEMP_PATH, &header, sizeof(header));
+}
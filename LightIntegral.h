@@ -0,0 +1,50 @@
+// LightIntegral.h
+#ifndef LIGHT_INTEGRAL_H
+#define LIGHT_INTEGRAL_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+struct DliStats {
+    float today = 0.0;           // mol/m² с начала суток
+    float yesterday = -1.0;      // итог прошлых суток, -1 - нет
+    float ppfd = 0.0;            // последнее измерение, µmol/m²/s
+    float natural = 0.0;         // PPFD без лампы, среднее за ~DLI_NATURAL_TAU
+    float projected = 0.0;       // прогноз на конец суток без лампы
+    uint16_t remainingMinutes = 0;   // фотопериода до границы суток
+    bool lampNeeded = false;
+    uint32_t day = 0;            // номер суток с учетом dayStart, 0 - часы не заданы
+};
+
+// Дневной интеграл света (DLI). Каждое измерение добавляет PPFD x dt (трапеция),
+// lux переводится в PPFD множителем luxToPpfd - работа на измерение постоянная.
+// Сутки начинаются в dayStart минут местного времени; пока часы не заданы,
+// сутки сменяются через 24 ч работы. Датчик должен видеть лампу: ее вклад
+// lampPpfd вычитается только для прогноза естественного света.
+// Итог переживает перезагрузку: маленький файл пишется вместе с историей
+class LightIntegral {
+public:
+    void begin();                // после LittleFS
+    void addSample(float lux, bool relayState, const Settings& settings, uint32_t now);
+    // Режим dliMode: нужна ли лампа, чтобы к концу суток набрать dliTarget.
+    // Остаток естественного света - средний PPFD без лампы, линейно спадающий
+    // до нуля за оставшиеся минуты фотопериода
+    bool isLampNeeded(bool relayState, const Schedule& schedule, const Settings& settings);
+    bool save();
+    const DliStats& getStats() const { return stats; }
+
+private:
+    uint32_t currentDay(const Settings& settings) const;
+    void rollover(uint32_t day, uint32_t now);
+
+    double today = 0.0;          // накопление в double: за сутки ~10^5 малых слагаемых
+    float lastPpfd = 0.0;
+    uint32_t lastSampleAt = 0;
+    uint32_t dayStartedAt = 0;   // millis() начала суток, пока часы не заданы
+    bool hasLast = false;
+    DliStats stats;
+};
+
+extern LightIntegral lightIntegral;
+
+#endif
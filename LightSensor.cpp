@@ -2,21 +2,23 @@
 #include "LightSensor.h"
 #include "Config.h"
 #include "DebugLogger.h"
+#include "EventTrace.h"
+#include "I2CMux.h"
+#include "Metrics.h"
 
 bool LightSensor::begin() {
-    Serial.println("🔧 Инициализация GY-30...");  
+    Serial.println("🔧 Инициализация датчика освещенности...");
     // Полный сброс I2C
     Wire.end();
     delay(100);
     
     // Пробуем разные скорости I2C: 100kHz, 50kHz, 400kHz
     long speeds[] = {100000, 50000, 400000};
-    byte addresses[] = {0x23, 0x5C}; // Оба возможных адреса BH1750
-    
     for (long speed : speeds) {
         Serial.println("🔄 Попытка на скорости: " + String(speed) + " Hz");
         
         Wire.begin(I2C_SDA, I2C_SCL, speed);
+        busClock = speed;
         delay(100);
         
         // Сканирование всех адресов для диагностики
@@ -33,36 +35,14 @@ bool LightSensor::begin() {
         if (!foundAny) Serial.print("нет устройств");
         Serial.println();
         
-        // Попытка подключения к BH1750
-        for (byte addr : addresses) {
-            Serial.print("  Адрес 0x" + String(addr, HEX) + ": ");
-            
-            Wire.beginTransmission(addr);
-            byte error = Wire.endTransmission();
-            
-            if (error == 0) {
-                Serial.print("отвечает -> ");
-                
-                if (lightMeter.begin(BH1750::CONTINUOUS_HIGH_RES_MODE, addr)) {
-                    Serial.println("ПОДКЛЮЧЕН!");
-                    sensorFound = true;
-                    simulationMode = false;
-                    
-                    // Тестовое чтение
-                    float testLux = lightMeter.readLightLevel();
-                    Serial.println("✅ Тестовое чтение: " + String(testLux, 2) + " lux");
-                    
-                    return true;
-                } else {
-                    Serial.println("ошибка инициализации");
-                }
-            } else if (error == 2) {
-                Serial.println("NACK ошибка");
-            } else if (error == 4) {
-                Serial.println("ошибка передачи");
-            } else {
-                Serial.println("код ошибки: " + String(error));
-            }
+        if (probe(true)) {
+            simulationMode = false;
+            // Тестовое чтение первого преобразования
+            driver->waitReady();
+            float testLux = driver->read();
+            measuring = false;
+            Serial.println("✅ Тестовое чтение: " + String(testLux, 2) + " lux");
+            return true;
         }
         
         Wire.end();
@@ -70,7 +50,7 @@ bool LightSensor::begin() {
     }
     
     // Если ничего не сработало - диагностика
-    Serial.println("❌ GY-30 не найден после всех попыток");
+    Serial.println("❌ Датчик освещенности не найден после всех попыток");
     Serial.println("🔧 Диагностика:");
     Serial.println("   - Проверь питание 3.3V на датчике");
     Serial.println("   - Проверь подключение ADDR к GND"); 
@@ -83,54 +63,299 @@ bool LightSensor::begin() {
     return false;
 }
 
-float LightSensor::getLux() {
+bool LightSensor::beginAt(uint8_t address, uint32_t clock) {
+    Wire.begin(I2C_SDA, I2C_SCL, clock);
+    busClock = clock;
+    if (!probeAddress(address, false)) {
+        Wire.end();
+        return false;
+    }
+    simulationMode = false;
+    measuring = false;     // первое преобразование запустит задача sensor сразу после setup()
+    Serial.println("⚡ " + String(driver->getName()) + " на 0x" + String(address, HEX) + ", " +
+                   String(clock) + " Hz - прошлая конфигурация");
+    return true;
+}
+
+bool LightSensor::beginOnMux(uint8_t channel) {
+    muxChannel = channel;
+    simulationMode = false;
+    probe(false);
+    measuring = false;
+    // Датчик зоны могли не подключить или он не ответил с первого раза - ищем его как потерянный
+    if (!sensorFound) health.markLost(millis());
+    Serial.println("🔍 Канал " + String(channel) + ": " +
+                   (sensorFound ? String(driver->getName()) + " подключен" : String("датчик не найден")));
+    return sensorFound;
+}
+
+// Кандидаты по порядку: VEML7700 на своем единственном адресе, BH1750 на обоих
+static const uint8_t PROBE_ADDRESSES[] = {
+    Veml7700Driver::ADDRESS, Bh1750Driver::ADDRESS_LOW, Bh1750Driver::ADDRESS_HIGH
+};
+
+bool LightSensor::probe(bool verbose) {
+    for (uint8_t addr : PROBE_ADDRESSES) {
+        if (probeAddress(addr, verbose)) return true;
+    }
+    return false;
+}
+
+bool LightSensor::probeAddress(uint8_t addr, bool verbose) {
+    sensorFound = false;
+    if (!selectChannel()) return false;
+    LuxDriver* candidate = addr == Veml7700Driver::ADDRESS ? (LuxDriver*)&veml7700 : (LuxDriver*)&bh1750;
+    Wire.beginTransmission(addr);
+    byte error = Wire.endTransmission();
+    if (verbose) {
+        Serial.print("  " + String(candidate->getName()) + " 0x" + String(addr, HEX) + ": ");
+        if (error == 2) Serial.println("NACK ошибка");
+        else if (error == 4) Serial.println("ошибка передачи");
+        else if (error != 0) Serial.println("код ошибки: " + String(error));
+    }
+    if (error != 0) return false;
+    if (!candidate->begin(addr)) {
+        if (verbose) Serial.println("отвечает -> ошибка инициализации");
+        return false;
+    }
+    if (verbose) Serial.println("отвечает -> ПОДКЛЮЧЕН!");
+    driver = candidate;
+    sensorFound = true;
+    // BH1750 уже считает первое преобразование, VEML7700 интегрирует непрерывно
+    measuring = true;
+    measureStartedAt = millis();
+    driver->start();
+    return true;
+}
+
+bool LightSensor::selectChannel() {
+    return muxChannel < 0 || I2CMux::select(muxChannel);
+}
+
+uint16_t LightSensor::traceArg(uint16_t arg) const {
+    return muxChannel < 0 ? arg : arg | muxChannel << 8;
+}
+
+uint32_t LightSensor::startMeasurement() {
     if (simulationMode) {
-        if (millis() - lastRead > 5000) {
-            simulatedLux += random(-100, 100);
-            if (simulatedLux < 0) simulatedLux = 100;
-            if (simulatedLux > 2000) simulatedLux = 1500;
-            lastRead = millis();
-        }
-        DEBUG_LOG("🔆 СИМУЛЯЦИЯ: " + String(simulatedLux, 2) + " lux");
-        return simulatedLux;
+        storeSample(readSimulated());
+        return 0;
     }
     
+    // Потерянный датчик ищет recover(), здесь на шину не ходим
     if (!sensorFound) {
-        static unsigned long lastRetry = 0;
-        if (millis() - lastRetry > 10000) {
-            lastRetry = millis();
-            DEBUG_LOG("🔄 Попытка переподключения GY-30...");
-            Wire.begin(I2C_SDA, I2C_SCL);
-            delay(100);
-            if (lightMeter.begin(BH1750::CONTINUOUS_HIGH_RES_MODE)) {
-                sensorFound = true;
-                DEBUG_LOG("✅ GY-30 переподключен");
-            }
+        return 0;
+    }
+    
+    // Предыдущее измерение так и не забрали - считаем его потерянным
+    if (measuring && millis() - measureStartedAt < 2 * driver->getRangeInfo().conversionMs) {
+        return 0;
+    }
+    
+    uint32_t conversionMs = selectChannel() ? driver->start() : 0;
+    if (conversionMs == 0) {
+        reportFailure(TRACE_SENSOR_START);
+        return 0;
+    }
+    measuring = true;
+    measureStartedAt = millis();
+    return conversionMs;
+}
+
+bool LightSensor::collectMeasurement() {
+    if (!measuring || !driver->ready()) {
+        return false;
+    }
+    measuring = false;
+    
+    uint32_t readStarted = Metrics::start();
+    float lux = selectChannel() ? driver->read() : -1.0f;
+    Metrics::record(METRIC_I2C_READ, readStarted);
+    if (lux < 0) {
+        reportFailure(TRACE_SENSOR_READ);
+        return false;
+    }
+    // Канал уже выбран: диапазон для следующего преобразования ставится сразу
+    if (driver->adjustRange(lux)) {
+        EventTrace::recordFloat(TRACE_SENSOR_RANGE, traceArg(driver->getRange()), lux);
+        DEBUG_LOGF(LOG_MODULE_SENSOR, "🔭 %s: диапазон %s при %.1f lux, опрос раз в %lu мс",
+                   driver->getName(), driver->getRangeInfo().name, lux,
+                   (unsigned long)driver->getRangeInfo().samplePeriodMs);
+    }
+    // Успешные чтения идут до десяти раз в секунду - в трассировку только восстановление
+    uint32_t now = millis();
+    bool wasLost = health.isLost();
+    uint32_t lostMs = health.getLostMs(now);
+    if (health.onSuccess(now)) {
+        EventTrace::recordFloat(TRACE_SENSOR_OK, traceArg(0), lux);
+        EventTrace::record(TRACE_SENSOR_HEALTH, traceArg(SENSOR_HEALTHY), lostMs);
+        if (wasLost) {
+            EVENT_LOGF(LOG_MODULE_SENSOR, "✅ Датчик зоны %u восстановлен через %lu мс",
+                       muxChannel < 0 ? 0 : muxChannel, (unsigned long)lostMs);
         }
-        return -1.0;
     }
+    storeSample(lux);
+    return true;
+}
+
+// Ошибка запуска или чтения. Кэш остается: снимок действителен еще sampleMaxAge,
+// дальше controlZone() переходит на config.failSafe
+void LightSensor::reportFailure(TraceSensorStage stage) {
+    measuring = false;
+    Metrics::count(METRIC_SENSOR_ERRORS);
+    EventTrace::record(TRACE_SENSOR_FAIL, traceArg(stage));
+    DEBUG_LOGF(LOG_MODULE_SENSOR, "❌ Ошибка %s %s", stage == TRACE_SENSOR_START ? "запуска измерения" : "чтения",
+               driver->getName());
+    uint32_t now = millis();
+    if (!health.onFailure(now)) return;
+    traceHealth(now);
+    if (health.getState() != SENSOR_LOST) return;
+    sensorFound = false;
+    EVENT_LOGF(LOG_MODULE_SENSOR, "⚠️ Датчик зоны %u потерян после %u ошибок подряд, поиск через %lu мс",
+               muxChannel < 0 ? 0 : muxChannel, health.getConsecutiveFailures(),
+               (unsigned long)health.getBackoff());
+}
+
+void LightSensor::traceHealth(uint32_t now) {
+    EventTrace::record(TRACE_SENSOR_HEALTH, traceArg(health.getState()), health.getLostMs(now));
+}
+
+// Ведомый, у которого оборвали транзакцию (сброс мастера, помеха), держит SDA
+// до конца байта: SCL щелкается, пока он не отпустит линию, затем STOP.
+// Около 100 мкс; true - линия действительно была занята
+static bool clearBus() {
+    Wire.end();
+    pinMode(I2C_SDA, INPUT_PULLUP);
+    if (digitalRead(I2C_SDA) == HIGH) return false;
+    pinMode(I2C_SCL, OUTPUT);
+    for (uint8_t i = 0; i < I2C_CLEAR_PULSES && digitalRead(I2C_SDA) == LOW; i++) {
+        digitalWrite(I2C_SCL, LOW);
+        delayMicroseconds(5);
+        digitalWrite(I2C_SCL, HIGH);
+        delayMicroseconds(5);
+    }
+    pinMode(I2C_SDA, OUTPUT);
+    digitalWrite(I2C_SDA, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SDA, HIGH);
+    return true;
+}
+
+bool LightSensor::recover() {
+    uint32_t now = millis();
+    if (simulationMode || !health.isRetryDue(now)) return false;
+    // Шину делят все зоны: за мультиплексором ее не освобождают и не перезапускают
+    if (muxChannel < 0) {
+        if (clearBus()) health.countBusClear();
+        Wire.begin(I2C_SDA, I2C_SCL, busClock);
+    }
+    bool connected = probe(false);
+    EventTrace::record(TRACE_SENSOR_RECONNECT, traceArg(connected ? 1 : 0));
+    if (!connected) {
+        health.onReconnectFailed(now);
+        DEBUG_LOGF(LOG_MODULE_SENSOR, "🔄 Датчик зоны %u не найден, следующая попытка через %lu мс",
+                   muxChannel < 0 ? 0 : muxChannel, (unsigned long)health.getBackoff());
+        return false;
+    }
+    health.onReconnect(now);
+    traceHealth(now);
+    DEBUG_LOGF(LOG_MODULE_SENSOR, "🔄 %s снова отвечает, ждем измерения", driver->getName());
+    return true;
+}
+
+bool LightSensor::isMeasuring() {
+    return measuring;
+}
+
+bool LightSensor::sample() {
+    if (startMeasurement() == 0) {
+        return simulationMode;
+    }
+    driver->waitReady();
+    return collectMeasurement();
+}
+
+void LightSensor::storeSample(float lux) {
+    cachedLux = lux;
+    sampledAt = millis();
+    hasSample = true;
     
-    float lux = lightMeter.readLightLevel();
-    if (lux >= 0) {
-        DEBUG_LOG("🔆 GY-30: " + String(lux, 2) + " lux");
-        return lux;
-    } else {
-        DEBUG_LOG("❌ Ошибка чтения GY-30");
-        return -1.0;
+    windowSamples++;
+    unsigned long elapsed = sampledAt - windowStart;
+    if (elapsed >= 10000) {
+        sampleRate = windowSamples * 1000.0 / elapsed;
+        windowSamples = 0;
+        windowStart = sampledAt;
     }
 }
 
+LuxSample LightSensor::getSample() {
+    LuxSample result;
+    if (!hasSample) return result;
+    result.lux = cachedLux;
+    result.sampledAt = sampledAt;
+    result.ageMs = millis() - sampledAt;
+    result.valid = result.ageMs <= config.sampleMaxAge;
+    return result;
+}
+
+float LightSensor::getLux() {
+    LuxSample s = getSample();
+    return s.valid ? s.lux : -1.0;
+}
+
+float LightSensor::getSampleRate() {
+    return sampleRate;
+}
+
+float LightSensor::readSimulated() {
+    if (millis() - lastRead > 5000) {
+        simulatedLux += random(-100, 100);
+        if (simulatedLux < 0) simulatedLux = 100;
+        if (simulatedLux > 2000) simulatedLux = 1500;
+        lastRead = millis();
+    }
+    return simulatedLux;
+}
+
 bool LightSensor::isAvailable() {
     return sensorFound;
 }
 
 String LightSensor::getSensorInfo() {
-    if (simulationMode) return "GY-30 (СИМУЛЯЦИЯ)";
+    if (simulationMode) return "СИМУЛЯЦИЯ";
     if (!sensorFound) return "Датчик недоступен";
-    return "GY-30 - Режим: HIGH_RES";
+    String info = String(driver->getName()) + " - диапазон " + driver->getRangeInfo().name;
+    if (muxChannel >= 0) info += ", TCA9548A канал " + String(muxChannel);
+    return info;
+}
+
+uint8_t LightSensor::getAddress() {
+    return sensorFound ? driver->getAddress() : 0;
+}
+
+uint32_t LightSensor::getBusClock() {
+    return busClock;
+}
+
+const char* LightSensor::getDriverName() {
+    if (simulationMode) return "simulation";
+    return sensorFound ? driver->getName() : "none";
+}
+
+const char* LightSensor::getRangeName() {
+    return sensorFound ? driver->getRangeInfo().name : "";
+}
+
+uint32_t LightSensor::getRangeChanges() {
+    return driver ? driver->getRangeChanges() : 0;
+}
+
+uint32_t LightSensor::getSamplePeriod() {
+    return sensorFound && !simulationMode ? driver->getRangeInfo().samplePeriodMs : SENSOR_SAMPLE_INTERVAL;
 }
 
 void LightSensor::setSimulationMode(bool simulate) {
     simulationMode = simulate;
-    DEBUG_LOG("🔧 Режим симуляции: " + String(simulate ? "ВКЛ" : "ВЫКЛ"));
+    DEBUG_LOGF(LOG_MODULE_SENSOR, "🔧 Режим симуляции: %s", simulate ? "ВКЛ" : "ВЫКЛ");
 }
@@ -4,22 +4,89 @@
 
 #include <Arduino.h>
 #include <Wire.h>
-#include <BH1750.h>
+#include "Bh1750Driver.h"
+#include "EventTrace.h"
+#include "SensorHealth.h"
+#include "Veml7700Driver.h"
 
+// Снимок последнего измерения
+struct LuxSample {
+    float lux = -1.0;
+    uint32_t ageMs = 0;     // сколько мс назад получено
+    uint32_t sampledAt = 0; // millis() измерения: по нему видно, что снимок новый
+    bool valid = false;     // измерение есть и не старше config.sampleMaxAge
+};
+
+// Датчик зоны: при старте на шине ищется VEML7700, затем BH1750, и дальше
+// все обращения идут через найденный драйвер. Диапазон драйвер выбирает сам
+// по каждому измерению, период опроса следует за диапазоном.
+// После SENSOR_LOST_FAILURES ошибок подряд датчик считается потерянным: опрос
+// его пропускает, а ищет заново только recover() по расписанию SensorHealth
 class LightSensor {
 public:
     bool begin();
-    float getLux();
+    // Быстрый путь загрузки: датчик там, где он работал в прошлый раз - без сканирования
+    // шины и пауз. false - начинать с begin()
+    bool beginAt(uint8_t address, uint32_t busClock);
+    // Датчик за TCA9548A: без сканирования шины и без симуляции; канал - номер зоны
+    bool beginOnMux(uint8_t channel);
+    // Неблокирующее измерение: запуск возвращает, через сколько мс забрать результат
+    // (0 - результат уже в кэше или запуск невозможен)
+    uint32_t startMeasurement();
+    bool collectMeasurement();   // true - в кэше новый снимок
+    bool isMeasuring();
+    bool sample();               // запуск + ожидание + чтение; блокирует, только для setup()
+    // Попытка восстановления, если она назначена: освобождение шины и поиск датчика,
+    // без пауз. Только из задачи sensorHealth; true - состояние сменилось
+    bool recover();
+    LuxSample getSample();       // кэш, без обращения к датчику
+    float getLux();              // lux из кэша или -1, если снимок недействителен
+    float getSampleRate();       // фактическая частота снимков, Гц
     bool isAvailable();
+    const SensorHealth& getHealth() const { return health; }
     String getSensorInfo();
+    uint8_t getAddress();            // 0 - датчика нет
+    uint32_t getBusClock();          // скорость шины, на которой найден датчик
+    const char* getDriverName();     // "BH1750", "VEML7700", "simulation" или "none"
+    const char* getRangeName();
+    uint32_t getRangeChanges();
+    // Период опроса, которого требует текущий диапазон (в симуляции - SENSOR_SAMPLE_INTERVAL)
+    uint32_t getSamplePeriod();
     void setSimulationMode(bool simulate);
 
 private:
-    BH1750 lightMeter;
+    float readSimulated();
+    bool probe(bool verbose);        // поиск VEML7700 и BH1750 на шине или канале
+    bool probeAddress(uint8_t address, bool verbose);
+    void reportFailure(TraceSensorStage stage);
+    void traceHealth(uint32_t now);
+    void storeSample(float lux);
+    bool selectChannel();            // канал мультиплексора перед обращением к датчику
+    uint16_t traceArg(uint16_t arg) const;
+
+    int8_t muxChannel = -1;          // -1 - датчик прямо на шине
+    uint32_t busClock = 0;
+    SensorHealth health;
+
+    Bh1750Driver bh1750;
+    Veml7700Driver veml7700;
+    LuxDriver* driver = nullptr;
     bool sensorFound = false;
     bool simulationMode = false;
     float simulatedLux = 1000.0;
     unsigned long lastRead = 0;
+
+    bool measuring = false;
+    unsigned long measureStartedAt = 0;
+
+    float cachedLux = -1.0;
+    unsigned long sampledAt = 0;
+    bool hasSample = false;
+
+    // Частота снимков считается по окну в 10 секунд
+    uint32_t windowSamples = 0;
+    unsigned long windowStart = 0;
+    float sampleRate = 0.0;
 };
 
 #endif
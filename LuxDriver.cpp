@@ -0,0 +1,17 @@
+// LuxDriver.cpp
+#include "LuxDriver.h"
+
+bool LuxDriver::adjustRange(float lux) {
+    uint8_t wanted = range;
+    while (wanted + 1 < rangeCount && lux > ranges[wanted].upLux) wanted++;
+    // Насыщенное показание - только оценка снизу: вверх хотя бы на один диапазон
+    if (saturated) {
+        if (wanted == range && wanted + 1 < rangeCount) wanted++;
+    } else {
+        while (wanted > 0 && lux < ranges[wanted].downLux) wanted--;
+    }
+    if (wanted == range || !applyRange(wanted)) return false;
+    range = wanted;
+    rangeChanges++;
+    return true;
+}
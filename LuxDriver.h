@@ -0,0 +1,55 @@
+// LuxDriver.h
+#ifndef LUX_DRIVER_H
+#define LUX_DRIVER_H
+
+#include <Arduino.h>
+
+// Диапазон измерения: усиление и время интегрирования конкретного датчика.
+// Таблица диапазонов идет от самого чувствительного (сумерки) к самому короткому (солнце)
+struct LuxRange {
+    const char* name;
+    uint32_t conversionMs;      // максимальное время преобразования
+    uint32_t samplePeriodMs;    // период опроса в этом диапазоне
+    float upLux;                // выше - следующий, более грубый и быстрый диапазон
+    float downLux;              // ниже - предыдущий, более точный
+};
+
+// Датчик освещенности за LightSensor. Драйвер сам не выбирает канал
+// мультиплексора и не ретраит: это делает LightSensor перед каждым вызовом
+class LuxDriver {
+public:
+    LuxDriver(const LuxRange* ranges, uint8_t rangeCount) : ranges(ranges), rangeCount(rangeCount) {}
+    virtual ~LuxDriver() {}
+
+    virtual const char* getName() const = 0;
+    // Датчик ответил на address и настроен на текущий диапазон
+    virtual bool begin(uint8_t address) = 0;
+    // Запуск преобразования; мс до результата, 0 - ошибка шины
+    virtual uint32_t start() = 0;
+    virtual bool ready() = 0;
+    virtual void waitReady() = 0;          // блокирует, только для setup()
+    virtual float read() = 0;              // lux или < 0 при ошибке; ставит saturated
+
+    // Авторанжирование по последнему измерению: в ярком свете короткое
+    // интегрирование и частый опрос, в сумерках длинное ради точности.
+    // Полосы upLux/downLux перекрываются - на границе диапазон не дребезжит.
+    // true - диапазон сменился, следующее преобразование идет уже в нем
+    bool adjustRange(float lux);
+
+    uint8_t getRange() const { return range; }
+    const LuxRange& getRangeInfo() const { return ranges[range]; }
+    uint32_t getRangeChanges() const { return rangeChanges; }
+    uint8_t getAddress() const { return address; }
+
+protected:
+    virtual bool applyRange(uint8_t index) = 0;
+
+    const LuxRange* ranges;
+    uint8_t rangeCount;
+    uint8_t range = 1;         // после старта - средний диапазон, первое измерение его поправит
+    uint8_t address = 0;
+    uint32_t rangeChanges = 0;
+    bool saturated = false;    // последнее измерение в упоре АЦП - lux занижен
+};
+
+#endif
@@ -0,0 +1,114 @@
+// Metrics.cpp
+#include "Metrics.h"
+#include <stdarg.h>
+
+Metrics::Histogram Metrics::histograms[METRIC_HISTOGRAM_COUNT];
+uint32_t Metrics::counters[METRIC_COUNTER_COUNT];
+
+struct HistogramInfo {
+    const char* metric;
+    const char* labels;
+    const char* help;
+};
+
+static const HistogramInfo HISTOGRAM_INFO[METRIC_HISTOGRAM_COUNT] = {
+#define METRIC_INFO(name, metric, labels, help) {metric, labels, help},
+    METRIC_HISTOGRAM_LIST(METRIC_INFO)
+#undef METRIC_INFO
+};
+
+struct CounterInfo {
+    const char* metric;
+    const char* help;
+};
+
+static const CounterInfo COUNTER_INFO[METRIC_COUNTER_COUNT] = {
+#define METRIC_INFO(name, metric, help) {metric, help},
+    METRIC_COUNTER_LIST(METRIC_INFO)
+#undef METRIC_INFO
+};
+
+// Строки копятся в буфере и уходят порциями, ответ целиком в RAM не собирается
+struct MetricsWriter {
+    Metrics::ChunkCallback callback;
+    void* context;
+    size_t length = 0;
+    char buffer[512];
+
+    void append(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        va_list retry;
+        va_copy(retry, args);
+        int n = vsnprintf(buffer + length, sizeof(buffer) - length, format, args);
+        // Не поместилось - отправляем накопленное и пишем с начала буфера
+        if (n >= (int)(sizeof(buffer) - length) && length > 0) {
+            flush();
+            n = vsnprintf(buffer, sizeof(buffer), format, retry);
+        }
+        va_end(retry);
+        va_end(args);
+        if (n > 0) length += (size_t)n < sizeof(buffer) - length ? n : sizeof(buffer) - length - 1;
+    }
+
+    void flush() {
+        if (length > 0) callback(buffer, length, context);
+        length = 0;
+    }
+};
+
+// Метки гистограммы и le через запятую, без пустой метки в начале
+static void writeBucket(MetricsWriter& out, const HistogramInfo& info, const char* le, uint32_t value) {
+    out.append("%s_bucket{%s%sle=\"%s\"} %lu\n", info.metric, info.labels, info.labels[0] ? "," : "",
+               le, (unsigned long)value);
+}
+
+static void writeSeries(MetricsWriter& out, const HistogramInfo& info, const char* suffix, const char* value) {
+    out.append("%s_%s%s%s%s %s\n", info.metric, suffix, info.labels[0] ? "{" : "", info.labels,
+               info.labels[0] ? "}" : "", value);
+}
+
+void Metrics::render(ChunkCallback callback, void* context) {
+    MetricsWriter out;
+    out.callback = callback;
+    out.context = context;
+    double cyclesPerSecond = ESP.getCpuFreqMHz() * 1e6;
+
+    for (uint8_t i = 0; i < METRIC_HISTOGRAM_COUNT; i++) {
+        const HistogramInfo& info = HISTOGRAM_INFO[i];
+        if (i == 0 || strcmp(info.metric, HISTOGRAM_INFO[i - 1].metric) != 0) {
+            out.append("# HELP %s %s\n# TYPE %s histogram\n", info.metric, info.help, info.metric);
+        }
+        const Histogram& h = histograms[i];
+        uint32_t cumulative = 0;
+        char text[24];
+        for (uint8_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+            cumulative += __atomic_load_n(&h.buckets[bucket], __ATOMIC_RELAXED);
+            snprintf(text, sizeof(text), "%.3g", (double)(1ULL << 2 * (bucket + FIRST_SHIFT)) / cyclesPerSecond);
+            writeBucket(out, info, text, cumulative);
+        }
+        cumulative += __atomic_load_n(&h.buckets[BUCKETS - 1], __ATOMIC_RELAXED);
+        writeBucket(out, info, "+Inf", cumulative);
+        snprintf(text, sizeof(text), "%.6f", h.sumCycles / cyclesPerSecond);
+        writeSeries(out, info, "sum", text);
+        snprintf(text, sizeof(text), "%lu", (unsigned long)cumulative);
+        writeSeries(out, info, "count", text);
+    }
+
+    for (uint8_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        const CounterInfo& info = COUNTER_INFO[i];
+        out.append("# HELP %s %s\n# TYPE %s counter\n%s %lu\n", info.metric, info.help, info.metric,
+                   info.metric, (unsigned long)__atomic_load_n(&counters[i], __ATOMIC_RELAXED));
+    }
+
+    out.append("# HELP phyto_heap_free_bytes Free heap now\n# TYPE phyto_heap_free_bytes gauge\n"
+               "phyto_heap_free_bytes %lu\n", (unsigned long)ESP.getFreeHeap());
+    out.append("# HELP phyto_heap_min_free_bytes Lowest free heap since boot\n# TYPE phyto_heap_min_free_bytes gauge\n"
+               "phyto_heap_min_free_bytes %lu\n", (unsigned long)ESP.getMinFreeHeap());
+    out.append("# HELP phyto_heap_largest_free_block_bytes Largest block malloc can return now\n"
+               "# TYPE phyto_heap_largest_free_block_bytes gauge\n"
+               "phyto_heap_largest_free_block_bytes %lu\n", (unsigned long)ESP.getMaxAllocHeap());
+    out.append("# HELP phyto_uptime_seconds Time since boot\n# TYPE phyto_uptime_seconds counter\n"
+               "phyto_uptime_seconds %lu\n", (unsigned long)(millis() / 1000));
+    out.flush();
+}
@@ -0,0 +1,97 @@
+// Metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// Гистограммы времени: X(имя, метрика Prometheus, метки, "описание").
+// Гистограммы с одной метрикой и разными метками идут подряд
+#define METRIC_HISTOGRAM_LIST(X) \
+    X(METRIC_LOOP,           "phyto_loop_seconds",         "",                                      "loop() pass without the sleep until the next task") \
+    X(METRIC_LOG_WRITE,      "phyto_log_write_seconds",    "",                                      "DebugLogger::writeToFile, one log type per batch") \
+    X(METRIC_I2C_READ,       "phyto_i2c_read_seconds",     "",                                      "Light sensor result read over I2C") \
+    X(METRIC_HTTP_ROOT,      "phyto_http_handler_seconds", "route=\"/\",method=\"GET\"",               "WebAPI handler") \
+    X(METRIC_HTTP_STATUS,    "phyto_http_handler_seconds", "route=\"/api/status\",method=\"GET\"",     "") \
+    X(METRIC_HTTP_CONTROL,   "phyto_http_handler_seconds", "route=\"/api/control\",method=\"POST\"",   "") \
+    X(METRIC_HTTP_GET_SETTINGS, "phyto_http_handler_seconds", "route=\"/api/settings\",method=\"GET\"", "") \
+    X(METRIC_HTTP_SETTINGS,  "phyto_http_handler_seconds", "route=\"/api/settings\",method=\"POST\"",  "") \
+    X(METRIC_HTTP_LOGS,      "phyto_http_handler_seconds", "route=\"/api/logs\",method=\"GET\"",       "") \
+    X(METRIC_HTTP_TASKS,     "phyto_http_handler_seconds", "route=\"/api/tasks\",method=\"GET\"",      "") \
+    X(METRIC_HTTP_SENSOR,    "phyto_http_handler_seconds", "route=\"/api/sensor\",method=\"GET\"",     "") \
+    X(METRIC_HTTP_HISTORY,   "phyto_http_handler_seconds", "route=\"/api/history\",method=\"GET\"",    "") \
+    X(METRIC_HTTP_GET_CLOCK, "phyto_http_handler_seconds", "route=\"/api/clock\",method=\"GET\"",      "") \
+    X(METRIC_HTTP_CLOCK,     "phyto_http_handler_seconds", "route=\"/api/clock\",method=\"POST\"",     "") \
+    X(METRIC_HTTP_ZONES,     "phyto_http_handler_seconds", "route=\"/api/zones\",method=\"GET\"",      "") \
+    X(METRIC_HTTP_GET_ZONE,  "phyto_http_handler_seconds", "route=\"/api/zone\",method=\"GET\"",       "") \
+    X(METRIC_HTTP_ZONE,      "phyto_http_handler_seconds", "route=\"/api/zone\",method=\"POST\"",      "") \
+    X(METRIC_HTTP_TRACE,     "phyto_http_handler_seconds", "route=\"/api/trace\",method=\"GET\"",      "") \
+    X(METRIC_HTTP_EVENTS,    "phyto_http_handler_seconds", "route=\"/api/events\",method=\"GET\"",     "") \
+    X(METRIC_HTTP_SNAPSHOT,  "phyto_http_handler_seconds", "route=\"/api/trace/snapshot\",method=\"POST\"", "") \
+    X(METRIC_HTTP_METRICS,   "phyto_http_handler_seconds", "route=\"/api/metrics\",method=\"GET\"",    "") \
+    X(METRIC_HTTP_NOT_FOUND, "phyto_http_handler_seconds", "route=\"other\",method=\"any\"",          "")
+
+// Счетчики: X(имя, метрика Prometheus, "описание")
+#define METRIC_COUNTER_LIST(X) \
+    X(METRIC_RELAY_SWITCHES,       "phyto_relay_switches_total",           "Relay state changes, all zones") \
+    X(METRIC_SENSOR_ERRORS,        "phyto_sensor_errors_total",            "Failed sensor conversion starts and reads") \
+    X(METRIC_LOG_ROTATIONS,        "phyto_log_rotations_total",            "Log segments closed for a new one") \
+    X(METRIC_LOG_BYTES,            "phyto_log_bytes_written_total",        "Bytes appended to the text logs") \
+    X(METRIC_SENSOR_STORE_BYTES,   "phyto_sensor_store_bytes_written_total", "Bytes appended to the sensor reading ring")
+
+enum MetricHistogram : uint8_t {
+#define METRIC_ENUM(name, metric, labels, help) name,
+    METRIC_HISTOGRAM_LIST(METRIC_ENUM)
+#undef METRIC_ENUM
+    METRIC_HISTOGRAM_COUNT
+};
+
+enum MetricCounter : uint8_t {
+#define METRIC_ENUM(name, metric, help) name,
+    METRIC_COUNTER_LIST(METRIC_ENUM)
+#undef METRIC_ENUM
+    METRIC_COUNTER_COUNT
+};
+
+// Метрики для /api/metrics, включены всегда. Время считается в тактах процессора
+// (регистр CCOUNT, одна инструкция), корзина - log4 тактов через clz: запись -
+// десяток инструкций без делений и блокировок. У каждой метрики один писатель
+// (основной цикл, веб-задача или задача записи логов), читатель на другом ядре
+// видит каждое слово целиком; 64-битную сумму он изредка может застать посреди записи
+class Metrics {
+public:
+    // Корзина i - меньше 4^(i + FIRST_SHIFT) тактов: от 4 мкс до 4,5 с при 240 МГц, последняя - больше
+    static const uint8_t BUCKETS = 12;
+    static const uint8_t FIRST_SHIFT = 5;
+
+    typedef void (*ChunkCallback)(const char* data, size_t length, void* context);
+
+    static uint32_t start() { return ESP.getCycleCount(); }
+
+    static void record(MetricHistogram metric, uint32_t startCycles) {
+        uint32_t cycles = ESP.getCycleCount() - startCycles;
+        uint32_t log4 = (31 - __builtin_clz(cycles | 1)) >> 1;
+        uint32_t bucket = log4 <= FIRST_SHIFT - 1 ? 0 : log4 - (FIRST_SHIFT - 1);
+        if (bucket > BUCKETS - 1) bucket = BUCKETS - 1;
+        Histogram& h = histograms[metric];
+        __atomic_store_n(&h.buckets[bucket], h.buckets[bucket] + 1, __ATOMIC_RELAXED);
+        h.sumCycles += cycles;
+    }
+
+    static void count(MetricCounter counter, uint32_t n = 1) {
+        __atomic_store_n(&counters[counter], counters[counter] + n, __ATOMIC_RELAXED);
+    }
+
+    // Текст в формате Prometheus 0.0.4 порциями через callback
+    static void render(ChunkCallback callback, void* context);
+
+private:
+    struct Histogram {
+        uint32_t buckets[BUCKETS];
+        uint64_t sumCycles;
+    };
+
+    static Histogram histograms[METRIC_HISTOGRAM_COUNT];
+    static uint32_t counters[METRIC_COUNTER_COUNT];
+};
+
+#endif
@@ -1,31 +1,71 @@
 // PhytoController.ino - ИСПРАВЛЕННАЯ версия setup()
 #include "Config.h"
+#include "BootProfile.h"
 #include "DebugLogger.h"
 #include "LightSensor.h"
 #include "RelayController.h"
 #include "RGBLed.h"  
 #include "WebAPI.h"  
+#include "Scheduler.h"
+#include "Clock.h"
+#include "ConfigStore.h"
+#include "ControlEngine.h"
+#include "EventTrace.h"
+#include "History.h"
+#include "I2CMux.h"
+#include "LampDimmer.h"
+#include "LightIntegral.h"
+#include "Metrics.h"
+#include "PiController.h"
+#include "SharedState.h"
+#include <esp_system.h>
 
-// Глобальные объекты
-LightSensor lightSensor;
-RelayController relayController(RELAY_PIN);
+// Глобальные объекты; зона 0 - основной датчик и реле
+LightSensor lightSensors[MAX_ZONES];
+LightSensor& lightSensor = lightSensors[0];
+RelayController relayController(ZONE_RELAY_PINS);
+LampDimmer lampDimmer(DIM_PIN, DIM_LEDC_CHANNEL);
+PiController dimmerPi;
 RGBLed rgbLed;
+uint8_t zoneCount = 1;
+// Период задачи sensor: все зоны запускаются вместе, поэтому берется самый
+// медленный диапазон среди них
+uint32_t sensorSamplePeriod = SENSOR_SAMPLE_INTERVAL;
+int8_t controlTask = Scheduler::INVALID_TASK;
+int8_t commandTask = Scheduler::INVALID_TASK;
 
-// Таймеры
-unsigned long lastSensorCheck = 0;
-unsigned long lastSensorLog = 0;
-unsigned long lastBlink = 0;
-unsigned long lastRGBUpdate = 0;
 bool ledState = false;
 
 // Объявление функций
 void checkLightAndControl();
+bool controlZone(uint8_t zone, bool photoperiod);
+bool beginZoneSensors();
+void beginSensors();
 void logSensorData();
 void testSensorConnection();
+void blinkStatusLed();
+void sampleLight();
+void collectLight();
+void recoverSensors();
+void dimLight();
+void updateRGBStatus();
+void applyWebCommands();
+void publishState();
+void checkpointHistory();
+void commitConfig();
+void syncClock();
+void saveBeforeRestart();
+bool isPhotoperiod();
 
+// После сброса (просадка питания, сторожевой таймер, паника) лампы без управления,
+// пока идет setup(): паузы для монитора порта, тест реле и мигания - только при
+// включении питания, датчик ищется сначала там, где он был в прошлый раз
 void setup() {
+    BootProfile::begin();
+    bool coldBoot = BootProfile::isColdBoot();
     Serial.begin(115200);
-    delay(2000);
+    if (coldBoot) delay(2000);
+    BootProfile::phase("serial");
     
     Serial.println("\n🌱 PhytoController Starting...");
     Serial.println("=================================");
@@ -42,57 +82,76 @@ void setup() {
     Serial.println("⚙️ Загрузка настроек...");
     loadConfig();
     printConfig();
+    BootProfile::phase("config");
     
     // 3. Инициализация файловой системы и логирования (ПЕРВОЙ!)
     Serial.println("📝 Инициализация системы логирования...");
     DebugLogger::begin();
     DebugLogger::setMaxLogSize(config.maxLogSize);
-    SYSTEM_LOG("🚀 Система запускается...");
+    EventTrace::begin();
+    History::begin();
+    lightIntegral.begin();
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "🚀 Система запускается...");
+    // Слотов в ESP-IDF всего пять, один займет WiFi: регистрируемся до него и одним обработчиком
+    esp_err_t shutdownResult = esp_register_shutdown_handler(saveBeforeRestart);
+    if (shutdownResult != ESP_OK) {
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "❌ Обработчик перезагрузки не зарегистрирован (ошибка 0x%x)",
+                    (unsigned)shutdownResult);
+    }
+    BootProfile::phase("storage");
     
     // 4. Инициализация RGB индикации
     Serial.println("🌈 Инициализация RGB LED...");
     rgbLed.begin();
-    SYSTEM_LOG("✅ RGB LED инициализирован");
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ RGB LED инициализирован");
+    BootProfile::phase("rgb");
     
-    // 5. Инициализация датчика света
-    Serial.println("🔍 Инициализация датчика света GY-30...");
-    if (lightSensor.begin()) {
-        SYSTEM_LOG("✅ Датчик освещенности инициализирован");
-    } else {
-        SYSTEM_LOG("⚠️ Датчик не найден, режим симуляции");
-    }
+    // 5. Инициализация датчика света: за TCA9548A - по датчику на зону
+    Serial.println("🔍 Инициализация датчика света...");
+    beginSensors();
+    BootProfile::phase("sensor");
     
     // 6. Инициализация реле
     Serial.println("🔌 Инициализация реле...");
-    relayController.begin();
-    SYSTEM_LOG("✅ Контроллер реле инициализирован");
+    relayController.begin(zoneCount);
+    lampDimmer.begin();
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ Контроллер реле инициализирован");
+    BootProfile::phase("relay");
     
-    // 7. Тестирование подключения датчика
-    Serial.println("🔧 Тестирование подключения...");
-    testSensorConnection();
+    // 7. Тестирование подключения датчика: блокирующее измерение и подсказки по проводке
+    if (coldBoot) {
+        Serial.println("🔧 Тестирование подключения...");
+        testSensorConnection();
+        BootProfile::phase("sensorTest");
+    }
     
     // 8. Инициализация Web API и WiFi
     Serial.println("🌐 Инициализация Web API...");
+    publishState();   // веб-задача стартует сразу и читает снимок
     webAPI.begin();
-    SYSTEM_LOG("✅ Web API инициализирован");
+    Clock::begin();
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ Web API инициализирован");
+    BootProfile::phase("web");
     
     // 9. Финальная проверка и сигнал готовности
     Serial.println("🔍 Финальная проверка систем...");
     
     // Проверяем ключевые компоненты
-    bool systemsReady = true;
-    
     if (!lightSensor.isAvailable()) {
         Serial.println("⚠️ Внимание: датчик в режиме симуляции");
-        SYSTEM_LOG("⚠️ Режим симуляции датчика");
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "⚠️ Режим симуляции датчика");
     }
     
-    // Проверяем реле
-    Serial.println("🔌 Тест реле...");
-    relayController.turnOn();
-    delay(500);
-    relayController.turnOff();
-    SYSTEM_LOG("✅ Тест реле выполнен");
+    // Проверяем реле; после сброса лампы не мигают
+    if (coldBoot) {
+        Serial.println("🔌 Тест реле...");
+        relayController.turnOn();
+        delay(500);
+        relayController.turnOff();
+        relayController.forgetSwitches();
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ Тест реле выполнен");
+        BootProfile::phase("relayTest");
+    }
     
     // 10. Сигнал успешной инициализации
     Serial.println("🎉 Все системы инициализированы!");
@@ -111,100 +170,376 @@ void setup() {
     Serial.println("⏰ Uptime: 0 сек");
     Serial.println("=================================");
     
-    rgbLed.blinkSuccess();
-    SYSTEM_LOG("🎯 Система готова к работе");
+    if (coldBoot) rgbLed.blinkSuccess();
+    BootProfile::phase("ready");
     
-    // Начальное состояние RGB
-    float lux = lightSensor.getLux();
-    rgbLed.setStatus(relayController.getState(), config.autoMode, lux, config.lightThreshold);
+    // Задачи планировщика; периоды управления и логирования читаются из config
+    // при каждом перепланировании, поэтому /api/settings применяется сразу
+    scheduler.every("sensor", &sensorSamplePeriod, sampleLight);
+    scheduler.every("sensorHealth", SENSOR_HEALTH_INTERVAL, recoverSensors);
+    scheduler.every("dim", DIM_CONTROL_INTERVAL, dimLight);
+    scheduler.every("blink", BLINK_INTERVAL, blinkStatusLed);
+    scheduler.every("rgb", RGB_UPDATE_INTERVAL, updateRGBStatus);
+    controlTask = scheduler.every("control", &config.checkInterval, checkLightAndControl);
+    scheduler.every("sensorLog", &config.sensorLogInterval, logSensorData);
+    // Команды применяются сразу по приходу: веб-задача будит основной цикл
+    commandTask = scheduler.every("commands", COMMAND_POLL_INTERVAL, applyWebCommands);
+    SharedState::setCommandListener([]() { scheduler.triggerFromTask(commandTask); });
+    scheduler.every("history", HISTORY_CHECKPOINT_INTERVAL, checkpointHistory);
+    scheduler.every("config", CONFIG_COMMIT_POLL_INTERVAL, commitConfig);
+    scheduler.every("clock", CLOCK_SYNC_INTERVAL, syncClock);
+    BootProfile::finish();
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "🎯 Система готова к работе: setup() %lu мс, датчик: %s",
+                (unsigned long)BootProfile::getSetupMs(), BootProfile::getSensorProbe());
+    publishState();
 }
 
 void loop() {
-    unsigned long currentMillis = millis();
+    // Выполняем наступившие задачи и спим до ближайшего срока; в метрику - только работа
+    uint32_t started = Metrics::start();
+    scheduler.runDue();
+    Metrics::record(METRIC_LOOP, started);
+    scheduler.sleepUntilNext();
+}
+
+// Мигаем обычным LED для индикации работы
+void blinkStatusLed() {
+    ledState = !ledState;
+    digitalWrite(STATUS_LED, ledState);
     
-    // Мигаем обычным LED для индикации работы
-    if (currentMillis - lastBlink > 1000) {
-        lastBlink = currentMillis;
-        ledState = !ledState;
-        digitalWrite(STATUS_LED, ledState);
-        
-        // Логируем статус каждые 10 секунд чтобы не засорять логи
-        static uint8_t statusCounter = 0;
-        if (++statusCounter >= 10) {
-            statusCounter = 0;
-            DEBUG_LOG("💡 LED: " + String(ledState ? "ON" : "OFF") + 
-                     " | Uptime: " + String(millis()/1000) + "s" +
-                     " | Free RAM: " + String(esp_get_free_heap_size()) + " bytes");
+    // Логируем статус каждые 10 секунд чтобы не засорять логи
+    static uint8_t statusCounter = 0;
+    if (++statusCounter >= 10) {
+        statusCounter = 0;
+        DEBUG_LOGF(LOG_MODULE_MAIN, "💡 LED: %s | Uptime: %lus | Free RAM: %lu bytes",
+                   ledState ? "ON" : "OFF", (unsigned long)(millis() / 1000),
+                   (unsigned long)esp_get_free_heap_size());
+    }
+}
+
+// Единственная задача, которая опрашивает датчики; остальные читают кэш.
+// Преобразования всех зон запускаются одной серией по шине и идут параллельно,
+// результаты забирает одна однократная задача
+void sampleLight() {
+    uint32_t conversionMs = 0;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        uint32_t ms = lightSensors[zone].startMeasurement();
+        if (ms > conversionMs) conversionMs = ms;
+    }
+    if (conversionMs > 0) {
+        scheduler.after("sensorRead", conversionMs, collectLight);
+    }
+}
+
+// Фильтр получает каждое измерение, решение о реле принимается раз в checkInterval
+void collectLight() {
+    uint32_t now = millis();
+    uint32_t period = 0;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        if (lightSensors[zone].collectMeasurement()) {
+            float lux = lightSensors[zone].getSample().lux;
+            controlEngine.addSample(zone, lux, config, now);
+            if (zone == 0) lightIntegral.addSample(lux, relayController.getState(), config, now);
         }
+        uint32_t zonePeriod = lightSensors[zone].getSamplePeriod();
+        if (zonePeriod > period) period = zonePeriod;
     }
-    
-    // Обновляем RGB индикатор (каждые 500мс)
-    if (currentMillis - lastRGBUpdate > 500) {
-        lastRGBUpdate = currentMillis;
-        float lux = lightSensor.getLux();
-        rgbLed.setStatus(relayController.getState(), config.autoMode, lux, config.lightThreshold);
+    // Диапазон сменился: следующий запуск уже с новым периодом
+    sensorSamplePeriod = period;
+    // Первое решение по реле после загрузки - не дожидаясь checkInterval
+    if (!BootProfile::hasControl()) scheduler.trigger(controlTask);
+    publishState();
+}
+
+// Потерянные датчики ищутся здесь, по расписанию SensorHealth - ни опрос,
+// ни обработчики HTTP на это не тратят время. Отказ виден веб-задаче сразу:
+// опрос потерянного датчика не идет, и collectLight() снимок не опубликует
+void recoverSensors() {
+    static uint8_t lastHealth[MAX_ZONES] = {};
+    bool changed = false;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        lightSensors[zone].recover();
+        uint8_t health = lightSensors[zone].getHealth().getState();
+        if (health != lastHealth[zone]) {
+            lastHealth[zone] = health;
+            changed = true;
+        }
     }
-    
-    // Основная логика управления (по интервалу из конфига)
-    if (currentMillis - lastSensorCheck >= config.checkInterval) {
-        lastSensorCheck = currentMillis;
-        checkLightAndControl();
+    if (changed) publishState();
+}
+
+// Яркость лампы зоны 0 с постоянным шагом DIM_CONTROL_INTERVAL. В режиме dimMode
+// ПИ-регулятор держит dimTarget, добавляя к солнцу только недостающий свет; иначе
+// лампа при включенном реле горит в полную силу. Реле решает controlZone(): пока
+// оно выключено, регулятор стоит в нуле и после включения разгоняется плавно.
+// Датчик обновляется раз в 100-1000 мс, реже шага: регулятор считает только новый
+// снимок, с фактическим временем от предыдущего, а между ними держит выход
+void dimLight() {
+    static uint32_t piSampledAt = 0;   // снимок последнего шага регулятора, 0 - после reset()
+    uint16_t target = 0;
+    if (!relayController.getState()) {
+        dimmerPi.reset();
+        piSampledAt = 0;
+    } else if (config.autoMode && config.dimMode && !config.dliMode) {
+        dimmerPi.configure(config.dimKp / 100 * DIM_DUTY_MAX, config.dimKi / 100 * DIM_DUTY_MAX, DIM_DUTY_MAX);
+        LuxSample sample = lightSensor.getSample();
+        // Без свежих данных яркость замирает на последнем значении; датчик потерян -
+        // регулятору не на что опираться, реле включено по config.failSafe: полная яркость
+        if (sample.valid && sample.sampledAt != piSampledAt) {
+            uint32_t dt = piSampledAt ? sample.sampledAt - piSampledAt : 0;
+            target = dimmerPi.update(config.dimTarget, sample.lux, dt);
+            piSampledAt = sample.sampledAt;
+        } else if (!sample.valid && lightSensor.getHealth().isLost()) {
+            target = DIM_DUTY_MAX;
+            dimmerPi.reset(DIM_DUTY_MAX);
+            piSampledAt = 0;
+        } else {
+            target = dimmerPi.getOutput();
+        }
+    } else {
+        target = DIM_DUTY_MAX;
+        dimmerPi.reset();
+        piSampledAt = 0;
     }
-    
-    // Логирование показаний датчика (по интервалу из конфига)
-    if (currentMillis - lastSensorLog >= config.sensorLogInterval) {
-        lastSensorLog = currentMillis;
-        logSensorData();
+    lampDimmer.setTarget(target);
+    lampDimmer.tick();
+}
+
+// Порядок поиска: TCA9548A (одна транзакция), датчик на адресе и скорости прошлой
+// загрузки, полное сканирование шины. Найденный напрямую датчик запоминается
+void beginSensors() {
+    if (beginZoneSensors()) {
+        BootProfile::setSensorProbe("mux");
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ TCA9548A: зон %u", zoneCount);
+        return;
+    }
+    if (config.sensorAddress && lightSensor.beginAt(config.sensorAddress, config.sensorBusClock)) {
+        BootProfile::setSensorProbe("cached");
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ Датчик освещенности на прошлом адресе 0x%02x", config.sensorAddress);
+        return;
+    }
+    if (!lightSensor.begin()) {
+        BootProfile::setSensorProbe("none");
+        SYSTEM_LOGF(LOG_MODULE_MAIN, "⚠️ Датчик не найден, режим симуляции");
+        return;
+    }
+    BootProfile::setSensorProbe("scan");
+    SYSTEM_LOGF(LOG_MODULE_MAIN, "✅ Датчик освещенности инициализирован");
+    if (lightSensor.getAddress() != config.sensorAddress || lightSensor.getBusClock() != config.sensorBusClock) {
+        config.sensorAddress = lightSensor.getAddress();
+        config.sensorBusClock = lightSensor.getBusClock();
+        saveConfig();
     }
-    
-    // Обрабатываем веб-запросы
-    webAPI.handleClient();
-    
-    delay(100); // Основная задержка цикла
 }
 
-void checkLightAndControl() {
-    DEBUG_LOG("🔍 Проверка освещенности...");
-    
+// TCA9548A на шине: зона на каждый канал до последнего, где ответил BH1750 или VEML7700
+bool beginZoneSensors() {
+    Wire.begin(I2C_SDA, I2C_SCL, I2C_MUX_CLOCK);
+    if (!I2CMux::begin()) {
+        Wire.end();
+        return false;
+    }
+    zoneCount = max(I2CMux::detect(Bh1750Driver::ADDRESS_LOW), I2CMux::detect(Veml7700Driver::ADDRESS));
+    if (zoneCount == 0) zoneCount = 1;   // датчиков нет: зона 0 без сигнала, реле не трогаем
+    for (uint8_t zone = 0; zone < zoneCount; zone++) lightSensors[zone].beginOnMux(zone);
+    return true;
+}
+
+// Обновляем RGB индикатор
+void updateRGBStatus() {
     float lux = lightSensor.getLux();
-    
+    rgbLed.setStatus(relayController.getState(), config.autoMode, lux, config.lightThreshold);
+}
+
+// Снимок для веб-задачи на ядре 0: она читает только его. Публикуется после
+// каждого изменения датчика, реле или настроек
+void publishState() {
+    ControllerState state;
+    LuxSample sample = lightSensor.getSample();
+    state.lux = sample.lux;
+    state.sampleTime = millis() - sample.ageMs;
+    state.sampleRate = lightSensor.getSampleRate();
+    state.samplePeriod = sensorSamplePeriod;
+    state.sensorType = lightSensor.getDriverName();
+    state.sensorRange = lightSensor.getRangeName();
+    state.rangeChanges = lightSensor.getRangeChanges();
+    state.sensorAvailable = lightSensor.isAvailable();
+    const SensorHealth& health = lightSensor.getHealth();
+    state.sensorHealth = health.getState();
+    state.sensorFailures = health.getConsecutiveFailures();
+    state.sensorBackoff = health.getBackoff();
+    state.health = health.getStats();
+    state.relayState = relayController.getState();
+    state.scheduleActive = isPhotoperiod();
+    state.control = controlEngine.getStats(0);
+    state.dli = lightIntegral.getStats();
+    state.dimmer = dimmerPi.getStats();
+    state.dimDuty = lampDimmer.getDuty();
+    state.config = config;
+    state.zones.count = zoneCount;
+    state.zones.mux = I2CMux::isPresent();
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        LuxSample zoneSample = lightSensors[zone].getSample();
+        state.zones.lux[zone] = zoneSample.lux;
+        state.zones.sampleTime[zone] = millis() - zoneSample.ageMs;
+        state.zones.sensorAvailable[zone] = lightSensors[zone].isAvailable();
+        state.zones.sensorType[zone] = lightSensors[zone].getDriverName();
+        state.zones.sensorRange[zone] = lightSensors[zone].getRangeName();
+        state.zones.sensorHealth[zone] = lightSensors[zone].getHealth().getState();
+        state.zones.filtered[zone] = controlEngine.getFiltered(zone);
+        state.zones.relay[zone] = relayController.getState(zone);
+        state.zones.switches[zone] = controlEngine.getStats(zone).switches;
+    }
+    SharedState::publish(state);
+}
+
+// Команды /api/control и /api/settings выполняются здесь, в основном цикле
+void applyWebCommands() {
+    ControlCommand command;
+    bool applied = false;
+    while (SharedState::take(command)) {
+        applied = true;
+        // Кнопка реле - это ручной режим с таким состоянием: прямое переключение
+        // вернул бы следующий controlZone() или через minOnTime/minOffTime авторежим
+        if (command.relay >= 0) {
+            command.settings.manualOn = command.relay == 1;
+            command.settingsMask |= 1UL << SETTING_MANUAL_ON;
+            if (!(command.settingsMask & (1UL << SETTING_AUTO_MODE))) {
+                command.settings.autoMode = false;
+                command.settingsMask |= 1UL << SETTING_AUTO_MODE;
+            }
+        }
+        uint32_t changed = command.settingsMask ? applySettings(command.settings, command.settingsMask) : 0;
+        if (changed & (1UL << SETTING_AUTO_MODE | 1UL << SETTING_MANUAL_ON)) scheduler.trigger(controlTask);
+        if (command.zoneThresholdMask || command.zoneModeMask) {
+            applyZoneSettings(command.settings, command.zoneThresholdMask, command.zoneModeMask);
+        }
+        if (command.clockTime) Clock::set(command.clockTime, CLOCK_SOURCE_API);
+    }
+    if (applied) publishState();
+}
+
+// Расписание общее для всех зон, порог и режим - у каждой свои
+void checkLightAndControl() {
+    DEBUG_LOGF(LOG_MODULE_MAIN, "🔍 Проверка освещенности...");
+    bool photoperiod = isPhotoperiod();
+    bool changed = false;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        if (controlZone(zone, photoperiod)) changed = true;
+    }
+    if (changed) publishState();
+}
+
+// true - реле зоны переключено. Решение на каждой проверке пишется в отладочный
+// лог только для зоны 0: восемь зон раз в секунду забили бы журнал
+bool controlZone(uint8_t zone, bool photoperiod) {
+    LuxSample sample = lightSensors[zone].getSample();
+    ControlStats control = controlEngine.getStats(zone);
+    bool relayState = relayController.getState(zone);
+    ZoneMode mode = getZoneMode(config, zone);
     bool shouldBeOn = false;
     
-    if (config.autoMode) {
-        shouldBeOn = (lux < config.lightThreshold);
-        DEBUG_LOG("🤖 Авторежим: " + String(shouldBeOn ? "ВКЛ" : "ВЫКЛ") + 
-                 " | Lux: " + String(lux, 2) + 
-                 " | Порог: " + String(config.lightThreshold));
+    if (mode == ZONE_MODE_AUTO && (!sample.valid || !controlEngine.hasSignal(zone))) {
+        // Пока датчик только сбоит, реле держится; потерянный датчик - config.failSafe,
+        // без minOnTime/minOffTime
+        if (!lightSensors[zone].getHealth().isLost() || config.failSafe == FAIL_SAFE_HOLD) {
+            if (zone == 0) {
+                DEBUG_LOGF(LOG_MODULE_MAIN, "⚠️ Нет свежих данных освещенности (возраст %lu мс), состояние реле не меняем",
+                           (unsigned long)sample.ageMs);
+            }
+            return false;
+        }
+        shouldBeOn = config.failSafe == FAIL_SAFE_SCHEDULE && photoperiod;
+        if (zone == 0) {
+            DEBUG_LOGF(LOG_MODULE_MAIN, "🛟 Датчик потерян: реле %s по failSafe", shouldBeOn ? "ВКЛ" : "ВЫКЛ");
+        }
+    } else if (mode == ZONE_MODE_AUTO) {
+        // Вне фотопериода свет выключается сразу, без ожидания minOnTime
+        uint32_t stateAge = relayController.getStateAge(zone);
+        if (zone == 0 && config.dliMode) {
+            bool needed = lightIntegral.isLampNeeded(relayState, lightSchedule, config);
+            shouldBeOn = photoperiod && controlEngine.applyDwell(zone, relayState, needed, stateAge, config);
+            const DliStats& dli = lightIntegral.getStats();
+            DEBUG_LOGF(LOG_MODULE_MAIN, "🌞 DLI: %s | %.2f из %.2f mol/m², прогноз %.2f | осталось %u мин%s",
+                       shouldBeOn ? "ВКЛ" : "ВЫКЛ", dli.today, config.dliTarget, dli.projected,
+                       dli.remainingMinutes, photoperiod ? "" : " | вне расписания");
+        } else {
+            // С диммером реле только выключатель: порог - уставка регулятора
+            float threshold = zone == 0 && config.dimMode ? config.dimTarget : getZoneThreshold(config, zone);
+            // Лампа зоны 0 светит на текущую яркость диммера
+            float lampLux = relayState ? ControlEngine::getLampLux(config) : 0;
+            if (zone == 0) lampLux *= (float)lampDimmer.getDuty() / DIM_DUTY_MAX;
+            shouldBeOn = photoperiod && controlEngine.decide(zone, relayState, stateAge, threshold, lampLux, config);
+            if (zone == 0) {
+                DEBUG_LOGF(LOG_MODULE_MAIN, "🤖 Авторежим: %s | Lux: %.2f (фильтр %.2f, лампа %.0f) | Порог: %.2f ±%.2f%s",
+                           shouldBeOn ? "ВКЛ" : "ВЫКЛ", control.raw, control.filtered, lampLux,
+                           threshold, config.hysteresis / 2, photoperiod ? "" : " | вне расписания");
+            }
+        }
     } else {
-        shouldBeOn = config.manualOn;
-        DEBUG_LOG("👤 Ручной режим: " + String(shouldBeOn ? "ВКЛ" : "ВЫКЛ"));
+        shouldBeOn = mode == ZONE_MODE_ON;
+        if (zone == 0) DEBUG_LOGF(LOG_MODULE_MAIN, "👤 Ручной режим: %s", shouldBeOn ? "ВКЛ" : "ВЫКЛ");
     }
     
+    // Первое решение - когда реле зоны 0 пришло к нужному состоянию, а не отложено
+    bool settled = mode != ZONE_MODE_AUTO || !controlEngine.isHolding(zone);
+    
     // Применяем состояние
-    if (shouldBeOn && !relayController.getState()) {
-        relayController.turnOn();
-        EVENT_LOG("💡 Реле ВКЛ (Освещенность: " + String(lux, 2) + " lux)");
-    } else if (!shouldBeOn && relayController.getState()) {
-        relayController.turnOff();
-        EVENT_LOG("💡 Реле ВЫКЛ (Освещенность: " + String(lux, 2) + " lux)");
+    if (shouldBeOn == relayState) {
+        if (zone == 0 && settled) BootProfile::markControl();
+        return false;
     }
+    if (mode == ZONE_MODE_AUTO) controlEngine.recordSwitch(zone);
+    EventTrace::recordFloat(TRACE_CONTROL_DECISION, (shouldBeOn ? 1 : 0) | zone << 8, control.filtered);
+    if (shouldBeOn) {
+        relayController.turnOn(zone);
+        EVENT_LOGF(LOG_MODULE_MAIN, "💡 Зона %u: реле ВКЛ (Освещенность: %.2f lux, фильтр %.2f)",
+                   zone, control.raw, control.filtered);
+    } else {
+        relayController.turnOff(zone);
+        EVENT_LOGF(LOG_MODULE_MAIN, "💡 Зона %u: реле ВЫКЛ (Освещенность: %.2f lux, фильтр %.2f)",
+                   zone, control.raw, control.filtered);
+    }
+    if (zone == 0) BootProfile::markControl();
+    return true;
 }
 
 void logSensorData() {
-    float lux = lightSensor.getLux();
-    if (lux >= 0) {
+    LuxSample sample = lightSensor.getSample();
+    float lux = sample.lux;
+    if (sample.valid) {
         DebugLogger::logSensor(lux, relayController.getState());
+        History::add(lux, relayController.getState());
         
         // Дополнительная информация в debug
-        if (config.debugEnabled) {
-            DEBUG_LOG("📊 Данные: Lux=" + String(lux, 2) + 
-                     " | Relay=" + (relayController.getState() ? "ON" : "OFF") +
-                     " | Mode=" + (config.autoMode ? "AUTO" : "MANUAL") +
-                     " | Threshold=" + String(config.lightThreshold));
-        }
+        DEBUG_LOGF(LOG_MODULE_MAIN, "📊 Данные: Lux=%.2f | Relay=%s | Mode=%s | Threshold=%.2f",
+                   lux, relayController.getState() ? "ON" : "OFF",
+                   config.autoMode ? "AUTO" : "MANUAL", config.lightThreshold);
     }
 }
 
+// Агрегаты истории и DLI живут в RAM; на флеш их копия попадает раз в полчаса
+void checkpointHistory() {
+    History::checkpoint();
+    lightIntegral.save();
+}
+
+// Серия изменений настроек через API записывается на флеш один раз
+void commitConfig() {
+    ConfigStore::commit();
+}
+
+void syncClock() {
+    Clock::sync();
+}
+
+// Расписание проверяется одним битом; пока часы не заданы, реле управляет только освещенность
+bool isPhotoperiod() {
+    LocalTime local;
+    if (!Clock::getLocal(config.timezoneOffset, local)) return true;
+    return lightSchedule.isActive(local.weekday, local.minute);
+}
+
 // Функция тестирования подключения датчика
 void testSensorConnection() {
     Serial.println("\n🔧 ТЕСТ ПОДКЛЮЧЕНИЯ ДАТЧИКА");
@@ -222,6 +557,7 @@ void testSensorConnection() {
     
     if (lightSensor.isAvailable()) {
         Serial.println("✅ Реальный датчик GY-30 подключен");
+        lightSensor.sample();
         float lux = lightSensor.getLux();
         Serial.println("📊 Текущая освещенность: " + String(lux, 2) + " lux");
     } else {
@@ -249,3 +585,12 @@ void testSensorConnection() {
         rgbLed.blinkError();
     }    
 }
+
+// ESP.restart(): настройки сразу после /api/settings, история и DLI с последней
+// контрольной точки не теряются; трассировка последней, чтобы попали события записи
+void saveBeforeRestart() {
+    ConfigStore::commit(true);
+    History::checkpoint();
+    lightIntegral.save();
+    EventTrace::snapshot(TRACE_SNAPSHOT_RESTART);
+}
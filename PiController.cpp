@@ -0,0 +1,66 @@
+// PiController.cpp
+#include "PiController.h"
+
+// ±65535 lux в Q4 с запасом помещаются в int32, а после умножения на коэффициент
+// и dt до MAX_DT_MS - в int64
+static int32_t toQ4(float lux) {
+    if (lux > 65535.0f) lux = 65535.0f;
+    if (lux < -65535.0f) lux = -65535.0f;
+    return (int32_t)lroundf(lux * 16);
+}
+
+static int64_t clampOutput(int64_t value, int32_t maxQ16) {
+    return value < 0 ? 0 : value > maxQ16 ? maxQ16 : value;
+}
+
+void PiController::configure(float newKp, float newKi, uint16_t newOutMax) {
+    if (newKp == kp && newKi == ki && newOutMax == outMax) return;
+    kp = newKp;
+    ki = newKi;
+    outMax = newOutMax;
+    kpQ16 = (int32_t)lroundf(kp * (1 << GAIN_SHIFT));
+    kiQ24 = (int32_t)lroundf(ki / 1000.0f * (1 << KI_SHIFT));
+    outMaxQ16 = (int32_t)outMax << GAIN_SHIFT;
+    integralQ16 = (int32_t)clampOutput(integralQ16, outMaxQ16);
+}
+
+void PiController::reset(uint16_t value) {
+    output = value > outMax ? outMax : value;
+    integralQ16 = (int32_t)output << GAIN_SHIFT;
+    errorQ4 = 0;
+}
+
+uint16_t PiController::update(float setpoint, float measurement, uint32_t dtMs) {
+    if (dtMs > MAX_DT_MS) dtMs = MAX_DT_MS;
+    errorQ4 = toQ4(setpoint) - toQ4(measurement);
+    int64_t proportional = ((int64_t)kpQ16 * errorQ4) >> LUX_SHIFT;
+    int64_t step = ((int64_t)kiQ24 * errorQ4 * (int64_t)dtMs) >> (LUX_SHIFT + KI_SHIFT - GAIN_SHIFT);
+
+    // Интеграл идет к упору выхода, но не за него: дальше ошибка его не копит
+    int64_t integral = integralQ16 + step;
+    int64_t upper = outMaxQ16 - proportional;
+    int64_t lower = -proportional;
+    if (step > 0 && integral > upper) {
+        integral = upper > integralQ16 ? upper : integralQ16;
+        saturated++;
+    } else if (step < 0 && integral < lower) {
+        integral = lower < integralQ16 ? lower : integralQ16;
+        saturated++;
+    }
+    integralQ16 = (int32_t)clampOutput(integral, outMaxQ16);
+
+    int64_t total = clampOutput(proportional + integralQ16, outMaxQ16);
+    output = (uint16_t)((total + (1 << (GAIN_SHIFT - 1))) >> GAIN_SHIFT);
+    updates++;
+    return output;
+}
+
+PiStats PiController::getStats() const {
+    PiStats stats;
+    stats.error = errorQ4 / 16.0f;
+    stats.output = output;
+    stats.integral = integralQ16 / (float)(1 << GAIN_SHIFT);
+    stats.updates = updates;
+    stats.saturated = saturated;
+    return stats;
+}
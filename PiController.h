@@ -0,0 +1,50 @@
+// PiController.h
+#ifndef PI_CONTROLLER_H
+#define PI_CONTROLLER_H
+
+#include <Arduino.h>
+
+struct PiStats {
+    float error = 0.0;           // уставка - измерение, lux
+    uint16_t output = 0;         // последний выход, 0..outMax
+    float integral = 0.0;        // интегральная часть в единицах выхода
+    uint32_t updates = 0;
+    uint32_t saturated = 0;      // шаги, на которых интеграл уперся в предел выхода
+};
+
+// ПИ-регулятор в фиксированной точке. Шаг делается на каждое новое измерение
+// с фактическим dt от предыдущего, поэтому интеграл не зависит от периода опроса
+// датчика. Lux переводятся в Q4 на входе, интеграл хранится в Q16 единиц выхода,
+// ki - в Q24 на мс: шаг занимает три целочисленных умножения без циклов и делений.
+// Интеграл доходит до упора выхода и дальше в ту же сторону не копится (anti-windup)
+class PiController {
+public:
+    // kp - единиц выхода на lux, ki - единиц выхода на lux в секунду;
+    // повторный вызов с теми же значениями ничего не пересчитывает
+    void configure(float kp, float ki, uint16_t outMax);
+    void reset(uint16_t output = 0);     // безударный старт с заданного выхода
+    // dtMs - от предыдущего измерения; 0 у первого после reset(): только П-часть
+    uint16_t update(float setpoint, float measurement, uint32_t dtMs);
+    uint16_t getOutput() const { return output; }
+    PiStats getStats() const;
+
+private:
+    static const int32_t LUX_SHIFT = 4;
+    static const int32_t GAIN_SHIFT = 16;
+    static const int32_t KI_SHIFT = 24;
+    static const uint32_t MAX_DT_MS = 65535;   // длиннее - пропуск в данных, не шаг
+
+    float kp = -1.0;
+    float ki = -1.0;
+    int32_t kpQ16 = 0;
+    int32_t kiQ24 = 0;           // прибавка интеграла за мс на lux ошибки
+    int32_t outMaxQ16 = 0;
+    int32_t integralQ16 = 0;
+    int32_t errorQ4 = 0;
+    uint16_t outMax = 0;
+    uint16_t output = 0;
+    uint32_t updates = 0;
+    uint32_t saturated = 0;
+};
+
+#endif
@@ -13,10 +13,8 @@ void RGBLed::setColor(uint8_t r, uint8_t g, uint8_t b) {
     FastLED.show();
 }
 
+// Частоту обновления задает планировщик (RGB_UPDATE_INTERVAL)
 void RGBLed::setStatus(bool relayState, bool autoMode, float lux, float threshold) {
-    if (millis() - lastUpdate < 500) return; // Обновляем не чаще 2 раз в секунду
-    lastUpdate = millis();
-
     if (relayState) {
         // Реле ВКЛ - ЗЕЛЕНЫЙ
         setColor(0, 255, 0);
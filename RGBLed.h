@@ -16,7 +16,6 @@ public:
 
 private:
     CRGB leds[1]; // Один светодиод
-    unsigned long lastUpdate = 0;
 };
 
 #endif
\ No newline at end of file
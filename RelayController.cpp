@@ -1,43 +1,67 @@
 // RelayController.cpp
 #include "RelayController.h"
-#include "Config.h"
 #include "DebugLogger.h"
+#include "EventTrace.h"
+#include "Metrics.h"
+#include <limits.h>
 
-RelayController::RelayController(uint8_t pin) : relayPin(pin) {}
+RelayController::RelayController(const uint8_t* pins) : relayPins(pins) {}
 
-void RelayController::begin() {
-    pinMode(relayPin, OUTPUT);
-    turnOff(); // Начинаем с выключенного состояния
-    DEBUG_LOG("✅ Контроллер реле инициализирован на пине " + String(relayPin));
+void RelayController::begin(uint8_t zones) {
+    count = zones < 1 ? 1 : zones > MAX_ZONES ? MAX_ZONES : zones;
+    for (uint8_t zone = 0; zone < count; zone++) {
+        pinMode(relayPins[zone], OUTPUT);
+        // Начинаем с выключенного состояния
+        digitalWrite(relayPins[zone], LOW);
+        states[zone] = false;
+        DEBUG_LOGF(LOG_MODULE_RELAY, "✅ Реле зоны %u на пине %u", zone, relayPins[zone]);
+    }
 }
 
-void RelayController::turnOn() {
-    if (!currentState) {
-        digitalWrite(relayPin, HIGH);
-        currentState = true;
-        EVENT_LOG("💡 Реле ВКЛЮЧЕНО");
-        DEBUG_LOG("🔌 Реле: ВКЛ");
+void RelayController::turnOn(uint8_t zone) {
+    if (zone < count && !states[zone]) {
+        digitalWrite(relayPins[zone], HIGH);
+        states[zone] = true;
+        EventTrace::record(TRACE_RELAY_ON, zone, millis() - lastChange[zone]);
+        Metrics::count(METRIC_RELAY_SWITCHES);
+        lastChange[zone] = millis();
+        switched[zone] = true;
+        EVENT_LOGF(LOG_MODULE_RELAY, "💡 Реле %u ВКЛЮЧЕНО", zone);
+        DEBUG_LOGF(LOG_MODULE_RELAY, "🔌 Реле %u: ВКЛ", zone);
     }
 }
 
-void RelayController::turnOff() {
-    if (currentState) {
-        digitalWrite(relayPin, LOW);
-        currentState = false;
-        EVENT_LOG("💡 Реле ВЫКЛЮЧЕНО");
-        DEBUG_LOG("🔌 Реле: ВЫКЛ");
+void RelayController::turnOff(uint8_t zone) {
+    if (zone < count && states[zone]) {
+        digitalWrite(relayPins[zone], LOW);
+        states[zone] = false;
+        EventTrace::record(TRACE_RELAY_OFF, zone, millis() - lastChange[zone]);
+        Metrics::count(METRIC_RELAY_SWITCHES);
+        lastChange[zone] = millis();
+        switched[zone] = true;
+        EVENT_LOGF(LOG_MODULE_RELAY, "💡 Реле %u ВЫКЛЮЧЕНО", zone);
+        DEBUG_LOGF(LOG_MODULE_RELAY, "🔌 Реле %u: ВЫКЛ", zone);
     }
 }
 
-void RelayController::toggle() {
-    if (currentState) turnOff();
-    else turnOn();
+void RelayController::toggle(uint8_t zone) {
+    if (getState(zone)) turnOff(zone);
+    else turnOn(zone);
+}
+
+bool RelayController::getState(uint8_t zone) {
+    return zone < count && states[zone];
 }
 
-bool RelayController::getState() {
-    return currentState;
+unsigned long RelayController::getStateAge(uint8_t zone) {
+    if (zone >= count) zone = 0;
+    return switched[zone] ? millis() - lastChange[zone] : ULONG_MAX;
 }
 
-String RelayController::getStateString() {
-    return currentState ? "ON" : "OFF";
-}
\ No newline at end of file
+void RelayController::forgetSwitches() {
+    for (uint8_t zone = 0; zone < MAX_ZONES; zone++) switched[zone] = false;
+}
+
+String RelayController::getStateString(uint8_t zone) {
+    return getState(zone) ? "ON" : "OFF";
+}
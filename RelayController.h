@@ -3,20 +3,31 @@
 #define RELAY_CONTROLLER_H
 
 #include <Arduino.h>
+#include "Config.h"
 
+// Реле всех зон: состояние и время переключения - массивы по номеру зоны.
+// Вызовы без номера относятся к зоне 0
 class RelayController {
 public:
-    RelayController(uint8_t pin);
-    void begin();
-    void turnOn();
-    void turnOff();
-    void toggle();
-    bool getState();
-    String getStateString();
+    RelayController(const uint8_t* pins);   // MAX_ZONES пинов, pins[0] - реле зоны 0
+    void begin(uint8_t zones = 1);
+    void turnOn(uint8_t zone = 0);
+    void turnOff(uint8_t zone = 0);
+    void toggle(uint8_t zone = 0);
+    bool getState(uint8_t zone = 0);
+    // мс в текущем состоянии; без переключений с загрузки - ULONG_MAX: после сброса
+    // minOnTime/minOffTime уже выдержаны, иначе лампа ждала бы их от millis() == 0
+    unsigned long getStateAge(uint8_t zone = 0);
+    void forgetSwitches();                          // тест реле в setup() не в счет
+    String getStateString(uint8_t zone = 0);
+    uint8_t getCount() const { return count; }
 
 private:
-    uint8_t relayPin;
-    bool currentState = false;
+    const uint8_t* relayPins;
+    uint8_t count = 1;
+    bool states[MAX_ZONES] = {};
+    unsigned long lastChange[MAX_ZONES] = {};   // millis() последнего переключения
+    bool switched[MAX_ZONES] = {};              // было ли переключение с загрузки
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,127 @@
+// Schedule.cpp
+#include "Schedule.h"
+
+static const char* const DAY_NAMES[7] = {"Mo", "Tu", "We", "Th", "Fr", "Sa", "Su"};
+
+static bool isDigitChar(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static void skipSpaces(const char*& p) {
+    while (*p == ' ') p++;
+}
+
+// "HH:MM" строго по два знака; 24:00 допустимо только как конец окна
+static bool parseTime(const char*& p, bool end, uint16_t& minute) {
+    if (!isDigitChar(p[0]) || !isDigitChar(p[1]) || p[2] != ':' || !isDigitChar(p[3]) || !isDigitChar(p[4])) {
+        return false;
+    }
+    int hours = (p[0] - '0') * 10 + (p[1] - '0');
+    int minutes = (p[3] - '0') * 10 + (p[4] - '0');
+    if (minutes > 59 || hours > 24 || (hours == 24 && (!end || minutes != 0))) return false;
+    minute = hours * 60 + minutes;
+    p += 5;
+    return true;
+}
+
+static bool parseDay(const char*& p, uint8_t& day) {
+    for (uint8_t d = 0; d < 7; d++) {
+        if (p[0] == DAY_NAMES[d][0] && p[1] == DAY_NAMES[d][1]) {
+            day = d;
+            p += 2;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "Mo-Fr,Su" -> биты дней 0..6
+static bool parseDays(const char*& p, uint8_t& days) {
+    days = 0;
+    for (;;) {
+        uint8_t first, last;
+        if (!parseDay(p, first)) return false;
+        last = first;
+        if (*p == '-') {
+            p++;
+            if (!parseDay(p, last)) return false;
+        }
+        // Диапазон может переходить через воскресенье: "Sa-Mo"
+        for (uint8_t d = first;; d = (d + 1) % 7) {
+            days |= 1 << d;
+            if (d == last) break;
+        }
+        if (*p != ',') return true;
+        p++;
+    }
+}
+
+void Schedule::setRange(uint8_t weekday, uint16_t from, uint16_t to) {
+    for (uint16_t m = from; m < to; m++) bits[weekday][m >> 5] |= 1UL << (m & 31);
+}
+
+bool Schedule::compile(const char* text, Schedule* out) {
+    Schedule result;
+    memset(result.bits, 0, sizeof(result.bits));
+    const char* p = text;
+    skipSpaces(p);
+    if (!*p) return false;
+
+    for (;;) {
+        uint8_t days = 0x7F;
+        if (!isDigitChar(*p)) {
+            if (!parseDays(p, days) || *p != ' ') return false;
+            skipSpaces(p);
+        }
+        for (;;) {
+            uint16_t from, to;
+            if (!parseTime(p, false, from) || *p++ != '-' || !parseTime(p, true, to) || from == to) return false;
+            for (uint8_t d = 0; d < 7; d++) {
+                if (!(days & (1 << d))) continue;
+                if (from < to) {
+                    result.setRange(d, from, to);
+                } else {
+                    result.setRange(d, from, MINUTES_PER_DAY);
+                    result.setRange((d + 1) % 7, 0, to);
+                }
+            }
+            skipSpaces(p);
+            if (*p != ',') break;
+            p++;
+            skipSpaces(p);
+        }
+        if (!*p) break;
+        if (*p++ != ';') return false;
+        skipSpaces(p);
+    }
+
+    if (out) memcpy(out->bits, result.bits, sizeof(result.bits));
+    return true;
+}
+
+const char* Schedule::getDayName(uint8_t weekday) {
+    return DAY_NAMES[weekday % 7];
+}
+
+// Слова целиком считаются popcount, края окна - по маске
+uint16_t Schedule::countActive(uint8_t weekday, uint16_t from, uint16_t to) const {
+    uint16_t minutes = 0;
+    while (from < to) {
+        uint8_t w = from >> 5;
+        uint8_t first = from & 31;
+        uint8_t last = to - (w << 5) < 32 ? to - (w << 5) : 32;
+        uint32_t word = bits[weekday][w] >> first;
+        if (last - first < 32) word &= (1UL << (last - first)) - 1;
+        minutes += __builtin_popcount(word);
+        from = (w << 5) + last;
+    }
+    return minutes;
+}
+
+uint16_t Schedule::getMinutesPerWeek() const {
+    uint16_t minutes = 0;
+    for (uint8_t d = 0; d < 7; d++) {
+        for (uint8_t w = 0; w < WORDS_PER_DAY; w++) minutes += __builtin_popcount(bits[d][w]);
+    }
+    return minutes;
+}
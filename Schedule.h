@@ -0,0 +1,38 @@
+// Schedule.h
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <Arduino.h>
+
+// Фотопериод, разобранный в битовую карту "минута суток" для каждого дня недели.
+// Текст разбирается один раз при загрузке или изменении настроек, основной цикл
+// проверяет один бит. Формат (группы через ';', окна через ','):
+//   "08:00-20:00"                          каждый день
+//   "06:00-10:00,16:00-22:00"              два окна
+//   "Mo-Fr 07:00-21:00;Sa,Su 09:00-18:00"  по дням недели (Mo Tu We Th Fr Sa Su)
+// Конец 24:00 - до полуночи; окно "22:00-06:00" переходит на следующий день.
+// Группы объединяются
+class Schedule {
+public:
+    static const uint16_t MINUTES_PER_DAY = 1440;
+
+    // false - синтаксическая ошибка, out не меняется; out == nullptr - только проверка
+    static bool compile(const char* text, Schedule* out);
+
+    // weekday: 0 - понедельник
+    bool isActive(uint8_t weekday, uint16_t minute) const {
+        return (bits[weekday][minute >> 5] >> (minute & 31)) & 1;
+    }
+    uint16_t getMinutesPerWeek() const;   // для лога и трассировки
+    // Минут фотопериода в [from, to) одного дня
+    uint16_t countActive(uint8_t weekday, uint16_t from, uint16_t to) const;
+    static const char* getDayName(uint8_t weekday);
+
+private:
+    static const uint8_t WORDS_PER_DAY = MINUTES_PER_DAY / 32;
+    void setRange(uint8_t weekday, uint16_t from, uint16_t to);
+
+    uint32_t bits[7][WORDS_PER_DAY];
+};
+
+#endif
@@ -0,0 +1,240 @@
+// Scheduler.cpp
+#include "Scheduler.h"
+#include <esp_timer.h>
+
+Scheduler scheduler;
+
+int8_t Scheduler::addTask(const char* name, uint32_t periodMs, const uint32_t* periodRef,
+                          bool oneShot, TaskCallback callback) {
+    // Слоты завершенных однократных задач используются повторно
+    int8_t id = INVALID_TASK;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i].callback == nullptr) {
+            id = i;
+            break;
+        }
+    }
+    if (id == INVALID_TASK) {
+        if (taskCount >= MAX_TASKS) {
+            Serial.println("❌ Планировщик: нет свободных слотов для " + String(name));
+            return INVALID_TASK;
+        }
+        id = taskCount++;
+    }
+
+    Task& task = tasks[id];
+    task = Task();
+    task.name = name;
+    task.callback = callback;
+    task.period = periodMs;
+    task.periodRef = periodRef;
+    task.oneShot = oneShot;
+    // Периодические задачи стартуют сразу, однократные - через заданную задержку
+    task.deadline = esp_timer_get_time() + (oneShot ? (int64_t)periodMs * 1000 : 0);
+    heapPush(id);
+    return id;
+}
+
+int8_t Scheduler::every(const char* name, const uint32_t* periodMs, TaskCallback callback) {
+    return addTask(name, 0, periodMs, false, callback);
+}
+
+int8_t Scheduler::every(const char* name, uint32_t periodMs, TaskCallback callback) {
+    return addTask(name, periodMs, nullptr, false, callback);
+}
+
+int8_t Scheduler::after(const char* name, uint32_t delayMs, TaskCallback callback) {
+    return addTask(name, delayMs, nullptr, true, callback);
+}
+
+uint32_t Scheduler::periodOf(const Task& task) const {
+    uint32_t period = task.periodRef ? *task.periodRef : task.period;
+    return period > 0 ? period : 1;
+}
+
+void Scheduler::setPeriod(int8_t id, uint32_t periodMs) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].period = periodMs;
+    tasks[id].periodRef = nullptr;
+}
+
+void Scheduler::trigger(int8_t id) {
+    if (id < 0 || id >= taskCount || tasks[id].callback == nullptr) return;
+    heapRemove(id);
+    tasks[id].deadline = esp_timer_get_time();
+    heapPush(id);
+    wake();
+}
+
+// Куча принадлежит основному циклу: чужая задача только ставит бит и будит его
+void Scheduler::triggerFromTask(int8_t id) {
+    if (id < 0 || id >= MAX_TASKS) return;
+    __atomic_fetch_or(&pendingTriggers, 1UL << id, __ATOMIC_RELEASE);
+    wake();
+}
+
+void Scheduler::cancel(int8_t id) {
+    if (id < 0 || id >= taskCount) return;
+    heapRemove(id);
+    tasks[id].callback = nullptr;
+}
+
+void Scheduler::run() {
+    runDue();
+    sleepUntilNext();
+}
+
+void Scheduler::runDue() {
+    uint32_t triggered = __atomic_exchange_n(&pendingTriggers, 0, __ATOMIC_ACQUIRE);
+    for (int8_t id = 0; triggered != 0; id++, triggered >>= 1) {
+        if ((triggered & 1) && id < taskCount && tasks[id].callback != nullptr) {
+            heapRemove(id);
+            tasks[id].deadline = esp_timer_get_time();
+            heapPush(id);
+        }
+    }
+
+    int64_t now = esp_timer_get_time();
+
+    while (heapSize > 0 && tasks[heap[0]].deadline <= now) {
+        int8_t id = heap[0];
+        Task& task = tasks[id];
+        heapRemove(id);
+
+        uint32_t jitter = (uint32_t)(now - task.deadline);
+        task.stats.runs++;
+        task.stats.lastJitterUs = jitter;
+        task.stats.totalJitterUs += jitter;
+        if (jitter > task.stats.maxJitterUs) task.stats.maxJitterUs = jitter;
+
+        TaskCallback callback = task.callback;
+        int64_t started = esp_timer_get_time();
+        callback();
+        now = esp_timer_get_time();
+
+        uint32_t runUs = (uint32_t)(now - started);
+        task.stats.lastRunUs = runUs;
+        if (runUs > task.stats.maxRunUs) task.stats.maxRunUs = runUs;
+
+        // Задачу могли отменить или перезапустить из ее же обработчика
+        if (task.callback != callback || task.heapIndex >= 0) continue;
+
+        if (task.oneShot) {
+            task.callback = nullptr;
+            continue;
+        }
+
+        // Следующий срок отсчитывается от предыдущего, а не от момента запуска,
+        // чтобы опоздания не накапливались; пропущенные периоды считаются overrun
+        int64_t period = (int64_t)periodOf(task) * 1000;
+        int64_t next = task.deadline + period;
+        if (next <= now) {
+            int64_t missed = (now - task.deadline) / period;
+            task.stats.overruns += (uint32_t)missed;
+            next = task.deadline + (missed + 1) * period;
+        }
+        task.deadline = next;
+        heapPush(id);
+    }
+}
+
+void Scheduler::sleepUntilNext() {
+    if (loopTask == nullptr) loopTask = xTaskGetCurrentTaskHandle();
+    if (heapSize == 0) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        return;
+    }
+
+    int64_t wait = tasks[heap[0]].deadline - esp_timer_get_time();
+    if (wait <= 0) return;
+
+    // Тик FreeRTOS - 1 мс: округляем вверх, чтобы не проснуться раньше срока
+    TickType_t ticks = (TickType_t)((wait + 999) / 1000);
+    ulTaskNotifyTake(pdTRUE, ticks);
+}
+
+void Scheduler::wake() {
+    if (loopTask != nullptr) xTaskNotifyGive(loopTask);
+}
+
+void Scheduler::wakeFromISR() {
+    if (loopTask == nullptr) return;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(loopTask, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) portYIELD_FROM_ISR();
+}
+
+const char* Scheduler::getTaskName(int8_t id) const {
+    return (id >= 0 && id < taskCount) ? tasks[id].name : nullptr;
+}
+
+const Scheduler::TaskStats* Scheduler::getStats(int8_t id) const {
+    return (id >= 0 && id < taskCount) ? &tasks[id].stats : nullptr;
+}
+
+uint32_t Scheduler::getPeriod(int8_t id) const {
+    if (id < 0 || id >= taskCount || tasks[id].oneShot) return 0;
+    return periodOf(tasks[id]);
+}
+
+int64_t Scheduler::getNextDeadline() const {
+    return heapSize > 0 ? tasks[heap[0]].deadline : -1;
+}
+
+// === Min-куча по сроку ===
+
+bool Scheduler::earlier(uint8_t a, uint8_t b) const {
+    return tasks[heap[a]].deadline < tasks[heap[b]].deadline;
+}
+
+void Scheduler::heapSwap(uint8_t a, uint8_t b) {
+    int8_t tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+    tasks[heap[a]].heapIndex = a;
+    tasks[heap[b]].heapIndex = b;
+}
+
+void Scheduler::siftUp(uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!earlier(pos, parent)) break;
+        heapSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+void Scheduler::siftDown(uint8_t pos) {
+    while (true) {
+        uint8_t left = pos * 2 + 1;
+        uint8_t right = left + 1;
+        uint8_t smallest = pos;
+        if (left < heapSize && earlier(left, smallest)) smallest = left;
+        if (right < heapSize && earlier(right, smallest)) smallest = right;
+        if (smallest == pos) break;
+        heapSwap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void Scheduler::heapPush(int8_t id) {
+    if (tasks[id].heapIndex >= 0) return;
+    uint8_t pos = heapSize++;
+    heap[pos] = id;
+    tasks[id].heapIndex = pos;
+    siftUp(pos);
+}
+
+void Scheduler::heapRemove(int8_t id) {
+    int8_t pos = tasks[id].heapIndex;
+    if (pos < 0) return;
+    uint8_t last = --heapSize;
+    if (pos != last) {
+        heapSwap(pos, last);
+        tasks[id].heapIndex = -1;
+        siftDown(pos);
+        siftUp(pos);
+    } else {
+        tasks[id].heapIndex = -1;
+    }
+}
@@ -0,0 +1,82 @@
+// Scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Кооперативный планировщик: задачи по сроку в min-куче,
+// loop() спит ровно до ближайшего срока или до wake()
+class Scheduler {
+public:
+    typedef void (*TaskCallback)();
+
+    static const uint8_t MAX_TASKS = 16;
+    static const int8_t INVALID_TASK = -1;
+
+    struct TaskStats {
+        uint32_t runs = 0;
+        uint32_t overruns = 0;       // пропущенные периоды (опоздание >= периода)
+        uint32_t lastJitterUs = 0;   // опоздание старта относительно срока
+        uint32_t maxJitterUs = 0;
+        uint64_t totalJitterUs = 0;
+        uint32_t lastRunUs = 0;      // длительность выполнения
+        uint32_t maxRunUs = 0;
+    };
+
+    // Периодическая задача; период берется из *periodMs при каждом перепланировании,
+    // поэтому изменения config.* применяются без перерегистрации
+    int8_t every(const char* name, const uint32_t* periodMs, TaskCallback callback);
+    int8_t every(const char* name, uint32_t periodMs, TaskCallback callback);
+    // Однократная задача через delayMs
+    int8_t after(const char* name, uint32_t delayMs, TaskCallback callback);
+
+    void setPeriod(int8_t id, uint32_t periodMs);
+    void trigger(int8_t id);          // выполнить задачу как можно скорее
+    void triggerFromTask(int8_t id);  // то же из другой задачи или с другого ядра
+    void cancel(int8_t id);
+
+    void run();                       // выполнить все наступившие задачи и уснуть до следующей
+    void runDue();
+    void sleepUntilNext();
+    void wake();                      // разбудить loop() из другой задачи
+    void wakeFromISR();
+
+    uint8_t getTaskCount() const { return taskCount; }
+    const char* getTaskName(int8_t id) const;
+    const TaskStats* getStats(int8_t id) const;
+    uint32_t getPeriod(int8_t id) const;
+    int64_t getNextDeadline() const;
+
+private:
+    struct Task {
+        const char* name = nullptr;
+        TaskCallback callback = nullptr;
+        uint32_t period = 0;
+        const uint32_t* periodRef = nullptr;
+        bool oneShot = false;
+        int64_t deadline = 0;        // мкс, esp_timer_get_time()
+        int8_t heapIndex = -1;       // -1: задача не запланирована
+        TaskStats stats;
+    };
+
+    int8_t addTask(const char* name, uint32_t periodMs, const uint32_t* periodRef,
+                   bool oneShot, TaskCallback callback);
+    uint32_t periodOf(const Task& task) const;
+    void heapPush(int8_t id);
+    void heapRemove(int8_t id);
+    void heapSwap(uint8_t a, uint8_t b);
+    void siftUp(uint8_t pos);
+    void siftDown(uint8_t pos);
+    bool earlier(uint8_t a, uint8_t b) const;
+
+    Task tasks[MAX_TASKS];
+    int8_t heap[MAX_TASKS];
+    uint8_t taskCount = 0;
+    uint8_t heapSize = 0;
+    TaskHandle_t loopTask = nullptr;
+    uint32_t pendingTriggers = 0;     // биты задач от triggerFromTask(), разбирает runDue()
+};
+
+extern Scheduler scheduler;
+
+#endif
@@ -0,0 +1,86 @@
+// SensorHealth.cpp
+#include "SensorHealth.h"
+#include "Config.h"
+
+bool SensorHealth::onSuccess(uint32_t now) {
+    consecutive = 0;
+    if (state == SENSOR_HEALTHY) return false;
+    if (isLost()) {
+        uint32_t ms = now - lostAt;
+        stats.recoveries++;
+        stats.lastRecoveryMs = ms;
+        if (ms > stats.maxRecoveryMs) stats.maxRecoveryMs = ms;
+        stats.downtimeMs += ms;
+        backoff = 0;
+    }
+    state = SENSOR_HEALTHY;
+    return true;
+}
+
+bool SensorHealth::onFailure(uint32_t now) {
+    stats.failures++;
+    if (consecutive < 255) consecutive++;
+    switch (state) {
+        case SENSOR_HEALTHY:
+        case SENSOR_DEGRADED:
+            if (consecutive < SENSOR_LOST_FAILURES) {
+                bool changed = state != SENSOR_DEGRADED;
+                state = SENSOR_DEGRADED;
+                return changed;
+            }
+            markLost(now);
+            return true;
+        case SENSOR_RECOVERING:
+            // Ответил на поиск, но не измеряет - попытка не удалась
+            onReconnectFailed(now);
+            return true;
+        case SENSOR_LOST:
+            break;
+    }
+    return false;
+}
+
+void SensorHealth::markLost(uint32_t now) {
+    state = SENSOR_LOST;
+    lostAt = now;
+    backoff = SENSOR_BACKOFF_MIN;
+    retryAt = now + backoff;
+    stats.losses++;
+}
+
+bool SensorHealth::isRetryDue(uint32_t now) const {
+    return state == SENSOR_LOST && (int32_t)(now - retryAt) >= 0;
+}
+
+void SensorHealth::onReconnect(uint32_t now) {
+    (void)now;
+    stats.attempts++;
+    state = SENSOR_RECOVERING;
+}
+
+void SensorHealth::onReconnectFailed(uint32_t now) {
+    stats.attempts += state == SENSOR_LOST;   // из RECOVERING попытка уже посчитана
+    state = SENSOR_LOST;
+    backoff = backoff * 2 > SENSOR_BACKOFF_MAX ? SENSOR_BACKOFF_MAX : backoff * 2;
+    retryAt = now + backoff;
+}
+
+uint32_t SensorHealth::getRetryIn(uint32_t now) const {
+    if (state != SENSOR_LOST) return 0;
+    int32_t left = (int32_t)(retryAt - now);
+    return left > 0 ? left : 0;
+}
+
+uint32_t SensorHealth::getLostMs(uint32_t now) const {
+    return isLost() ? now - lostAt : 0;
+}
+
+const char* SensorHealth::getStateName(SensorHealthState state) {
+    switch (state) {
+        case SENSOR_HEALTHY: return "healthy";
+        case SENSOR_DEGRADED: return "degraded";
+        case SENSOR_LOST: return "lost";
+        case SENSOR_RECOVERING: return "recovering";
+    }
+    return "";
+}
@@ -0,0 +1,57 @@
+// SensorHealth.h
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+#include <Arduino.h>
+
+enum SensorHealthState : uint8_t {
+    SENSOR_HEALTHY,       // последнее измерение удачно
+    SENSOR_DEGRADED,      // ошибки подряд, но меньше SENSOR_LOST_FAILURES - опрос идет как обычно
+    SENSOR_LOST,          // датчик не опрашивается, ждет следующей попытки восстановления
+    SENSOR_RECOVERING     // датчик снова найден, ждет первого удачного измерения
+};
+
+struct SensorHealthStats {
+    uint32_t failures = 0;         // ошибок запуска и чтения всего
+    uint32_t losses = 0;           // переходов в SENSOR_LOST из работы
+    uint32_t attempts = 0;         // попыток восстановления
+    uint32_t busClears = 0;        // попыток, когда SDA была занята и SCL щелкали вручную
+    uint32_t recoveries = 0;
+    uint32_t lastRecoveryMs = 0;   // от потери до первого удачного измерения
+    uint32_t maxRecoveryMs = 0;
+    uint32_t downtimeMs = 0;       // суммарно без датчика, завершенные потери
+};
+
+// Состояние датчика зоны и расписание попыток восстановления. Сам на шину
+// не ходит: LightSensor сообщает об исходе каждого измерения и попытки.
+// Интервал между попытками растет вдвое от SENSOR_BACKOFF_MIN до SENSOR_BACKOFF_MAX
+// и сбрасывается после восстановления. true из onSuccess()/onFailure() - состояние сменилось
+class SensorHealth {
+public:
+    bool onSuccess(uint32_t now);
+    bool onFailure(uint32_t now);
+    bool isRetryDue(uint32_t now) const;
+    void onReconnect(uint32_t now);         // LOST -> RECOVERING: датчик снова ответил
+    void onReconnectFailed(uint32_t now);   // остается LOST, следующая попытка через удвоенный интервал
+    void markLost(uint32_t now);            // датчика нет с загрузки
+    void countBusClear() { stats.busClears++; }
+
+    SensorHealthState getState() const { return state; }
+    bool isLost() const { return state == SENSOR_LOST || state == SENSOR_RECOVERING; }
+    uint8_t getConsecutiveFailures() const { return consecutive; }
+    uint32_t getBackoff() const { return backoff; }
+    uint32_t getRetryIn(uint32_t now) const;     // 0 - попытка уже разрешена
+    uint32_t getLostMs(uint32_t now) const;      // 0 - датчик не потерян
+    const SensorHealthStats& getStats() const { return stats; }
+    static const char* getStateName(SensorHealthState state);
+
+private:
+    SensorHealthState state = SENSOR_HEALTHY;
+    uint8_t consecutive = 0;
+    uint32_t lostAt = 0;
+    uint32_t retryAt = 0;
+    uint32_t backoff = 0;
+    SensorHealthStats stats;
+};
+
+#endif
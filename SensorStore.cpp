@@ -0,0 +1,257 @@
+// SensorStore.cpp
+#include "SensorStore.h"
+#include "Metrics.h"
+#include <LittleFS.h>
+
+static const char* SENSOR_DIR = "/logs/sensor";
+static const char* SENSOR_HEAD_PATH = "/logs/sensor/head";
+static const uint32_t SEGMENT_MAGIC = 0x31525350;   // "PSR1"
+static const uint32_t HEAD_MAGIC = 0x31485350;      // "PSH1"
+static const uint32_t SEGMENT_BYTES = 4096;
+
+// Указатель на текущий сегмент: пишется при смене сегмента и при загрузке
+struct HeadRecord {
+    uint32_t magic;
+    uint32_t sequence;
+    uint16_t segmentCount;
+    uint16_t bootCount;
+};
+
+uint16_t SensorStore::segmentCount = 0;
+uint32_t SensorStore::headSequence = 0;
+uint16_t SensorStore::headRecords = 0;
+uint16_t SensorStore::bootCount = 0;
+bool SensorStore::ready = false;
+
+// Открытый на дозапись текущий сегмент
+static File headFile;
+
+// Дозапись идет из основного цикла (ядро 1), чтение - из веб-задачи (ядро 0).
+// Под замком меняются headSequence/headRecords и пересоздается сегмент;
+// читатель берет его на каждую порцию, а callback вызывает уже без замка
+static SemaphoreHandle_t storeLock = nullptr;
+
+struct StoreGuard {
+    StoreGuard() { if (storeLock) xSemaphoreTake(storeLock, portMAX_DELAY); }
+    ~StoreGuard() { if (storeLock) xSemaphoreGive(storeLock); }
+};
+
+static uint32_t countRecords(uint32_t sequence, uint16_t records, uint16_t segments) {
+    uint32_t fullSegments = sequence < (uint32_t)(segments - 1) ? sequence : segments - 1;
+    return fullSegments * SensorStore::RECORDS_PER_SEGMENT + records;
+}
+
+bool SensorStore::begin(uint32_t budgetBytes) {
+    if (storeLock == nullptr) storeLock = xSemaphoreCreateMutex();
+    segmentCount = budgetBytes / SEGMENT_BYTES;
+    if (segmentCount < 2) segmentCount = 2;
+
+    LittleFS.mkdir(SENSOR_DIR);
+
+    if (!loadHead()) {
+        Serial.println("📊 Хранилище показаний создается заново");
+        clear();
+    }
+
+    bootCount++;
+    saveHead();
+    ready = (bool)headFile;
+    return ready;
+}
+
+String SensorStore::segmentPath(uint32_t sequence) {
+    return String(SENSOR_DIR) + "/s" + String(sequence % segmentCount) + ".bin";
+}
+
+bool SensorStore::openSegment(uint32_t sequence, bool create) {
+    headFile.close();
+    String path = segmentPath(sequence);
+
+    if (!create) {
+        headFile = LittleFS.open(path, "a");
+        return (bool)headFile;
+    }
+
+    // Пересоздание файла - это и есть удаление самого старого сегмента кольца
+    headFile = LittleFS.open(path, "w");
+    if (!headFile) {
+        Serial.println("❌ Ошибка создания сегмента: " + path);
+        return false;
+    }
+    SegmentHeader header = {SEGMENT_MAGIC, sequence};
+    headFile.write((const uint8_t*)&header, sizeof(header));
+    headFile.flush();
+    return true;
+}
+
+bool SensorStore::loadHead() {
+    File file = LittleFS.open(SENSOR_HEAD_PATH, "r");
+    if (!file) return false;
+    HeadRecord head;
+    size_t n = file.read((uint8_t*)&head, sizeof(head));
+    file.close();
+
+    // Другой бюджет - другое число сегментов, старое кольцо не совместимо
+    if (n != sizeof(head) || head.magic != HEAD_MAGIC || head.segmentCount != segmentCount) {
+        return false;
+    }
+    headSequence = head.sequence;
+    bootCount = head.bootCount;
+
+    File segment = LittleFS.open(segmentPath(headSequence), "r");
+    if (!segment) return false;
+    SegmentHeader header;
+    bool valid = segment.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == SEGMENT_MAGIC && header.sequence == headSequence;
+    size_t size = segment.size();
+    segment.close();
+    if (!valid) return false;
+
+    size_t payload = size - sizeof(SegmentHeader);
+    if (payload % sizeof(SensorRecord) != 0 || payload / sizeof(SensorRecord) > RECORDS_PER_SEGMENT) {
+        // Запись оборвалась на середине (питание) - начинаем следующий сегмент
+        headSequence++;
+        headRecords = 0;
+        return openSegment(headSequence, true);
+    }
+    headRecords = payload / sizeof(SensorRecord);
+    return openSegment(headSequence, false);
+}
+
+void SensorStore::saveHead() {
+    File file = LittleFS.open(SENSOR_HEAD_PATH, "w");
+    if (!file) return;
+    HeadRecord head = {HEAD_MAGIC, headSequence, segmentCount, bootCount};
+    file.write((const uint8_t*)&head, sizeof(head));
+    file.close();
+}
+
+bool SensorStore::append(float lux, bool relayState, bool autoMode) {
+    if (!ready) return false;
+
+    SensorRecord record;
+    record.timestamp = millis();
+    record.lux = lux;
+    record.flags = (relayState ? SENSOR_FLAG_RELAY : 0) | (autoMode ? SENSOR_FLAG_AUTO : 0);
+    record.bootCount = bootCount;
+
+    StoreGuard guard;
+    if (headRecords >= RECORDS_PER_SEGMENT) {
+        if (!openSegment(headSequence + 1, true)) {
+            ready = false;
+            return false;
+        }
+        headSequence++;
+        headRecords = 0;
+        saveHead();
+    }
+
+    if (headFile.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+        return false;
+    }
+    headFile.flush();
+    headRecords++;
+    Metrics::count(METRIC_SENSOR_STORE_BYTES, sizeof(record));
+    return true;
+}
+
+uint32_t SensorStore::readLatest(uint32_t maxRecords, RecordCallback callback, void* context) {
+    if (!ready) return 0;
+
+    // Границы - снимок: записи, добавленные во время обхода, не читаются
+    uint32_t head;
+    uint16_t records;
+    {
+        StoreGuard guard;
+        head = headSequence;
+        records = headRecords;
+    }
+
+    uint32_t fullSegments = head < (uint32_t)(segmentCount - 1) ? head : segmentCount - 1;
+    uint32_t total = countRecords(head, records, segmentCount);
+    uint32_t skip = total > maxRecords ? total - maxRecords : 0;
+    uint32_t visited = 0;
+    SensorRecord buffer[16];
+
+    for (uint32_t seq = head - fullSegments; seq <= head; seq++) {
+        uint32_t inSegment = (seq == head) ? records : RECORDS_PER_SEGMENT;
+        if (skip >= inSegment) {
+            skip -= inSegment;
+            continue;
+        }
+
+        File file;
+        uint32_t left = inSegment - skip;
+        uint32_t offset = skip;
+        skip = 0;
+        while (left > 0) {
+            uint32_t chunk = left < 16 ? left : 16;
+            size_t got = 0;
+            {
+                StoreGuard guard;
+                // Пока читали прошлые порции, кольцо обошло круг и пересоздало этот файл
+                if (headSequence >= seq + segmentCount) break;
+                if (!file) {
+                    file = LittleFS.open(segmentPath(seq), "r");
+                    if (!file) break;
+                    SegmentHeader header;
+                    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+                        header.magic != SEGMENT_MAGIC || header.sequence != seq) {
+                        break;
+                    }
+                    file.seek(sizeof(SegmentHeader) + offset * sizeof(SensorRecord));
+                }
+                got = file.read((uint8_t*)buffer, chunk * sizeof(SensorRecord)) / sizeof(SensorRecord);
+            }
+            for (size_t i = 0; i < got; i++) {
+                callback(buffer[i], context);
+            }
+            visited += got;
+            if (got < chunk) break;
+            left -= chunk;
+        }
+        file.close();
+    }
+    return visited;
+}
+
+String SensorStore::formatRecord(const SensorRecord& record) {
+    return "[" + String(record.timestamp) + "] LUX:" + String(record.lux, 2) +
+           " RELAY:" + ((record.flags & SENSOR_FLAG_RELAY) ? "ON" : "OFF") +
+           " MODE:" + ((record.flags & SENSOR_FLAG_AUTO) ? "AUTO" : "MANUAL") +
+           " BOOT:" + String(record.bootCount);
+}
+
+void SensorStore::clear() {
+    StoreGuard guard;
+    headFile.close();
+    
+    // Удаляем все сегменты, включая оставшиеся от кольца с другим бюджетом
+    File dir = LittleFS.open(SENSOR_DIR);
+    if (dir && dir.isDirectory()) {
+        File entry;
+        while ((entry = dir.openNextFile())) {
+            String path = entry.path();
+            entry.close();
+            if (path != SENSOR_HEAD_PATH) LittleFS.remove(path);
+        }
+    }
+    dir.close();
+    headSequence = 0;
+    headRecords = 0;
+    ready = openSegment(headSequence, true);
+    saveHead();
+}
+
+uint32_t SensorStore::getCount() {
+    StoreGuard guard;
+    return countRecords(headSequence, headRecords, segmentCount);
+}
+
+uint32_t SensorStore::getCapacity() {
+    return (uint32_t)segmentCount * RECORDS_PER_SEGMENT;
+}
+
+uint16_t SensorStore::getBootCount() {
+    return bootCount;
+}
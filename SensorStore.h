@@ -0,0 +1,58 @@
+// SensorStore.h
+#ifndef SENSOR_STORE_H
+#define SENSOR_STORE_H
+
+#include <Arduino.h>
+
+// Запись показаний фиксированного размера
+struct __attribute__((packed)) SensorRecord {
+    uint32_t timestamp;   // millis() в момент записи
+    float lux;
+    uint16_t flags;       // SENSOR_FLAG_*
+    uint16_t bootCount;   // номер загрузки: millis() после перезагрузки начинается с нуля
+};
+
+const uint16_t SENSOR_FLAG_RELAY = 0x0001;
+const uint16_t SENSOR_FLAG_AUTO  = 0x0002;
+
+// Кольцевой буфер показаний на LittleFS.
+// Кольцо состоит из сегментов по одному блоку флеша: запись всегда дописывает
+// текущий сегмент, а при его заполнении самый старый сегмент пересоздается.
+// Перезапись внутри файла LittleFS копирует все последующие блоки,
+// поэтому один большой файл с seek-записью здесь не подходит.
+class SensorStore {
+public:
+    static const uint16_t RECORDS_PER_SEGMENT = 340;   // 8 + 340 * 12 = 4088 байт
+
+    typedef void (*RecordCallback)(const SensorRecord& record, void* context);
+
+    static bool begin(uint32_t budgetBytes);
+    static bool append(float lux, bool relayState, bool autoMode);
+    // Обходит не более maxRecords последних записей от старых к новым
+    static uint32_t readLatest(uint32_t maxRecords, RecordCallback callback, void* context);
+    static String formatRecord(const SensorRecord& record);
+    static void clear();
+
+    static uint32_t getCount();
+    static uint32_t getCapacity();
+    static uint16_t getBootCount();
+
+private:
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t sequence;    // сквозной номер сегмента, индекс файла = sequence % segmentCount
+    };
+
+    static String segmentPath(uint32_t sequence);
+    static bool openSegment(uint32_t sequence, bool create);
+    static bool loadHead();
+    static void saveHead();
+
+    static uint16_t segmentCount;
+    static uint32_t headSequence;     // сегмент, в который идет запись
+    static uint16_t headRecords;      // записей в нем
+    static uint16_t bootCount;
+    static bool ready;
+};
+
+#endif
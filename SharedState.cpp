@@ -0,0 +1,64 @@
+// SharedState.cpp
+#include "SharedState.h"
+
+static Seqlock<ControllerState> snapshot;
+
+// Кольцо команд: head двигает только веб-задача, tail - только основной цикл
+static ControlCommand commands[SharedState::COMMAND_QUEUE_SIZE];
+static std::atomic<uint32_t> commandHead(0);
+static std::atomic<uint32_t> commandTail(0);
+
+static std::atomic<uint32_t> statReadRetries(0);
+static std::atomic<uint32_t> statPosted(0);
+static std::atomic<uint32_t> statApplied(0);
+static std::atomic<uint32_t> statRejected(0);
+
+static void (*commandListener)() = nullptr;
+
+void SharedState::publish(const ControllerState& state) {
+    snapshot.write(state);
+}
+
+ControllerState SharedState::read() {
+    uint32_t retries = 0;
+    ControllerState state = snapshot.read(retries);
+    if (retries) statReadRetries.fetch_add(retries, std::memory_order_relaxed);
+    return state;
+}
+
+bool SharedState::post(const ControlCommand& command) {
+    uint32_t head = commandHead.load(std::memory_order_relaxed);
+    uint32_t tail = commandTail.load(std::memory_order_acquire);
+    if (head - tail >= COMMAND_QUEUE_SIZE) {
+        statRejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    commands[head & (COMMAND_QUEUE_SIZE - 1)] = command;
+    commandHead.store(head + 1, std::memory_order_release);
+    statPosted.fetch_add(1, std::memory_order_relaxed);
+    if (commandListener) commandListener();
+    return true;
+}
+
+void SharedState::setCommandListener(void (*listener)()) {
+    commandListener = listener;
+}
+
+bool SharedState::take(ControlCommand& command) {
+    uint32_t tail = commandTail.load(std::memory_order_relaxed);
+    if (tail == commandHead.load(std::memory_order_acquire)) return false;
+    command = commands[tail & (COMMAND_QUEUE_SIZE - 1)];
+    commandTail.store(tail + 1, std::memory_order_release);
+    statApplied.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+SharedStateStats SharedState::getStats() {
+    SharedStateStats stats;
+    stats.version = snapshot.getVersion();
+    stats.readRetries = statReadRetries.load(std::memory_order_relaxed);
+    stats.commandsPosted = statPosted.load(std::memory_order_relaxed);
+    stats.commandsApplied = statApplied.load(std::memory_order_relaxed);
+    stats.commandsRejected = statRejected.load(std::memory_order_relaxed);
+    return stats;
+}
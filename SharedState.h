@@ -0,0 +1,143 @@
+// SharedState.h
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "Config.h"
+#include "ControlEngine.h"
+#include "LightIntegral.h"
+#include "LightSensor.h"
+#include "PiController.h"
+
+// Seqlock: один писатель, любое число читателей, без мьютексов.
+// На время записи счетчик нечетный; читатель повторяет копию, если застал запись.
+// Данные лежат словами в atomic, поэтому копия без гонок по стандарту C++
+template<typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock copies T word by word");
+
+public:
+    void write(const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) data[i].store(words[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // retries - сколько раз копия попала на запись (для статистики)
+    T read(uint32_t& retries) const {
+        uint32_t words[WORDS];
+        for (;;) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (!(before & 1)) {
+                for (size_t i = 0; i < WORDS; i++) words[i] = data[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) break;
+            }
+            // Писателя вытеснили посреди записи - отдаем ядро, а не крутимся
+            if ((++retries & 0x3F) == 0) vTaskDelay(1);
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    uint32_t getVersion() const { return sequence.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static const size_t WORDS = (sizeof(T) + 3) / 4;
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> data[WORDS] = {};
+};
+
+// Зоны для /api/zones: массивы по полям, как в ControlEngine
+struct ZoneState {
+    uint8_t count = 1;
+    bool mux = false;                     // датчики за TCA9548A
+    float lux[MAX_ZONES] = {};            // последнее измерение, -1 - нет
+    uint32_t sampleTime[MAX_ZONES] = {};  // millis() измерения
+    bool sensorAvailable[MAX_ZONES] = {};
+    const char* sensorType[MAX_ZONES] = {};
+    const char* sensorRange[MAX_ZONES] = {};
+    uint8_t sensorHealth[MAX_ZONES] = {}; // SensorHealthState
+    float filtered[MAX_ZONES] = {};
+    bool relay[MAX_ZONES] = {};
+    uint32_t switches[MAX_ZONES] = {};
+};
+
+// Состояние контроллера, которое видит веб-задача. Публикует только основной цикл
+struct ControllerState {
+    float lux = -1.0;
+    uint32_t sampleTime = 0;      // millis() измерения
+    float sampleRate = 0.0;
+    uint32_t samplePeriod = 0;    // мс, период опроса датчиков сейчас
+    const char* sensorType = "";  // строки - литералы драйверов, копировать указатель безопасно
+    const char* sensorRange = "";
+    uint32_t rangeChanges = 0;
+    bool sensorAvailable = false;
+    uint8_t sensorHealth = SENSOR_HEALTHY;   // SensorHealthState зоны 0
+    uint8_t sensorFailures = 0;              // ошибок подряд
+    uint32_t sensorBackoff = 0;              // мс между попытками восстановления сейчас
+    SensorHealthStats health;
+    bool relayState = false;
+    bool scheduleActive = true;   // сейчас фотопериод (или часы не заданы)
+    ControlStats control;         // зона 0
+    DliStats dli;
+    PiStats dimmer;               // ПИ-регулятор диммера зоны 0
+    uint16_t dimDuty = 0;         // скважность ШИМ сейчас, 0..DIM_DUTY_MAX
+    ZoneState zones;
+    Settings config;
+
+    // Как LightSensor::getSample(), но на момент now
+    LuxSample getSample(uint32_t now) const {
+        LuxSample sample;
+        if (lux < 0) return sample;
+        sample.lux = lux;
+        sample.sampledAt = sampleTime;
+        sample.ageMs = now - sampleTime;
+        sample.valid = sample.ageMs <= config.sampleMaxAge;
+        return sample;
+    }
+};
+
+// Команда веб-интерфейса основному циклу
+struct ControlCommand {
+    int8_t relay = -1;            // -1 - не трогать, 0/1 - ручной режим, реле выключено/включено
+    uint32_t settingsMask = 0;    // биты SettingId, значения берутся из settings
+    // Зоны 1.., чей порог или режим берется из settings; по отдельной маске на поле,
+    // чтобы команда с одним полем не вернула другое из устаревшего снимка
+    uint8_t zoneThresholdMask = 0;
+    uint8_t zoneModeMask = 0;
+    uint32_t clockTime = 0;       // UTC для Clock::set(), 0 - не трогать
+    Settings settings;
+};
+
+struct SharedStateStats {
+    uint32_t version;             // сколько раз опубликовано состояние
+    uint32_t readRetries;         // повторы чтения из-за одновременной записи
+    uint32_t commandsPosted;
+    uint32_t commandsApplied;
+    uint32_t commandsRejected;    // очередь была полна
+};
+
+// Обмен между основным циклом (ядро 1) и веб-задачей (ядро 0), никто никого не ждет:
+// состояние идет через Seqlock, команды обратно - через кольцо на одного писателя и одного читателя
+class SharedState {
+public:
+    static const uint8_t COMMAND_QUEUE_SIZE = 8;   // степень двойки
+
+    static void publish(const ControllerState& state);   // основной цикл
+    static ControllerState read();                        // веб-задача
+    static bool post(const ControlCommand& command);      // веб-задача; false - очередь полна
+    static bool take(ControlCommand& command);            // основной цикл
+    // Вызывается из post() после каждой принятой команды, в веб-задаче
+    static void setCommandListener(void (*listener)());
+    static SharedStateStats getStats();
+};
+
+#endif
@@ -0,0 +1,90 @@
+// Veml7700Driver.cpp
+#include "Veml7700Driver.h"
+
+static const uint8_t REG_ALS_CONF = 0x00;
+static const uint8_t REG_ALS = 0x04;
+static const uint8_t REG_ID = 0x07;
+static const uint8_t DEVICE_ID = 0x81;           // младший байт регистра ID
+
+static const uint16_t GAIN_X2 = 0x01;
+static const uint16_t GAIN_X1_8 = 0x02;
+static const uint16_t IT_25MS = 0x0C;
+static const uint16_t IT_100MS = 0x00;
+static const uint16_t IT_800MS = 0x03;
+
+// Время преобразования - IT плюс 10% допуска генератора датчика
+static const LuxRange RANGES[] = {
+    {"x2 800ms",  880, 1000, 200,   0},
+    {"x2 100ms",  110, 250,  1500,  150},
+    {"x1/8 100ms",110, 250,  10000, 1000},
+    {"x1/8 25ms", 28,  100,  0,     5000},
+};
+static const uint8_t RANGE_COUNT = sizeof(RANGES) / sizeof(RANGES[0]);
+static const uint16_t GAINS[RANGE_COUNT] = {GAIN_X2, GAIN_X2, GAIN_X1_8, GAIN_X1_8};
+static const uint16_t ITS[RANGE_COUNT] = {IT_800MS, IT_100MS, IT_100MS, IT_25MS};
+// lux на отсчет: 0.0042 при x2 и 800 мс (даташит), обратно пропорционально усилению и IT
+static const float RESOLUTION[RANGE_COUNT] = {0.0042f, 0.0336f, 0.5376f, 2.1504f};
+static const uint16_t SATURATION_COUNTS = 64000;
+
+Veml7700Driver::Veml7700Driver() : LuxDriver(RANGES, RANGE_COUNT) {}
+
+bool Veml7700Driver::begin(uint8_t addr) {
+    address = addr;
+    uint16_t id;
+    if (!readRegister(REG_ID, id) || (id & 0xFF) != DEVICE_ID) return false;
+    return writeConfig(range);
+}
+
+bool Veml7700Driver::writeConfig(uint8_t index) {
+    // SD = 0: датчик включен, прерывания выключены
+    uint16_t conf = GAINS[index] << 11 | ITS[index] << 6;
+    Wire.beginTransmission(address);
+    Wire.write(REG_ALS_CONF);
+    Wire.write((uint8_t)(conf & 0xFF));
+    Wire.write((uint8_t)(conf >> 8));
+    if (Wire.endTransmission() != 0) return false;
+    reconfigured = true;
+    return true;
+}
+
+bool Veml7700Driver::readRegister(uint8_t reg, uint16_t& value) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(address, (uint8_t)2) != 2) return false;
+    value = Wire.read();
+    value |= (uint16_t)Wire.read() << 8;
+    return true;
+}
+
+uint32_t Veml7700Driver::start() {
+    waitMs = RANGES[range].conversionMs * (reconfigured ? 2 : 1);
+    reconfigured = false;
+    startedAt = millis();
+    return waitMs;
+}
+
+bool Veml7700Driver::ready() {
+    return millis() - startedAt >= waitMs;
+}
+
+void Veml7700Driver::waitReady() {
+    unsigned long elapsed = millis() - startedAt;
+    if (elapsed < waitMs) delay(waitMs - elapsed);
+}
+
+float Veml7700Driver::read() {
+    uint16_t counts;
+    if (!readRegister(REG_ALS, counts)) return -1.0f;
+    saturated = counts >= SATURATION_COUNTS;
+    float lux = counts * RESOLUTION[range];
+    // При малом усилении отклик нелинеен: поправка из application note Vishay
+    if (GAINS[range] == GAIN_X1_8) {
+        lux = (((6.0135e-13f * lux - 9.3924e-9f) * lux + 8.1488e-5f) * lux + 1.0023f) * lux;
+    }
+    return lux;
+}
+
+bool Veml7700Driver::applyRange(uint8_t index) {
+    return writeConfig(index);
+}
@@ -0,0 +1,37 @@
+// Veml7700Driver.h
+#ifndef VEML7700_DRIVER_H
+#define VEML7700_DRIVER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "LuxDriver.h"
+
+// VEML7700 через регистры, без сторонней библиотеки. Датчик работает в
+// непрерывном режиме: start() ничего не шлет на шину, а только отмеряет полное
+// время интегрирования, чтобы результат был получен после запуска.
+// Диапазоны - усиление и время интегрирования (ALS_GAIN, ALS_IT)
+class Veml7700Driver : public LuxDriver {
+public:
+    static const uint8_t ADDRESS = 0x10;         // адрес у VEML7700 один
+
+    Veml7700Driver();
+    const char* getName() const override { return "VEML7700"; }
+    bool begin(uint8_t address) override;
+    uint32_t start() override;
+    bool ready() override;
+    void waitReady() override;
+    float read() override;
+
+protected:
+    bool applyRange(uint8_t index) override;
+
+private:
+    bool writeConfig(uint8_t index);
+    bool readRegister(uint8_t reg, uint16_t& value);
+
+    unsigned long startedAt = 0;
+    uint32_t waitMs = 0;
+    bool reconfigured = false;    // первое интегрирование после смены диапазона идет со старыми настройками
+};
+
+#endif
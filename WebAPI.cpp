@@ -1,15 +1,18 @@
 // WebAPI.cpp
 #include "WebAPI.h"
+#include "BootProfile.h"
 #include "Config.h"
+#include "Clock.h"
+#include "ConfigStore.h"
+#include "Dashboard.h"
 #include "DebugLogger.h"
-#include "LightSensor.h"
-#include "RelayController.h"
+#include "History.h"
+#include "JsonReader.h"
+#include "Scheduler.h"
+#include "SensorStore.h"
+#include "SharedState.h"
 #include <LittleFS.h>
-
-// Добавляем extern объявления
-extern LightSensor lightSensor;
-extern RelayController relayController;
-extern Settings config;
+#include <esp_system.h>
 
 WebAPI webAPI;
 
@@ -20,204 +23,1097 @@ void WebAPI::begin() {
     Serial.println("AP created: " + WiFi.softAPIP().toString());
     
     setupRoutes();
+    // WebServer хранит только перечисленные заголовки запроса
+    const char* headerKeys[] = {"If-None-Match"};
+    server.collectHeaders(headerKeys, 1);
     server.begin();
-    SYSTEM_LOG("Web server started on port 80");
+    
+    // Ядро 1 занято основным циклом; сервер на ядре 0 рядом с WiFi-стеком и записью логов
+    xTaskCreatePinnedToCore(webTask, "web", WEB_TASK_STACK, this, 1, &taskHandle, 0);
+    SYSTEM_LOGF(LOG_MODULE_WEB, "Web server started on port 80");
+}
+
+// Медленный клиент или большой лог задерживают только эту задачу. Состояние контроллера
+// она читает из SharedState, а изменения отправляет туда же командами
+void WebAPI::webTask(void* param) {
+    WebAPI* api = static_cast<WebAPI*>(param);
+    unsigned long lastPush = millis();
+    for (;;) {
+        api->server.handleClient();
+        if (millis() - lastPush >= EVENT_PUSH_INTERVAL) {
+            lastPush = millis();
+            api->pushEvents();
+        }
+        vTaskDelay(pdMS_TO_TICKS(WEB_POLL_INTERVAL));
+    }
 }
 
 void WebAPI::setupRoutes() {
-    server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    server.on("/api/status", HTTP_GET, [this]() { handleStatus(); });
-    server.on("/api/control", HTTP_POST, [this]() { handleControl(); });
-    server.on("/api/settings", HTTP_POST, [this]() { handleSettings(); });
-    server.on("/api/logs", HTTP_GET, [this]() { handleLogs(); });
+    server.on("/", HTTP_GET, [this]() { metered(METRIC_HTTP_ROOT, &WebAPI::handleRoot); });
+    server.on("/api/status", HTTP_GET, [this]() { metered(METRIC_HTTP_STATUS, &WebAPI::handleStatus); });
+    server.on("/api/control", HTTP_POST, [this]() { traced(TRACE_ROUTE_CONTROL, METRIC_HTTP_CONTROL, &WebAPI::handleControl); });
+    server.on("/api/settings", HTTP_GET, [this]() { metered(METRIC_HTTP_GET_SETTINGS, &WebAPI::handleGetSettings); });
+    server.on("/api/settings", HTTP_POST, [this]() { traced(TRACE_ROUTE_SETTINGS, METRIC_HTTP_SETTINGS, &WebAPI::handleSettings); });
+    server.on("/api/logs", HTTP_GET, [this]() { metered(METRIC_HTTP_LOGS, &WebAPI::handleLogs); });
+    server.on("/api/tasks", HTTP_GET, [this]() { metered(METRIC_HTTP_TASKS, &WebAPI::handleTasks); });
+    server.on("/api/sensor", HTTP_GET, [this]() { metered(METRIC_HTTP_SENSOR, &WebAPI::handleSensorData); });
+    server.on("/api/history", HTTP_GET, [this]() { metered(METRIC_HTTP_HISTORY, &WebAPI::handleHistory); });
+    server.on("/api/clock", HTTP_GET, [this]() { metered(METRIC_HTTP_GET_CLOCK, &WebAPI::handleGetClock); });
+    server.on("/api/clock", HTTP_POST, [this]() { traced(TRACE_ROUTE_CLOCK, METRIC_HTTP_CLOCK, &WebAPI::handleClock); });
+    server.on("/api/zones", HTTP_GET, [this]() { metered(METRIC_HTTP_ZONES, &WebAPI::handleZones); });
+    server.on("/api/zone", HTTP_GET, [this]() { metered(METRIC_HTTP_GET_ZONE, &WebAPI::handleGetZone); });
+    server.on("/api/zone", HTTP_POST, [this]() { traced(TRACE_ROUTE_ZONE, METRIC_HTTP_ZONE, &WebAPI::handleZone); });
+    server.on("/api/trace", HTTP_GET, [this]() { metered(METRIC_HTTP_TRACE, &WebAPI::handleTrace); });
+    server.on("/api/events", HTTP_GET, [this]() { metered(METRIC_HTTP_EVENTS, &WebAPI::handleEvents); });
+    server.on("/api/trace/snapshot", HTTP_POST, [this]() { traced(TRACE_ROUTE_TRACE, METRIC_HTTP_SNAPSHOT, &WebAPI::handleTraceSnapshot); });
+    server.on("/api/metrics", HTTP_GET, [this]() { metered(METRIC_HTTP_METRICS, &WebAPI::handleMetrics); });
     
-    server.onNotFound([this]() { handleNotFound(); });
+    server.onNotFound([this]() { traced(TRACE_ROUTE_NOT_FOUND, METRIC_HTTP_NOT_FOUND, &WebAPI::handleNotFound); });
+}
+
+void WebAPI::metered(MetricHistogram metric, void (WebAPI::*handler)()) {
+    uint32_t started = Metrics::start();
+    (this->*handler)();
+    Metrics::record(metric, started);
+}
+
+void WebAPI::traced(TraceRoute route, MetricHistogram metric, void (WebAPI::*handler)()) {
+    unsigned long start = micros();
+    metered(metric, handler);
+    EventTrace::record(TRACE_HTTP_REQUEST, route, micros() - start);
 }
 
+// Страница лежит во флеше сжатой (Dashboard.h, из web/index.html) и отдается без копирования.
+// Cache-Control: no-cache - браузер каждый раз сверяет ETag и после прошивки получит новую страницу
 void WebAPI::handleRoot() {
-    String html = "<!DOCTYPE html>";
-    html += "<html>";
-    html += "<head>";
-    html += "<title>PhytoController</title>";
-    html += "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">";
-    html += "<style>";
-    html += "body { font-family: Arial; margin: 20px; background: #f0f0f0; }";
-    html += ".card { background: white; padding: 20px; margin: 10px; border-radius: 10px; box-shadow: 0 2px 5px rgba(0,0,0,0.1); }";
-    html += ".status { font-size: 1.2em; margin: 10px 0; }";
-    html += ".btn { padding: 10px 20px; margin: 5px; border: none; border-radius: 5px; cursor: pointer; }";
-    html += ".btn-on { background: #4CAF50; color: white; }";
-    html += ".btn-off { background: #f44336; color: white; }";
-    html += ".btn-auto { background: #2196F3; color: white; }";
-    html += ".log { background: #000; color: #0f0; padding: 10px; border-radius: 5px; font-family: monospace; height: 200px; overflow-y: scroll; }";
-    html += "</style>";
-    html += "</head>";
-    html += "<body>";
-    html += "<h1>PhytoController</h1>";
-    
-    html += "<div class=\"card\">";
-    html += "<h2>System Status</h2>";
-    html += "<div id=\"status\">Loading...</div>";
-    html += "</div>";
-    
-    html += "<div class=\"card\">";
-    html += "<h2>Control</h2>";
-    html += "<button class=\"btn btn-on\" onclick=\"control('relay', true)\">ON Relay</button>";
-    html += "<button class=\"btn btn-off\" onclick=\"control('relay', false)\">OFF Relay</button>";
-    html += "<button class=\"btn btn-auto\" onclick=\"control('mode', true)\">AUTO Mode</button>";
-    html += "<button class=\"btn\" onclick=\"control('mode', false)\">MANUAL Mode</button>";
-    html += "</div>";
-    
-    html += "<div class=\"card\">";
-    html += "<h2>Settings</h2>";
-    html += "<label>Light threshold (lux):</label>";
-    html += "<input type=\"number\" id=\"threshold\" value=\"500\">";
-    html += "<button onclick=\"updateSettings()\">Save</button>";
-    html += "</div>";
-    
-    html += "<div class=\"card\">";
-    html += "<h2>Logs</h2>";
-    html += "<div class=\"log\" id=\"logs\">Loading logs...</div>";
-    html += "<button onclick=\"refreshLogs()\">Refresh Logs</button>";
-    html += "</div>";
-    
-    html += "<script>";
-    html += "function updateStatus() {";
-    html += "  fetch('/api/status')";
-    html += "    .then(response => response.json())";
-    html += "    .then(data => {";
-    html += "      document.getElementById('status').innerHTML = ";
-    html += "        '<div class=\"status\">Relay: <b>' + (data.relayState ? 'ON' : 'OFF') + '</b></div>' +";
-    html += "        '<div class=\"status\">Light: <b>' + data.lux.toFixed(2) + ' lux</b></div>' +";
-    html += "        '<div class=\"status\">Mode: <b>' + (data.autoMode ? 'AUTO' : 'MANUAL') + '</b></div>' +";
-    html += "        '<div class=\"status\">Threshold: <b>' + data.threshold + ' lux</b></div>' +";
-    html += "        '<div class=\"status\">Uptime: <b>' + data.uptime + ' sec</b></div>';";
-    html += "      document.getElementById('threshold').value = data.threshold;";
-    html += "    });";
-    html += "}";
-    
-    html += "function control(type, value) {";
-    html += "  let body = {};";
-    html += "  if (type === 'relay') { body = { relay: value }; }";
-    html += "  else if (type === 'mode') { body = { autoMode: value }; }";
-    html += "  fetch('/api/control', {";
-    html += "    method: 'POST',";
-    html += "    headers: {'Content-Type': 'application/json'},";
-    html += "    body: JSON.stringify(body)";
-    html += "  }).then(() => updateStatus());";
-    html += "}";
-    
-    html += "function updateSettings() {";
-    html += "  const threshold = document.getElementById('threshold').value;";
-    html += "  fetch('/api/settings', {";
-    html += "    method: 'POST',";
-    html += "    headers: {'Content-Type': 'application/json'},";
-    html += "    body: JSON.stringify({threshold: parseFloat(threshold)})";
-    html += "  }).then(() => updateStatus());";
-    html += "}";
-    
-    html += "function refreshLogs() {";
-    html += "  fetch('/api/logs')";
-    html += "    .then(response => response.json())";
-    html += "    .then(data => {";
-    html += "      document.getElementById('logs').innerText = data.logs;";
-    html += "    });";
-    html += "}";
-    
-    html += "setInterval(updateStatus, 3000);";
-    html += "updateStatus();";
-    html += "refreshLogs();";
-    html += "</script>";
-    html += "</body>";
-    html += "</html>";
-    
-    server.send(200, "text/html", html);
+    server.sendHeader("ETag", DASHBOARD_ETAG);
+    server.sendHeader("Cache-Control", "no-cache");
+    
+    String ifNoneMatch = server.header("If-None-Match");
+    if (ifNoneMatch == "*" || ifNoneMatch.indexOf(DASHBOARD_ETAG) >= 0) {
+        server.send(304);
+        return;
+    }
+    
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (PGM_P)DASHBOARD_GZ, DASHBOARD_GZ_SIZE);
+}
+
+void WebAPI::sendJson(int code, JsonWriter& json) {
+    // Обрезанный ответ - невалидный JSON; 200 с ним не отправляем
+    if (json.overflow()) {
+        SYSTEM_LOGF(LOG_MODULE_WEB, "❌ Ответ %s не поместился в буфер (%u байт)",
+                    server.uri().c_str(), (unsigned)json.length());
+        server.send(500, "application/json", "{\"error\":\"response too large\"}");
+        return;
+    }
+    // send_P на ESP32 читает и из RAM; длина известна, String не нужен
+    server.send_P(code, "application/json", json.c_str(), json.length());
+}
+
+// {"error":"...","field":"...","position":N} - position указывает на байт тела запроса
+void WebAPI::sendJsonError(int code, const char* message, const char* field, int position) {
+    char buffer[160];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject().field("error", message);
+    if (field) json.field("field", field);
+    if (position >= 0) json.field("position", position);
+    json.endObject();
+    sendJson(code, json);
 }
 
 void WebAPI::handleStatus() {
-    // Ручное создание JSON
-    String json = "{";
-    json += "\"relayState\":" + String(relayController.getState() ? "true" : "false") + ",";
-    json += "\"lux\":" + String(lightSensor.getLux()) + ",";
-    json += "\"autoMode\":" + String(config.autoMode ? "true" : "false") + ",";
-    json += "\"threshold\":" + String(config.lightThreshold) + ",";
-    json += "\"uptime\":" + String(millis() / 1000) + ",";
-    json += "\"sensorAvailable\":" + String(lightSensor.isAvailable() ? "true" : "false") + ",";
-    json += "\"wifiStatus\":\"" + String(WiFi.status() == WL_CONNECTED ? "connected" : "ap") + "\"";
-    json += "}";
+    // Снимок основного цикла; датчик и реле отсюда не трогаются
+    ControllerState state = SharedState::read();
+    LuxSample sample = state.getSample(millis());
+    LogQueueStats logQueue = DebugLogger::getQueueStats();
+    SharedStateStats shared = SharedState::getStats();
+    ConfigStoreStats store = ConfigStore::getStats();
+    
+    BootPhase phases[BootProfile::MAX_PHASES];
+    uint8_t phaseCount = BootProfile::getPhases(phases);
+    
+    char buffer[1792];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("relayState", state.relayState)
+        .field("lux", sample.lux)
+        .field("luxAge", sample.ageMs)
+        .field("luxValid", sample.valid)
+        .field("sampleRate", state.sampleRate)
+        .field("samplePeriod", state.samplePeriod)
+        .field("sensorType", state.sensorType)
+        .field("sensorRange", state.sensorRange)
+        .field("rangeChanges", state.rangeChanges)
+        .field("autoMode", state.config.autoMode)
+        .field("threshold", state.config.lightThreshold)
+        .field("uptime", millis() / 1000)
+        .field("time", Clock::now())
+        .field("scheduleActive", state.scheduleActive)
+        .field("sensorAvailable", state.sensorAvailable)
+        .field("wifiStatus", WiFi.status() == WL_CONNECTED ? "connected" : "ap");
+    json.key("logQueue").beginObject()
+        .field("enqueued", logQueue.enqueued)
+        .field("written", logQueue.written)
+        .field("dropped", logQueue.dropped)
+        .field("truncated", logQueue.truncated)
+        .field("batches", logQueue.batches)
+        .field("depth", logQueue.depth)
+        .field("highWater", logQueue.highWater)
+        .endObject();
+    json.key("shared").beginObject()
+        .field("version", shared.version)
+        .field("readRetries", shared.readRetries)
+        .field("commandsPosted", shared.commandsPosted)
+        .field("commandsApplied", shared.commandsApplied)
+        .field("commandsRejected", shared.commandsRejected)
+        .endObject();
+    json.key("control").beginObject()
+        .field("raw", state.control.raw)
+        .field("median", state.control.median)
+        .field("filtered", state.control.filtered)
+        .field("hysteresis", state.config.hysteresis)
+        .field("switches", state.control.switches)
+        .field("dwellHolds", state.control.dwellHolds)
+        .endObject();
+    json.key("dli").beginObject()
+        .field("mode", state.config.dliMode)
+        .field("today", state.dli.today)
+        .field("yesterday", state.dli.yesterday)
+        .field("target", state.config.dliTarget)
+        .field("projected", state.dli.projected)
+        .field("ppfd", state.dli.ppfd)
+        .field("natural", state.dli.natural)
+        .field("remainingMinutes", state.dli.remainingMinutes)
+        .field("lampNeeded", state.dli.lampNeeded)
+        .endObject();
+    json.key("dim").beginObject()
+        .field("mode", state.config.dimMode)
+        .field("target", state.config.dimTarget)
+        .field("duty", state.dimDuty * 100.0f / DIM_DUTY_MAX)
+        .field("output", state.dimmer.output * 100.0f / DIM_DUTY_MAX)
+        .field("error", state.dimmer.error)
+        .field("integral", state.dimmer.integral * 100.0f / DIM_DUTY_MAX)
+        .field("updates", state.dimmer.updates)
+        .field("saturated", state.dimmer.saturated)
+        .endObject();
+    json.key("configStore").beginObject()
+        .field("requests", store.requests)
+        .field("writes", store.writes)
+        .field("skipped", store.skipped)
+        .field("errors", store.errors)
+        .field("sequence", store.sequence)
+        .field("dirty", store.dirty)
+        .endObject();
+    json.key("sensorHealth").beginObject()
+        .field("state", SensorHealth::getStateName((SensorHealthState)state.sensorHealth))
+        .field("consecutiveFailures", state.sensorFailures)
+        .field("backoffMs", state.sensorBackoff)
+        .field("failures", state.health.failures)
+        .field("losses", state.health.losses)
+        .field("attempts", state.health.attempts)
+        .field("busClears", state.health.busClears)
+        .field("recoveries", state.health.recoveries)
+        .field("lastRecoveryMs", state.health.lastRecoveryMs)
+        .field("maxRecoveryMs", state.health.maxRecoveryMs)
+        .field("downtimeMs", state.health.downtimeMs)
+        .field("failSafe", state.config.failSafe)
+        .endObject();
+    json.key("boot").beginObject()
+        .field("resetReason", (uint32_t)esp_reset_reason())
+        .field("coldBoot", BootProfile::isColdBoot())
+        .field("sensorProbe", BootProfile::getSensorProbe())
+        .field("setupMs", BootProfile::getSetupMs())
+        .field("firstControlMs", BootProfile::getControlMs());
+    json.key("phases").beginObject();
+    for (uint8_t i = 0; i < phaseCount; i++) {
+        json.field(phases[i].name, phases[i].ms);
+    }
+    json.endObject().endObject();
+    json.endObject();
     
-    server.send(200, "application/json", json);
+    sendJson(200, json);
+}
+
+static void streamMetricsChunk(const char* data, size_t length, void* context) {
+    static_cast<WebServer*>(context)->sendContent(data, length);
+}
+
+// GET /api/metrics - гистограммы времени, счетчики и куча в текстовом формате Prometheus
+void WebAPI::handleMetrics() {
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/plain; version=0.0.4", "");
+    Metrics::render(streamMetricsChunk, &server);
+}
+
+// Ошибка разбора тела запроса: сообщение, поле и позиция в теле
+struct RequestError {
+    const char* message = nullptr;
+    const char* field = nullptr;
+    size_t position = 0;
+    char unknownKey[32];     // имя неизвестного поля для ответа
+};
+
+static bool failRequest(RequestError& error, const char* message, const char* field, size_t position) {
+    error.message = message;
+    error.field = field;
+    error.position = position;
+    return false;
 }
 
+// Тело запроса - объект; readField читает значение текущего ключа и заполняет error.
+// Ключ, который readField не знает, - ошибка "unknown field"
+template<typename ReadField>
+static bool parseRequest(JsonReader& json, RequestError& error, ReadField readField) {
+    JsonToken token = json.next();
+    if (token != JSON_OBJECT_START) {
+        if (token == JSON_ERROR) return failRequest(error, json.getError(), nullptr, json.getErrorPosition());
+        return failRequest(error, "expected object", nullptr, json.getPosition());
+    }
+    while ((token = json.next()) == JSON_KEY) {
+        if (!readField(json, error)) {
+            if (!error.message) {
+                bool copied = json.copyString(error.unknownKey, sizeof(error.unknownKey));
+                failRequest(error, "unknown field", copied ? error.unknownKey : nullptr, json.getPosition());
+            }
+            return false;
+        }
+    }
+    if (token != JSON_OBJECT_END || json.next() != JSON_END) {
+        return failRequest(error, json.getError(), nullptr, json.getErrorPosition());
+    }
+    return true;
+}
+
+// Следующее значение должно быть true/false
+static bool readBool(JsonReader& json, const char* field, bool& out, RequestError& error) {
+    JsonToken token = json.next();
+    if (token == JSON_ERROR) return failRequest(error, json.getError(), field, json.getErrorPosition());
+    if (token != JSON_TRUE && token != JSON_FALSE) {
+        return failRequest(error, "expected boolean", field, json.getPosition());
+    }
+    out = token == JSON_TRUE;
+    return true;
+}
+
+// Команда уходит основному циклу; ответ не ждет ее выполнения
+bool WebAPI::postCommand(const ControlCommand& command) {
+    if (SharedState::post(command)) return true;
+    sendJsonError(503, "command queue full");
+    return false;
+}
+
+// POST /api/control {"relay":bool,"autoMode":bool} - оба поля необязательны;
+// relay переводит в ручной режим с этим состоянием реле
 void WebAPI::handleControl() {
-    if (server.hasArg("plain")) {
-        String body = server.arg("plain");
-        
-        // Простой парсинг JSON вручную
-        if (body.indexOf("\"relay\":true") != -1) {
-            relayController.turnOn();
-        } else if (body.indexOf("\"relay\":false") != -1) {
-            relayController.turnOff();
+    if (!server.hasArg("plain")) {
+        sendJsonError(400, "empty body");
+        return;
+    }
+    String body = server.arg("plain");
+    JsonReader json(body.c_str(), body.length());
+    RequestError error;
+    
+    bool hasRelay = false, relay = false;
+    bool hasAutoMode = false, autoMode = false;
+    bool ok = parseRequest(json, error, [&](JsonReader& json, RequestError& error) {
+        if (json.keyIs("relay")) return hasRelay = readBool(json, "relay", relay, error);
+        if (json.keyIs("autoMode")) return hasAutoMode = readBool(json, "autoMode", autoMode, error);
+        return false;
+    });
+    
+    if (!ok) {
+        sendJsonError(400, error.message, error.field, error.position);
+        return;
+    }
+    
+    // Реле и режим - одной командой, только после разбора всего тела
+    ControlCommand command;
+    if (hasRelay) command.relay = relay ? 1 : 0;
+    if (hasAutoMode) {
+        command.settings.autoMode = autoMode;
+        command.settingsMask = 1UL << SETTING_AUTO_MODE;
+    }
+    if ((hasRelay || hasAutoMode) && !postCommand(command)) return;
+    
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+}
+
+// GET /api/clock - время UTC, источник и местное время по timezoneOffset
+void WebAPI::handleGetClock() {
+    ControllerState state = SharedState::read();
+    LocalTime local;
+    bool set = Clock::getLocal(state.config.timezoneOffset, local);
+    
+    char buffer[192];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("time", Clock::now())
+        .field("source", Clock::getSourceName(Clock::getSource()))
+        .field("timezoneOffset", state.config.timezoneOffset);
+    if (set) {
+        char text[12];
+        snprintf(text, sizeof(text), "%s %02u:%02u", Schedule::getDayName(local.weekday),
+                 local.minute / 60, local.minute % 60);
+        json.field("local", text);
+    }
+    json.field("scheduleActive", state.scheduleActive).endObject();
+    sendJson(200, json);
+}
+
+// POST /api/clock {"time":UTC} - ручная установка, если SNTP недоступен (точка доступа)
+void WebAPI::handleClock() {
+    if (!server.hasArg("plain")) {
+        sendJsonError(400, "empty body");
+        return;
+    }
+    String body = server.arg("plain");
+    JsonReader json(body.c_str(), body.length());
+    RequestError error;
+    
+    ControlCommand command;
+    bool ok = parseRequest(json, error, [&](JsonReader& json, RequestError& error) {
+        if (!json.keyIs("time")) return false;
+        JsonToken token = json.next();
+        if (token == JSON_ERROR) return failRequest(error, json.getError(), "time", json.getErrorPosition());
+        if (token != JSON_NUMBER || !json.getUint32(command.clockTime)) {
+            return failRequest(error, "expected unsigned integer", "time", json.getPosition());
         }
-        
-        if (body.indexOf("\"autoMode\":true") != -1) {
-            config.autoMode = true;
-            saveConfig();
-        } else if (body.indexOf("\"autoMode\":false") != -1) {
-            config.autoMode = false;
-            saveConfig();
+        if (command.clockTime < Clock::MIN_VALID_TIME) {
+            return failRequest(error, "value out of range", "time", json.getPosition());
+        }
+        return true;
+    });
+    
+    if (!ok) {
+        sendJsonError(400, error.message, error.field, error.position);
+        return;
+    }
+    if (!command.clockTime) {
+        sendJsonError(400, "missing field", "time");
+        return;
+    }
+    if (!postCommand(command)) return;
+    
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+}
+
+// Зона в /api/zones и /api/zone; у зоны 0 порог и режим - обычные настройки
+static void writeZone(JsonWriter& json, const ControllerState& state, uint8_t zone, uint32_t now) {
+    const ZoneState& zones = state.zones;
+    bool valid = zones.lux[zone] >= 0 && now - zones.sampleTime[zone] <= state.config.sampleMaxAge;
+    json.beginObject()
+        .field("id", zone)
+        .field("lux", zones.lux[zone])
+        .field("luxValid", valid)
+        .field("filtered", zones.filtered[zone])
+        .field("relay", zones.relay[zone])
+        .field("threshold", getZoneThreshold(state.config, zone))
+        .field("mode", getZoneModeName(getZoneMode(state.config, zone)))
+        .field("sensorAvailable", zones.sensorAvailable[zone])
+        .field("sensorType", zones.sensorType[zone])
+        .field("sensorRange", zones.sensorRange[zone])
+        .field("sensorHealth", SensorHealth::getStateName((SensorHealthState)zones.sensorHealth[zone]))
+        .field("switches", zones.switches[zone])
+        .endObject();
+}
+
+// GET /api/zones - все зоны одним ответом
+void WebAPI::handleZones() {
+    ControllerState state = SharedState::read();
+    uint32_t now = millis();
+    char buffer[2048];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("count", state.zones.count)
+        .field("mux", state.zones.mux);
+    json.key("zones").beginArray();
+    for (uint8_t zone = 0; zone < state.zones.count; zone++) writeZone(json, state, zone, now);
+    json.endArray().endObject();
+    sendJson(200, json);
+}
+
+bool WebAPI::findZone(const ControllerState& state, uint8_t& zone) {
+    if (!server.hasArg("id")) {
+        sendJsonError(400, "missing field", "id");
+        return false;
+    }
+    String id = server.arg("id");
+    if (id.length() != 1 || id[0] < '0' || id[0] - '0' >= state.zones.count) {
+        sendJsonError(404, "unknown zone", "id");
+        return false;
+    }
+    zone = id[0] - '0';
+    return true;
+}
+
+void WebAPI::sendZone(const ControllerState& state, uint8_t zone) {
+    char buffer[320];
+    JsonWriter json(buffer, sizeof(buffer));
+    writeZone(json, state, zone, millis());
+    sendJson(200, json);
+}
+
+// GET /api/zone?id=N
+void WebAPI::handleGetZone() {
+    ControllerState state = SharedState::read();
+    uint8_t zone;
+    if (findZone(state, zone)) sendZone(state, zone);
+}
+
+// POST /api/zone?id=N {"threshold":lux,"mode":"auto"|"on"|"off"} - оба поля необязательны.
+// Для зоны 0 это lightThreshold, autoMode и manualOn из /api/settings
+void WebAPI::handleZone() {
+    ControllerState state = SharedState::read();
+    uint8_t zone;
+    if (!findZone(state, zone)) return;
+    if (!server.hasArg("plain")) {
+        sendJsonError(400, "empty body");
+        return;
+    }
+    String body = server.arg("plain");
+    JsonReader json(body.c_str(), body.length());
+    RequestError error;
+    
+    const SettingField& range = SETTING_FIELDS[SETTING_LIGHT_THRESHOLD];
+    bool hasThreshold = false, hasMode = false;
+    float threshold = 0;
+    ZoneMode mode = ZONE_MODE_AUTO;
+    bool ok = parseRequest(json, error, [&](JsonReader& json, RequestError& error) {
+        bool isThreshold = json.keyIs("threshold");
+        if (!isThreshold && !json.keyIs("mode")) return false;
+        const char* field = isThreshold ? "threshold" : "mode";
+        JsonToken token = json.next();
+        if (token == JSON_ERROR) return failRequest(error, json.getError(), field, json.getErrorPosition());
+        if (isThreshold) {
+            if (token != JSON_NUMBER || !json.getFloat(threshold)) {
+                return failRequest(error, "expected number", field, json.getPosition());
+            }
+            if (threshold < range.min || threshold > range.max) {
+                return failRequest(error, "value out of range", field, json.getPosition());
+            }
+            return hasThreshold = true;
+        }
+        char name[8];
+        if (token != JSON_STRING || !json.copyString(name, sizeof(name)) || !parseZoneMode(name, mode)) {
+            return failRequest(error, "expected auto, on or off", field, json.getPosition());
+        }
+        return hasMode = true;
+    });
+    
+    if (!ok) {
+        sendJsonError(400, error.message, error.field, error.position);
+        return;
+    }
+    
+    ControlCommand command;
+    command.settings = state.config;
+    if (zone == 0) {
+        if (hasThreshold) {
+            command.settings.lightThreshold = threshold;
+            command.settingsMask |= 1UL << SETTING_LIGHT_THRESHOLD;
+        }
+        if (hasMode) {
+            command.settings.autoMode = mode == ZONE_MODE_AUTO;
+            command.settingsMask |= 1UL << SETTING_AUTO_MODE;
+            if (mode != ZONE_MODE_AUTO) {
+                command.settings.manualOn = mode == ZONE_MODE_ON;
+                command.settingsMask |= 1UL << SETTING_MANUAL_ON;
+            }
         }
-        
-        server.send(200, "application/json", "{\"status\":\"ok\"}");
     } else {
-        server.send(400, "application/json", "{\"error\":\"Invalid request\"}");
+        if (hasThreshold) {
+            command.settings.zoneThreshold[zone] = threshold;
+            command.zoneThresholdMask = 1 << zone;
+        }
+        if (hasMode) {
+            command.settings.zoneMode[zone] = mode;
+            command.zoneModeMask = 1 << zone;
+        }
     }
+    if ((command.settingsMask || command.zoneThresholdMask || command.zoneModeMask) && !postCommand(command)) return;
+    // Зона, какой она станет после применения команды
+    state.config = command.settings;
+    sendZone(state, zone);
 }
 
-void WebAPI::handleSettings() {
-    if (server.hasArg("plain")) {
-        String body = server.arg("plain");
-        
-        // Простой парсинг threshold
-        int thresholdIndex = body.indexOf("\"threshold\":");
-        if (thresholdIndex != -1) {
-            int start = thresholdIndex + 12; // после "threshold":
-            int end = body.indexOf(",", start);
-            if (end == -1) end = body.indexOf("}", start);
-            
-            if (end != -1) {
-                String thresholdStr = body.substring(start, end);
-                config.lightThreshold = thresholdStr.toFloat();
-                saveConfig();
-                EVENT_LOG("Light threshold set: " + String(config.lightThreshold) + " lux");
+static int8_t findSetting(const JsonReader& json) {
+    // Старое имя порога, его отправляет страница
+    if (json.keyIs("threshold")) return SETTING_LIGHT_THRESHOLD;
+    for (uint8_t id = 0; id < SETTING_COUNT; id++) {
+        if (json.keyIs(SETTING_FIELDS[id].name)) return id;
+    }
+    return -1;
+}
+
+static bool readSetting(JsonReader& json, const SettingField& field, Settings& settings, RequestError& error) {
+    uint8_t* target = reinterpret_cast<uint8_t*>(&settings) + field.offset;
+    if (field.type == SETTING_TYPE_BOOL) return readBool(json, field.name, *reinterpret_cast<bool*>(target), error);
+    
+    JsonToken token = json.next();
+    if (token == JSON_ERROR) return failRequest(error, json.getError(), field.name, json.getErrorPosition());
+    
+    switch (field.type) {
+        case SETTING_TYPE_FLOAT: {
+            float value;
+            if (token != JSON_NUMBER) return failRequest(error, "expected number", field.name, json.getPosition());
+            if (!json.getFloat(value)) return failRequest(error, "invalid number", field.name, json.getPosition());
+            if (value < field.min || value > field.max) {
+                return failRequest(error, "value out of range", field.name, json.getPosition());
             }
+            *reinterpret_cast<float*>(target) = value;
+            return true;
+        }
+        case SETTING_TYPE_UINT: {
+            uint32_t value;
+            if (token != JSON_NUMBER) return failRequest(error, "expected number", field.name, json.getPosition());
+            if (!json.getUint32(value)) {
+                return failRequest(error, "expected unsigned integer", field.name, json.getPosition());
+            }
+            if (value < field.min || value > field.max) {
+                return failRequest(error, "value out of range", field.name, json.getPosition());
+            }
+            *reinterpret_cast<uint32_t*>(target) = value;
+            return true;
+        }
+        case SETTING_TYPE_INT: {
+            int32_t value;
+            if (token != JSON_NUMBER) return failRequest(error, "expected number", field.name, json.getPosition());
+            if (!json.getInt32(value)) return failRequest(error, "expected integer", field.name, json.getPosition());
+            if (value < field.min || value > field.max) {
+                return failRequest(error, "value out of range", field.name, json.getPosition());
+            }
+            *reinterpret_cast<int32_t*>(target) = value;
+            return true;
+        }
+        case SETTING_TYPE_SCHEDULE: {
+            char text[sizeof(Settings::schedule)];
+            if (token != JSON_STRING) return failRequest(error, "expected string", field.name, json.getPosition());
+            if (!json.copyString(text, sizeof(text)) || !isValidSchedule(text)) {
+                return failRequest(error, "expected [Mo-Fr ]HH:MM-HH:MM[,...][;...]", field.name, json.getPosition());
+            }
+            memcpy(target, text, sizeof(text));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void WebAPI::sendSettings(const Settings& settings) {
+    char buffer[640];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject();
+    for (uint8_t id = 0; id < SETTING_COUNT; id++) {
+        const SettingField& field = SETTING_FIELDS[id];
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(&settings) + field.offset;
+        json.key(field.name);
+        switch (field.type) {
+            case SETTING_TYPE_FLOAT: json.value(*reinterpret_cast<const float*>(source)); break;
+            case SETTING_TYPE_UINT: json.value(*reinterpret_cast<const uint32_t*>(source)); break;
+            case SETTING_TYPE_INT: json.value(*reinterpret_cast<const int32_t*>(source)); break;
+            case SETTING_TYPE_BOOL: json.value(*reinterpret_cast<const bool*>(source)); break;
+            case SETTING_TYPE_SCHEDULE: json.value(reinterpret_cast<const char*>(source)); break;
+        }
+    }
+    json.endObject();
+    sendJson(200, json);
+}
+
+void WebAPI::handleGetSettings() {
+    sendSettings(SharedState::read().config);
+}
+
+// POST /api/settings - любое подмножество полей GET /api/settings одним запросом.
+// Тело разбирается целиком; при любой ошибке не меняется ничего. Основной цикл применяет
+// только присланные поля, поэтому одновременные запросы не затирают друг друга
+void WebAPI::handleSettings() {
+    if (!server.hasArg("plain")) {
+        sendJsonError(400, "empty body");
+        return;
+    }
+    String body = server.arg("plain");
+    JsonReader json(body.c_str(), body.length());
+    ControlCommand command;
+    command.settings = SharedState::read().config;
+    RequestError error;
+    
+    bool ok = parseRequest(json, error, [&](JsonReader& json, RequestError& error) {
+        int8_t id = findSetting(json);
+        if (id < 0 || !readSetting(json, SETTING_FIELDS[id], command.settings, error)) return false;
+        command.settingsMask |= 1UL << id;
+        return true;
+    });
+    
+    if (!ok) {
+        sendJsonError(400, error.message, error.field, error.position);
+        return;
+    }
+    if (command.settingsMask && !postCommand(command)) return;
+    // Настройки, какими они станут после применения команды
+    sendSettings(command.settings);
+}
+
+// Экранированный текст лога копится в небольшом буфере и уходит чанками
+struct LogStreamContext {
+    WebServer* server;
+    size_t length;
+    char buffer[256];
+};
+
+static void streamLogChunk(const char* data, size_t length, void* context) {
+    LogStreamContext* ctx = static_cast<LogStreamContext*>(context);
+    
+    for (size_t i = 0; i < length; i++) {
+        // Самое длинное экранирование - \u00XX, 6 байт
+        if (ctx->length + 6 > sizeof(ctx->buffer)) {
+            ctx->server->sendContent(ctx->buffer, ctx->length);
+            ctx->length = 0;
         }
         
-        server.send(200, "application/json", "{\"status\":\"ok\"}");
-    } else {
-        server.send(400, "application/json", "{\"error\":\"Invalid request\"}");
+        char c = data[i];
+        char* out = ctx->buffer + ctx->length;
+        switch (c) {
+            case '"':  out[0] = '\\'; out[1] = '"';  ctx->length += 2; break;
+            case '\\': out[0] = '\\'; out[1] = '\\'; ctx->length += 2; break;
+            case '\n': out[0] = '\\'; out[1] = 'n';  ctx->length += 2; break;
+            case '\r': out[0] = '\\'; out[1] = 'r';  ctx->length += 2; break;
+            case '\t': out[0] = '\\'; out[1] = 't';  ctx->length += 2; break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    ctx->length += snprintf(out, 7, "\\u%04x", (unsigned)c);
+                } else {
+                    out[0] = c;
+                    ctx->length++;
+                }
+        }
     }
 }
 
+// GET /api/logs?type=debug|events|system|sensor&lines=N - последние N строк лога
 void WebAPI::handleLogs() {
-    String logs = DebugLogger::getLog(DEBUG_LOG, 50);
-    String json = "{\"logs\":\"" + escapeJSONString(logs) + "\"}";
-    server.send(200, "application/json", json);
+    LogType type = DEBUG_LOG;
+    if (server.hasArg("type") && !DebugLogger::parseLogType(server.arg("type"), type)) {
+        server.send(400, "application/json", "{\"error\":\"Unknown log type\"}");
+        return;
+    }
+    
+    uint16_t lines = 50;
+    if (server.hasArg("lines")) {
+        long requested = server.arg("lines").toInt();
+        if (requested <= 0 || requested > 1000) {
+            server.send(400, "application/json", "{\"error\":\"lines must be 1..1000\"}");
+            return;
+        }
+        lines = requested;
+    }
+    
+    LogStreamContext ctx;
+    ctx.server = &server;
+    ctx.length = 0;
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    server.sendContent("{\"type\":\"" + String(DebugLogger::getLogName(type)) + "\",\"logs\":\"");
+    DebugLogger::readTail(type, lines, streamLogChunk, &ctx);
+    if (ctx.length > 0) server.sendContent(ctx.buffer, ctx.length);
+    server.sendContent("\"}");
 }
 
-String WebAPI::escapeJSONString(const String& input) {
-    String result = input;
-    result.replace("\\", "\\\\");
-    result.replace("\"", "\\\"");
-    result.replace("\n", "\\n");
-    result.replace("\r", "\\r");
-    result.replace("\t", "\\t");
-    return result;
+static void streamJsonChunk(const char* data, size_t length, void* context) {
+    static_cast<WebServer*>(context)->sendContent(data, length);
 }
 
-void WebAPI::handleNotFound() {
-    server.send(404, "text/plain", "File Not Found");
+// Статистика планировщика читается с другого ядра без синхронизации: поля
+// по 32 бита, рассогласование между ними в диагностике допустимо
+void WebAPI::handleTasks() {
+    char buffer[256];
+    JsonWriter json(buffer, sizeof(buffer), streamJsonChunk, &server);
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    json.beginArray();
+    for (uint8_t id = 0; id < scheduler.getTaskCount(); id++) {
+        const Scheduler::TaskStats* stats = scheduler.getStats(id);
+        json.beginObject()
+            .field("name", scheduler.getTaskName(id))
+            .field("period", scheduler.getPeriod(id))
+            .field("runs", stats->runs)
+            .field("overruns", stats->overruns)
+            .field("jitterAvgUs", stats->runs ? (uint32_t)(stats->totalJitterUs / stats->runs) : 0)
+            .field("jitterMaxUs", stats->maxJitterUs)
+            .field("runMaxUs", stats->maxRunUs)
+            .endObject();
+    }
+    json.endArray();
+    json.flush();
+}
+
+// Буфер потоковой выдачи записей: отправляем порциями, а не по одной записи
+struct SensorStreamContext {
+    WebServer* server;
+    bool json;
+    bool first;
+    size_t length;
+    char buffer[512];
+};
+
+static void flushSensorStream(SensorStreamContext* ctx) {
+    if (ctx->length > 0) {
+        ctx->server->sendContent(ctx->buffer, ctx->length);
+        ctx->length = 0;
+    }
 }
 
-void WebAPI::handleClient() {
-    server.handleClient();
+static void streamSensorRecord(const SensorRecord& record, void* context) {
+    SensorStreamContext* ctx = static_cast<SensorStreamContext*>(context);
+    
+    if (!ctx->json) {
+        if (ctx->length + sizeof(record) > sizeof(ctx->buffer)) flushSensorStream(ctx);
+        memcpy(ctx->buffer + ctx->length, &record, sizeof(record));
+        ctx->length += sizeof(record);
+        return;
+    }
+    
+    if (ctx->length + 96 > sizeof(ctx->buffer)) flushSensorStream(ctx);
+    int n = snprintf(ctx->buffer + ctx->length, sizeof(ctx->buffer) - ctx->length,
+                     "%s{\"t\":%lu,\"boot\":%u,\"lux\":%.2f,\"relay\":%s,\"auto\":%s}",
+                     ctx->first ? "" : ",",
+                     (unsigned long)record.timestamp, (unsigned)record.bootCount, record.lux,
+                     (record.flags & SENSOR_FLAG_RELAY) ? "true" : "false",
+                     (record.flags & SENSOR_FLAG_AUTO) ? "true" : "false");
+    ctx->length += n;
+    ctx->first = false;
+}
+
+// GET /api/sensor?limit=N[&format=bin] - последние N записей хранилища показаний.
+// format=bin отдает сырые SensorRecord (12 байт, little-endian) для разбора вне устройства
+void WebAPI::handleSensorData() {
+    uint32_t limit = 100;
+    if (server.hasArg("limit")) {
+        long requested = server.arg("limit").toInt();
+        if (requested > 0) limit = requested;
+    }
+    
+    SensorStreamContext ctx;
+    ctx.server = &server;
+    ctx.json = server.arg("format") != "bin";
+    ctx.first = true;
+    ctx.length = 0;
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    if (ctx.json) {
+        server.send(200, "application/json", "");
+        char head[96];
+        JsonWriter json(head, sizeof(head));
+        json.beginObject()
+            .field("count", SensorStore::getCount())
+            .field("capacity", SensorStore::getCapacity())
+            .field("boot", SensorStore::getBootCount());
+        // Элементы массива дописывает streamSensorRecord, скобки закрываются вручную
+        json.key("records").raw("[");
+        server.sendContent(json.c_str(), json.length());
+    } else {
+        server.send(200, "application/octet-stream", "");
+    }
+    
+    SensorStore::readLatest(limit, streamSensorRecord, &ctx);
+    flushSensorStream(&ctx);
+    
+    if (ctx.json) server.sendContent("]}");
+}
+
+struct HistoryStreamContext {
+    WebServer* server;
+    JsonWriter* json;     // nullptr - двоичный ответ
+    size_t length;
+    char buffer[480];     // кратно 12 байтам HistoryBucket
+};
+
+static void streamHistoryBucket(uint32_t start, const HistoryBucket& bucket, void* context) {
+    HistoryStreamContext* ctx = static_cast<HistoryStreamContext*>(context);
+    
+    if (!ctx->json) {
+        if (ctx->length + sizeof(bucket) > sizeof(ctx->buffer)) {
+            ctx->server->sendContent(ctx->buffer, ctx->length);
+            ctx->length = 0;
+        }
+        memcpy(ctx->buffer + ctx->length, &bucket, sizeof(bucket));
+        ctx->length += sizeof(bucket);
+        return;
+    }
+    
+    // [min, max, mean, duty%]; null - показаний за интервал нет
+    if (!bucket.count) {
+        ctx->json->null();
+        return;
+    }
+    ctx->json->beginArray()
+        .value(bucket.minLux)
+        .value(bucket.maxLux)
+        .value(bucket.sumLux / bucket.count, 1)
+        .value((bucket.relayOn * 100 + bucket.count / 2) / bucket.count)
+        .endArray();
+}
+
+// Отрицательное значение - секунды назад от now
+static uint32_t historyTime(const String& arg, uint32_t now) {
+    long value = arg.toInt();
+    if (value >= 0) return value;
+    return (uint32_t)-value < now ? now + value : 0;
+}
+
+// GET /api/history?res=1m|15m|1h&from=T&to=T[&format=bin] - агрегаты освещенности.
+// Время в секундах шкалы истории: текущее значение приходит в поле now, data[i]
+// относится к интервалу from + i * seconds. format=bin: HistoryBinaryHeader и записи HistoryBucket
+void WebAPI::handleHistory() {
+    HistoryResolution resolution = HISTORY_MINUTE;
+    if (server.hasArg("res") && !History::parseResolution(server.arg("res"), resolution)) {
+        sendJsonError(400, "unknown resolution, expected 1m, 15m or 1h", "res");
+        return;
+    }
+    uint32_t now = History::now();
+    uint32_t to = server.hasArg("to") ? historyTime(server.arg("to"), now) : now;
+    uint32_t from = server.hasArg("from") ? historyTime(server.arg("from"), now) : 0;
+    if (from > to) {
+        sendJsonError(400, "from is after to", "from");
+        return;
+    }
+    uint32_t count = History::getRange(resolution, from, to);
+    
+    HistoryStreamContext ctx;
+    ctx.server = &server;
+    ctx.json = nullptr;
+    ctx.length = 0;
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    if (server.arg("format") == "bin") {
+        server.send(200, "application/octet-stream", "");
+        HistoryBinaryHeader header;
+        header.from = from;
+        header.seconds = History::getSeconds(resolution);
+        header.count = count;
+        memcpy(ctx.buffer, &header, sizeof(header));
+        ctx.length = sizeof(header);
+        History::read(resolution, from, to, streamHistoryBucket, &ctx);
+        if (ctx.length > 0) server.sendContent(ctx.buffer, ctx.length);
+        return;
+    }
+    
+    server.send(200, "application/json", "");
+    JsonWriter json(ctx.buffer, sizeof(ctx.buffer), streamJsonChunk, &server);
+    ctx.json = &json;
+    json.beginObject()
+        .field("res", History::getName(resolution))
+        .field("seconds", History::getSeconds(resolution))
+        .field("now", now)
+        .field("from", from)
+        .field("count", count);
+    json.key("fields").raw("[\"min\",\"max\",\"mean\",\"duty\"]");
+    json.key("data").beginArray();
+    History::read(resolution, from, to, streamHistoryBucket, &ctx);
+    json.endArray().endObject();
+    json.flush();
+}
+
+static void streamTraceChunk(const uint8_t* data, size_t length, void* context) {
+    static_cast<WebServer*>(context)->sendContent((const char*)data, length);
+}
+
+// GET /api/trace[?source=snapshot|crash] - кольцо трассировки или его снимок с флеша,
+// двоичный формат TraceFileHeader + TraceRecord[]; разбирается host/tools/trace_decode
+void WebAPI::handleTrace() {
+    String source = server.arg("source");
+    if (source == "") {
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/octet-stream", "");
+        EventTrace::read(streamTraceChunk, &server);
+        return;
+    }
+    
+    TraceSnapshotReason reason;
+    if (source == "snapshot") reason = TRACE_SNAPSHOT_REQUEST;
+    else if (source == "crash") reason = TRACE_SNAPSHOT_CRASH;
+    else {
+        server.send(400, "application/json", "{\"error\":\"source must be snapshot or crash\"}");
+        return;
+    }
+    
+    File file = LittleFS.open(EventTrace::getSnapshotPath(reason), "r");
+    if (!file) {
+        server.send(404, "application/json", "{\"error\":\"No snapshot\"}");
+        return;
+    }
+    server.streamFile(file, "application/octet-stream");
+    file.close();
+}
+
+void WebAPI::handleTraceSnapshot() {
+    if (!EventTrace::snapshot(TRACE_SNAPSHOT_REQUEST)) {
+        server.send(500, "application/json", "{\"error\":\"Snapshot failed\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"status\":\"ok\",\"count\":" + String(EventTrace::getCount()) +
+                ",\"dropped\":" + String(EventTrace::getDropped()) + "}");
+}
+
+// Кадр SSE "event: <имя>\ndata: <json>\n\n" собирается в одном буфере и уходит одним write
+struct EventFrame {
+    char buffer[256];
+    size_t prefix;
+    JsonWriter json;
+    
+    explicit EventFrame(const char* event)
+        : prefix(snprintf(buffer, sizeof(buffer), "event: %s\ndata: ", event)),
+          json(buffer + prefix, sizeof(buffer) - prefix - 2) {}
+    
+    size_t finish() {
+        size_t length = prefix + json.length();
+        buffer[length++] = '\n';
+        buffer[length++] = '\n';
+        return length;
+    }
+};
+
+WebAPI::EventState WebAPI::captureEventState() {
+    ControllerState shared = SharedState::read();
+    LuxSample sample = shared.getSample(millis());
+    EventState state;
+    state.relayState = shared.relayState;
+    state.autoMode = shared.config.autoMode;
+    state.sensorAvailable = shared.sensorAvailable;
+    state.luxValid = sample.valid;
+    state.threshold = shared.config.lightThreshold;
+    state.lux = sample.lux;
+    return state;
+}
+
+uint8_t WebAPI::countEventClients() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) {
+        if (eventClients[i].connected()) count++;
+        else eventClients[i].stop();   // отпускаем сокет отключившегося клиента
+    }
+    return count;
+}
+
+void WebAPI::broadcastEvent(const char* frame, size_t length) {
+    for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) {
+        if (!eventClients[i].connected()) continue;
+        // Недописанный кадр сломает поток - такого клиента отключаем, браузер переподключится сам
+        if (eventClients[i].write((const uint8_t*)frame, length) != length) {
+            eventClients[i].stop();
+        }
+    }
+    lastEventTime = millis();
+}
+
+// GET /api/events - Server-Sent Events. Сразу полное состояние (поля /api/status),
+// дальше event: status только с изменившимися полями и event: heartbeat раз в 15 с
+void WebAPI::handleEvents() {
+    bool first = countEventClients() == 0;
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < MAX_EVENT_CLIENTS; i++) {
+        if (!eventClients[i].connected()) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        // Страница в этом случае остается на опросе /api/status
+        sendJsonError(503, "too many event clients");
+        return;
+    }
+    
+    // Ответ без длины и без chunked: поток закрывает только клиент.
+    // Сокет забираем у сервера целиком: пока у него открытый клиент, ESP32 WebServer
+    // до HTTP_MAX_CLOSE_WAIT (2 с) ждет закрытия и другие запросы не принимает
+    WiFiClient client = server.client();
+    server.client() = WiFiClient();
+    // Медленный подписчик держит веб-задачу не дольше EVENT_WRITE_TIMEOUT на кадр
+    client.setTimeout(EVENT_WRITE_TIMEOUT);
+    static const char HEAD[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "retry: 3000\n\n";
+    client.write((const uint8_t*)HEAD, sizeof(HEAD) - 1);
+    
+    EventState state = captureEventState();
+    EventFrame frame("status");
+    frame.json.beginObject()
+        .field("relayState", state.relayState)
+        .field("autoMode", state.autoMode)
+        .field("sensorAvailable", state.sensorAvailable)
+        .field("luxValid", state.luxValid)
+        .field("threshold", state.threshold)
+        .field("lux", state.lux)
+        .field("uptime", millis() / 1000)
+        .endObject();
+    size_t length = frame.finish();
+    if (client.write((const uint8_t*)frame.buffer, length) != length) {
+        client.stop();
+        return;
+    }
+    
+    eventClients[slot] = client;
+    if (first) {
+        lastEvent = state;
+        lastEventTime = millis();
+    }
+    DEBUG_LOGF(LOG_MODULE_WEB, "📡 Подписчик /api/events #%d", slot);
+}
+
+void WebAPI::pushEvents() {
+    if (countEventClients() == 0) return;
+    
+    EventState state = captureEventState();
+    EventFrame frame("status");
+    JsonWriter& json = frame.json;
+    json.beginObject();
+    bool changed = false;
+    
+    if (state.relayState != lastEvent.relayState) {
+        json.field("relayState", state.relayState);
+        changed = true;
+    }
+    if (state.autoMode != lastEvent.autoMode) {
+        json.field("autoMode", state.autoMode);
+        changed = true;
+    }
+    if (state.sensorAvailable != lastEvent.sensorAvailable) {
+        json.field("sensorAvailable", state.sensorAvailable);
+        changed = true;
+    }
+    if (state.threshold != lastEvent.threshold) {
+        json.field("threshold", state.threshold);
+        changed = true;
+    }
+    // Шум датчика не рассылаем: lastEvent.lux обновляется только вместе с отправкой
+    float deadband = max(EVENT_LUX_DEADBAND, lastEvent.lux * EVENT_LUX_DEADBAND_RATIO);
+    if (state.luxValid != lastEvent.luxValid || fabsf(state.lux - lastEvent.lux) >= deadband) {
+        json.field("luxValid", state.luxValid).field("lux", state.lux);
+        changed = true;
+    } else {
+        state.lux = lastEvent.lux;
+    }
+    
+    if (changed) {
+        json.endObject();
+        lastEvent = state;
+        broadcastEvent(frame.buffer, frame.finish());
+        return;
+    }
+    
+    if (millis() - lastEventTime >= EVENT_HEARTBEAT_INTERVAL) {
+        EventFrame heartbeat("heartbeat");
+        heartbeat.json.beginObject().field("uptime", millis() / 1000).endObject();
+        broadcastEvent(heartbeat.buffer, heartbeat.finish());
+    }
+}
+
+void WebAPI::handleNotFound() {
+    server.send(404, "text/plain", "File Not Found");
 }
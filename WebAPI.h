@@ -0,0 +1,81 @@
+// WebAPI.h
+#ifndef WEB_API_H
+#define WEB_API_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebServer.h>
+#include "Config.h"
+#include "EventTrace.h"
+#include "JsonWriter.h"
+#include "Metrics.h"
+#include "SharedState.h"
+
+class WebAPI {
+public:
+    static const uint32_t WEB_TASK_STACK = 8192;
+    
+    // Поднимает точку доступа и запускает сервер в отдельной задаче на ядре 0
+    void begin();
+    
+private:
+    // Состояние, которое видят подписчики /api/events; сравнивается с последним отправленным
+    struct EventState {
+        bool relayState;
+        bool autoMode;
+        bool sensorAvailable;
+        bool luxValid;
+        float threshold;
+        float lux;
+    };
+    
+    WebServer server;
+    TaskHandle_t taskHandle = nullptr;
+    WiFiClient eventClients[MAX_EVENT_CLIENTS];
+    EventState lastEvent = {};
+    unsigned long lastEventTime = 0;
+    
+    static void webTask(void* param);
+    void setupRoutes();
+    void handleRoot();
+    void handleStatus();
+    void handleControl();
+    void handleSettings();
+    void handleGetSettings();
+    void handleLogs();
+    void handleTasks();
+    void handleSensorData();
+    void handleHistory();
+    void handleGetClock();
+    void handleClock();
+    void handleZones();
+    void handleGetZone();
+    void handleZone();
+    bool findZone(const ControllerState& state, uint8_t& zone);   // false - ответ с ошибкой уже отправлен
+    void sendZone(const ControllerState& state, uint8_t zone);
+    void handleTrace();
+    void handleTraceSnapshot();
+    void handleEvents();
+    void handleMetrics();
+    // Время каждого обработчика - в гистограмму /api/metrics
+    void metered(MetricHistogram metric, void (WebAPI::*handler)());
+    // Изменяющие запросы и ошибки пишутся еще и в трассировку; опросы GET - нет, чтобы не вытеснять события реле
+    void traced(TraceRoute route, MetricHistogram metric, void (WebAPI::*handler)());
+    void handleNotFound();
+    
+    // Ответ из буфера JsonWriter одним куском, без копии в String
+    void sendJson(int code, JsonWriter& json);
+    void sendJsonError(int code, const char* message, const char* field = nullptr, int position = -1);
+    void sendSettings(const Settings& settings);
+    bool postCommand(const ControlCommand& command);   // false - ответ 503 уже отправлен
+    
+    // Изменения состояния подписчикам /api/events, раз в EVENT_PUSH_INTERVAL
+    void pushEvents();
+    EventState captureEventState();
+    uint8_t countEventClients();
+    void broadcastEvent(const char* frame, size_t length);
+};
+
+extern WebAPI webAPI;
+
+#endif
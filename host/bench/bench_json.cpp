@@ -0,0 +1,178 @@
+// bench_json.cpp - JsonWriter/JsonReader против прежних String-конкатенации и indexOf
+//
+// Пример: build/json_bench --iterations 200000
+#include "Arduino.h"
+#include "HostHal.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+volatile size_t sink;   // результат, чтобы компилятор не выбросил работу
+
+struct Result {
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;   // размер документа
+};
+
+template<typename F>
+Result measure(uint32_t iterations, F body) {
+    host::Stats& st = host::stats();
+    uint64_t a0 = st.allocCount;
+    size_t bytes = 0;
+    host::setAllocTracking(true);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) bytes += body(i);
+    auto t1 = std::chrono::steady_clock::now();
+    host::setAllocTracking(false);
+    sink = bytes;
+    return Result{std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations,
+                  (double)(st.allocCount - a0) / iterations, (double)bytes / iterations};
+}
+
+void print(const char* title, const Result& r) {
+    printf("%-34s %8.0f ns/op %6.1f allocs/op %6.0f B %8.1f MB/s\n", title, r.nsPerOp, r.allocsPerOp,
+           r.bytesPerOp, r.bytesPerOp / r.nsPerOp * 1e3);
+}
+
+// Тот же набор полей, что у /api/status
+size_t statusString(uint32_t i) {
+    String json = "{";
+    json += "\"relayState\":" + String(i & 1 ? "true" : "false") + ",";
+    json += "\"lux\":" + String(123.45f + i % 100) + ",";
+    json += "\"luxAge\":" + String(i % 500) + ",";
+    json += "\"luxValid\":" + String("true") + ",";
+    json += "\"sampleRate\":" + String(2.0f) + ",";
+    json += "\"autoMode\":" + String("true") + ",";
+    json += "\"threshold\":" + String(500.0f) + ",";
+    json += "\"uptime\":" + String(i) + ",";
+    json += "\"sensorAvailable\":" + String("true") + ",";
+    json += "\"wifiStatus\":\"" + String("ap") + "\",";
+    json += "\"logQueue\":{";
+    json += "\"enqueued\":" + String(i * 3) + ",";
+    json += "\"written\":" + String(i * 3) + ",";
+    json += "\"dropped\":" + String(0) + ",";
+    json += "\"truncated\":" + String(0) + ",";
+    json += "\"batches\":" + String(i) + ",";
+    json += "\"depth\":" + String(0) + ",";
+    json += "\"highWater\":" + String(12);
+    json += "}}";
+    return json.length();
+}
+
+size_t statusWriter(uint32_t i) {
+    char buffer[512];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("relayState", (bool)(i & 1))
+        .field("lux", 123.45f + i % 100)
+        .field("luxAge", i % 500)
+        .field("luxValid", true)
+        .field("sampleRate", 2.0f)
+        .field("autoMode", true)
+        .field("threshold", 500.0f)
+        .field("uptime", i)
+        .field("sensorAvailable", true)
+        .field("wifiStatus", "ap");
+    json.key("logQueue").beginObject()
+        .field("enqueued", i * 3)
+        .field("written", i * 3)
+        .field("dropped", 0)
+        .field("truncated", 0)
+        .field("batches", i)
+        .field("depth", 0)
+        .field("highWater", 12)
+        .endObject();
+    json.endObject();
+    return json.length();
+}
+
+const char SETTINGS_BODY[] =
+    "{\"lightThreshold\": 750.5, \"checkInterval\": 5000, \"sensorLogInterval\": 10000,\n"
+    " \"sampleMaxAge\": 2000, \"autoMode\": true, \"manualOn\": false, \"debugEnabled\": false,\n"
+    " \"maxLogSize\": 65536, \"sensorStoreSize\": 524288, \"schedule\": \"07:30-21:00\"}";
+
+// Прежний разбор: indexOf по ключу и substring до запятой
+float findNumber(const String& body, const char* key) {
+    int index = body.indexOf(key);
+    if (index < 0) return 0;
+    int start = index + strlen(key);
+    int end = body.indexOf(",", start);
+    if (end == -1) end = body.indexOf("}", start);
+    return body.substring(start, end).toFloat();
+}
+
+size_t settingsIndexOf(uint32_t i) {
+    String body = SETTINGS_BODY;   // server.arg("plain") тоже отдает копию
+    float sum = findNumber(body, "\"lightThreshold\": ") + findNumber(body, "\"checkInterval\": ") +
+                findNumber(body, "\"sensorLogInterval\": ") + findNumber(body, "\"sampleMaxAge\": ") +
+                findNumber(body, "\"maxLogSize\": ") + findNumber(body, "\"sensorStoreSize\": ");
+    bool autoMode = body.indexOf("\"autoMode\": true") != -1;
+    bool debug = body.indexOf("\"debugEnabled\": true") != -1;
+    sink = (size_t)sum + autoMode + debug;
+    return body.length();
+}
+
+size_t settingsReader(uint32_t i) {
+    JsonReader json(SETTINGS_BODY, sizeof(SETTINGS_BODY) - 1);
+    float sum = 0;
+    char text[16];
+    JsonToken token;
+    while ((token = json.next()) != JSON_END && token != JSON_ERROR) {
+        float value;
+        if (token == JSON_NUMBER && json.getFloat(value)) sum += value;
+        else if (token == JSON_STRING) json.copyString(text, sizeof(text));
+    }
+    sink = (size_t)sum;
+    return sizeof(SETTINGS_BODY) - 1;
+}
+
+// Крупный документ для оценки скорости токенизатора: массив задач как /api/tasks
+std::string makeTasksDocument(int count) {
+    char buffer[256];
+    std::string doc = "[";
+    for (int i = 0; i < count; i++) {
+        JsonWriter json(buffer, sizeof(buffer));
+        json.beginObject().field("name", "sensorSample").field("period", 500).field("runs", 1000 + i)
+            .field("overruns", 0).field("jitterAvgUs", 12).field("jitterMaxUs", 340)
+            .field("runMaxUs", 85).field("lux", 321.5f, 1).endObject();
+        if (i > 0) doc += ",";
+        doc.append(json.c_str(), json.length());
+    }
+    return doc + "]";
+}
+
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = 200000;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--iterations" && i + 1 < argc) iterations = (uint32_t)atol(argv[++i]);
+        else {
+            printf("Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    host::markHeapBaseline();
+    host::setAllocTracking(false);
+    std::string tasks = makeTasksDocument(100);
+
+    printf("=== JSON host benchmark (%u iterations) ===\n", iterations);
+    print("status: String concatenation", measure(iterations, statusString));
+    print("status: JsonWriter", measure(iterations, statusWriter));
+    print("settings: String indexOf", measure(iterations, settingsIndexOf));
+    print("settings: JsonReader", measure(iterations, settingsReader));
+    print("tokenize 100 tasks: JsonReader", measure(iterations / 20, [&](uint32_t) {
+        JsonReader json(tasks.data(), tasks.size());
+        size_t tokens = 0;
+        while (json.next() > JSON_ERROR) tokens++;
+        sink = tokens;
+        return tasks.size();
+    }));
+    return 0;
+}
@@ -0,0 +1,366 @@
+// bench_loop.cpp - прогон setup()/loop() на виртуальных часах с замером задержек
+//
+// Пример: build/phyto_bench --hours 24 --http-interval 3
+#include "Arduino.h"
+#include "Config.h"
+#include "HostHal.h"
+#include "LittleFS.h"
+#include "Veml7700Driver.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+void setup();
+void loop();
+
+namespace {
+
+struct Options {
+    double hours = 1.0;
+    double httpInterval = 0.0;   // период запросов к веб-серверу, с (0 - без нагрузки)
+    const char* httpPath = "/api/status";
+    const char* httpHeader = nullptr;   // дополнительная строка заголовка запроса
+    const char* httpBody = "";          // тело запроса POST
+    bool noSensor = false;
+    bool noDebug = false;        // config.debugEnabled = false после setup()
+    bool serial = false;
+    bool keepFs = false;
+    const char* fsDir = nullptr;  // каталог LittleFS от прошлого прогона ("перезагрузка")
+    bool httpDump = false;       // вывести последний ответ сервера
+    int sseClients = 0;          // подписчики /api/events на весь прогон
+    bool sntp = false;           // SNTP отвечает; время совпадает с моделью солнца
+    int zones = 0;               // >0: TCA9548A и столько датчиков за ним
+    bool veml = false;           // VEML7700 на 0x10 вместо BH1750
+    float peakLux = 0;           // солнечный максимум, 0 - по умолчанию модели
+    int resetReason = 1;         // esp_reset_reason(): 1 - питание, 4 - паника, 7 - сторожевой таймер
+    double outageStart = 0;      // датчик не отвечает с outageStart, с...
+    double outageLength = 0;     // ...столько секунд
+    bool stuckBus = false;       // после отказа датчик держит SDA
+    uint32_t seed = 1;
+};
+
+void usage(const char* prog) {
+    printf("Usage: %s [--hours N] [--http-interval SEC] [--http-path PATH] [--http-header H]\n"
+           "          [--http-body JSON] [--http-dump] [--sse-clients N] [--sntp] [--zones N] [--veml] [--peak-lux LUX] [--reset-reason N] [--sensor-outage START,SEC] [--stuck-bus] [--no-sensor] [--no-debug] [--serial] [--keep-fs] [--fs DIR] [--seed N]\n", prog);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--hours" && hasValue) opt.hours = atof(argv[++i]);
+        else if (a == "--http-interval" && hasValue) opt.httpInterval = atof(argv[++i]);
+        else if (a == "--http-path" && hasValue) opt.httpPath = argv[++i];
+        else if (a == "--http-header" && hasValue) opt.httpHeader = argv[++i];
+        else if (a == "--http-body" && hasValue) opt.httpBody = argv[++i];
+        else if (a == "--http-dump") opt.httpDump = true;
+        else if (a == "--sse-clients" && hasValue) opt.sseClients = atoi(argv[++i]);
+        else if (a == "--sntp") opt.sntp = true;
+        else if (a == "--zones" && hasValue) opt.zones = atoi(argv[++i]);
+        else if (a == "--veml") opt.veml = true;
+        else if (a == "--peak-lux" && hasValue) opt.peakLux = atof(argv[++i]);
+        else if (a == "--reset-reason" && hasValue) opt.resetReason = atoi(argv[++i]);
+        else if (a == "--sensor-outage" && hasValue) {
+            if (sscanf(argv[++i], "%lf,%lf", &opt.outageStart, &opt.outageLength) != 2) return false;
+        }
+        else if (a == "--stuck-bus") opt.stuckBus = true;
+        else if (a == "--no-sensor") opt.noSensor = true;
+        else if (a == "--no-debug") opt.noDebug = true;
+        else if (a == "--serial") opt.serial = true;
+        else if (a == "--keep-fs") opt.keepFs = true;
+        else if (a == "--fs" && hasValue) { opt.fsDir = argv[++i]; opt.keepFs = true; }
+        else if (a == "--seed" && hasValue) opt.seed = (uint32_t)atol(argv[++i]);
+        else return false;
+    }
+    return true;
+}
+
+template<typename T>
+T percentile(std::vector<T>& samples, double p) {
+    if (samples.empty()) return T();
+    size_t k = (size_t)(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+template<typename T>
+void printPercentiles(const char* title, const char* unit, std::vector<T> samples) {
+    if (samples.empty()) {
+        printf("%-28s нет данных\n", title);
+        return;
+    }
+    T maxValue = *std::max_element(samples.begin(), samples.end());
+    printf("%-28s p50=%-8.1f p90=%-8.1f p99=%-8.1f p99.9=%-8.1f max=%.1f %s\n", title,
+           (double)percentile(samples, 0.50), (double)percentile(samples, 0.90),
+           (double)percentile(samples, 0.99), (double)percentile(samples, 0.999),
+           (double)maxValue, unit);
+}
+
+// Клиент HTTP на loopback: запрос уходит в очередь accept() до следующего loop()
+struct HttpProbe {
+    int fd = -1;
+    uint64_t dueMicros = 0;
+    std::vector<double> latencyMs;
+    uint64_t failures = 0;
+    std::string response;
+    std::string lastResponse;
+
+    bool issue(const char* path, const char* header, const char* body) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(host::httpPort());
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        response.clear();
+        // "POST /api/..." - запрос с телом --http-body, иначе GET
+        std::string method = "GET";
+        if (strncmp(path, "POST ", 5) == 0) {
+            method = "POST";
+            path += 5;
+        } else {
+            body = "";
+        }
+        std::string req = method + " " + path + " HTTP/1.1\r\nHost: phyto\r\nContent-Length: " +
+                          std::to_string(strlen(body)) + "\r\n";
+        if (header) req += std::string(header) + "\r\n";
+        req += "\r\n";
+        req += body;
+        send(fd, req.data(), req.size(), MSG_NOSIGNAL);
+        return true;
+    }
+
+    // Ответ готов, когда сервер закрыл соединение
+    bool poll(uint64_t dispatchedAt) {
+        if (fd < 0) return true;
+        char buf[4096];
+        while (true) {
+            ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n > 0) {
+                response.append(buf, n);
+                continue;
+            }
+            if (n == 0) {
+                lastResponse.swap(response);
+                latencyMs.push_back((dispatchedAt - dueMicros) / 1000.0);
+                ::close(fd);
+                fd = -1;
+                return true;
+            }
+            return false;
+        }
+    }
+};
+
+// Подписчик /api/events: соединение держится весь прогон, кадры считаются по типу
+struct SseProbe {
+    int fd = -1;
+    std::string pending;
+    std::string lastFrame;
+    uint64_t bytes = 0;
+    uint64_t statusEvents = 0;
+    uint64_t heartbeats = 0;
+    uint64_t disconnects = 0;
+
+    bool connect() {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(host::httpPort());
+        if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        const char req[] = "GET /api/events HTTP/1.1\r\nHost: phyto\r\nAccept: text/event-stream\r\n\r\n";
+        send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL);
+        return true;
+    }
+
+    void poll() {
+        if (fd < 0) return;
+        char buf[4096];
+        while (true) {
+            ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n > 0) {
+                bytes += n;
+                pending.append(buf, n);
+                continue;
+            }
+            if (n == 0) {
+                disconnects++;
+                ::close(fd);
+                fd = -1;
+            }
+            break;
+        }
+        // Кадры SSE разделены пустой строкой; первый кусок - заголовки HTTP
+        size_t end;
+        while ((end = pending.find("\n\n")) != std::string::npos) {
+            std::string frame = pending.substr(0, end);
+            pending.erase(0, end + 2);
+            if (frame.compare(0, 13, "event: status") == 0) statusEvents++;
+            else if (frame.compare(0, 16, "event: heartbeat") == 0) heartbeats++;
+            else continue;
+            lastFrame = frame;
+        }
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    host::env().sensorPresent = !opt.noSensor;
+    host::env().seed = opt.seed;
+    host::env().muxZones = opt.zones < 0 ? 0 : opt.zones > MAX_ZONES ? MAX_ZONES : opt.zones;
+    memcpy(host::env().lampPins, ZONE_RELAY_PINS, MAX_ZONES);
+    if (opt.veml) {
+        host::env().sensorModel = host::SENSOR_VEML7700;
+        host::env().sensorAddress = Veml7700Driver::ADDRESS;
+    }
+    if (opt.peakLux > 0) host::env().peakLux = opt.peakLux;
+    host::env().resetReason = opt.resetReason;
+    host::env().outageStart = opt.outageStart;
+    host::env().outageEnd = opt.outageStart + opt.outageLength;
+    host::env().outageStuck = opt.stuckBus;
+    // 2026-10-17 + startHour по местному времени настроек по умолчанию:
+    // полдень по часам контроллера совпадает с полднем модели освещенности
+    if (opt.sntp) {
+        host::env().sntpTime = 1792195200 + (uint32_t)(host::env().startHour * 3600) -
+                               Settings().timezoneOffset * 60;
+    }
+    host::setSerialEcho(opt.serial);
+    if (opt.fsDir) host::setFsRoot(opt.fsDir);
+    randomSeed(opt.seed);
+
+    host::markHeapBaseline();
+    host::Stats& st = host::stats();
+
+    auto wallStart = std::chrono::steady_clock::now();
+    uint64_t setupAllocs = st.allocCount;
+    setup();
+    double setupWallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    uint64_t setupVirtualMs = host::nowMicros() / 1000;
+    setupAllocs = st.allocCount - setupAllocs;
+    uint64_t setupFsBytes = st.fsBytesWritten;
+    if (opt.noDebug) config.debugEnabled = false;
+
+    std::vector<float> wallUs;
+    std::vector<float> blockedMs;
+    std::vector<uint32_t> allocsPerIter;
+    uint64_t loopAllocs = st.allocCount;
+    uint64_t loopAllocBytes = st.allocBytes;
+
+    HttpProbe probe;
+    std::vector<SseProbe> sse(opt.sseClients);
+    for (auto& client : sse) client.connect();
+    uint64_t httpPeriod = (uint64_t)(opt.httpInterval * 1e6);
+    uint64_t nextHttp = host::nowMicros() + httpPeriod;
+    uint64_t endMicros = host::nowMicros() + (uint64_t)(opt.hours * 3600e6);
+
+    host::setAllocTracking(false);
+    while (host::nowMicros() < endMicros) {
+        if (httpPeriod && probe.fd < 0 && host::nowMicros() >= nextHttp) {
+            probe.dueMicros = nextHttp;
+            if (!probe.issue(opt.httpPath, opt.httpHeader, opt.httpBody)) probe.failures++;
+            nextHttp += httpPeriod;
+        }
+
+        uint64_t v0 = host::nowMicros();
+        uint64_t a0 = st.allocCount;
+        uint64_t h0 = st.httpRequests;
+        host::setAllocTracking(true);
+        // Время других задач FreeRTOS, отработавших пока loop() спал, не учитывается
+        uint64_t c0 = host::taskCpuNanos();
+        loop();
+        uint64_t c1 = host::taskCpuNanos();
+        host::setAllocTracking(false);
+
+        wallUs.push_back((c1 - c0) / 1000.0f);
+        blockedMs.push_back((host::nowMicros() - v0) / 1000.0f);
+        allocsPerIter.push_back((uint32_t)(st.allocCount - a0));
+
+        if (probe.fd >= 0 && st.httpRequests != h0) probe.poll(st.lastHttpMicros);
+        for (auto& client : sse) client.poll();
+        // Цикл без собственных ожиданий не должен зависнуть на месте
+        if (host::nowMicros() == v0) host::advanceMicros(1000);
+    }
+
+    double wallTotal = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double hours = (host::nowMicros() / 1e6 - setupVirtualMs / 1e3) / 3600.0;
+    uint64_t fsLoop = st.fsBytesWritten - setupFsBytes;
+
+    printf("=== PhytoController host benchmark ===\n");
+    printf("virtual time                 %.2f h (%zu iterations), wall %.2f s\n", hours, wallUs.size(), wallTotal);
+    printf("setup()                      virtual %llu ms, wall %.2f ms, %llu allocations\n",
+           (unsigned long long)setupVirtualMs, setupWallMs, (unsigned long long)setupAllocs);
+    printPercentiles("loop() CPU time", "us", wallUs);
+    printPercentiles("loop() blocked (virtual)", "ms", blockedMs);
+    printPercentiles("loop() allocations", "allocs", allocsPerIter);
+    printf("allocations in loop()        %llu (%.1f per iteration, %.1f KB total, %.0f B/iteration)\n",
+           (unsigned long long)(st.allocCount - loopAllocs),
+           wallUs.empty() ? 0.0 : (double)(st.allocCount - loopAllocs) / wallUs.size(),
+           (st.allocBytes - loopAllocBytes) / 1024.0,
+           wallUs.empty() ? 0.0 : (double)(st.allocBytes - loopAllocBytes) / wallUs.size());
+    printf("peak live heap               %lld bytes, min free heap %u bytes\n",
+           (long long)st.peakLiveBytes, ESP.getMinFreeHeap());
+    printf("LittleFS written             %llu bytes (%.1f KB/h), read %llu bytes, %llu opens\n",
+           (unsigned long long)st.fsBytesWritten, hours > 0 ? fsLoop / 1024.0 / hours : 0.0,
+           (unsigned long long)st.fsBytesRead, (unsigned long long)st.fsOpens);
+    printf("LittleFS used                %zu / %zu bytes\n", LittleFS.usedBytes(), LittleFS.totalBytes());
+    printf("Serial output                %llu bytes\n", (unsigned long long)st.serialBytes);
+    printf("I2C transactions             %llu\n", (unsigned long long)st.i2cTransactions);
+    printf("PWM writes                   %llu\n", (unsigned long long)st.pwmWrites);
+    if (httpPeriod) {
+        printf("HTTP requests                %llu served, %llu failed to connect\n",
+               (unsigned long long)st.httpRequests, (unsigned long long)probe.failures);
+        printPercentiles("HTTP wait (virtual)", "ms", probe.latencyMs);
+        if (opt.httpDump) {
+            // Тело может быть двоичным (gzip, /api/trace) - выводим как есть, без обрыва на нуле
+            printf("--- last response ---\n");
+            fwrite(probe.lastResponse.data(), 1, probe.lastResponse.size(), stdout);
+            printf("\n");
+        }
+    }
+
+    if (!sse.empty()) {
+        uint64_t status = 0, heartbeats = 0, bytes = 0, disconnects = 0;
+        for (auto& client : sse) {
+            status += client.statusEvents;
+            heartbeats += client.heartbeats;
+            bytes += client.bytes;
+            disconnects += client.disconnects;
+        }
+        printf("SSE /api/events              %d clients: %llu status, %llu heartbeat events, %.1f KB, %llu disconnects\n",
+               opt.sseClients, (unsigned long long)status, (unsigned long long)heartbeats, bytes / 1024.0,
+               (unsigned long long)disconnects);
+        if (opt.httpDump) printf("--- last event ---\n%s\n", sse[0].lastFrame.c_str());
+    }
+
+    if (opt.keepFs) {
+        printf("LittleFS directory           %s\n", host::fsRoot().c_str());
+    } else {
+        LittleFS.format();
+        rmdir(host::fsRoot().c_str());
+    }
+    return 0;
+}
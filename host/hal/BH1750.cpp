@@ -0,0 +1,97 @@
+// BH1750.cpp - хостовая модель BH1750: время преобразования, MTreg и насыщение АЦП
+#include "BH1750.h"
+#include "HostHal.h"
+
+bool BH1750::begin(Mode m, byte addr, TwoWire* bus) {
+    if (bus) i2c = bus;
+    if (addr) address = addr;
+    return configure(m) && setMTreg(BH1750_DEFAULT_MTREG);
+}
+
+bool BH1750::configure(Mode m) {
+    switch (m) {
+        case CONTINUOUS_HIGH_RES_MODE:
+        case CONTINUOUS_HIGH_RES_MODE_2:
+        case CONTINUOUS_LOW_RES_MODE:
+        case ONE_TIME_HIGH_RES_MODE:
+        case ONE_TIME_HIGH_RES_MODE_2:
+        case ONE_TIME_LOW_RES_MODE:
+            break;
+        default:
+            return false;
+    }
+    i2c->beginTransmission(address);
+    i2c->write((uint8_t)m);
+    if (i2c->endTransmission() != 0) return false;
+    mode = m;
+    startedAt = host::nowMicros();
+    return true;
+}
+
+bool BH1750::setMTreg(byte MTreg) {
+    if (MTreg < BH1750_MTREG_MIN || MTreg > BH1750_MTREG_MAX) return false;
+    i2c->beginTransmission(address);
+    i2c->write((uint8_t)(0x40 | (MTreg >> 5)));
+    uint8_t ack = i2c->endTransmission();
+    i2c->beginTransmission(address);
+    i2c->write((uint8_t)(0x60 | (MTreg & 0x1F)));
+    ack |= i2c->endTransmission();
+    if (ack != 0) return false;
+    mtreg = MTreg;
+    // Смена MTreg перезапускает преобразование
+    return configure(mode == UNCONFIGURED ? CONTINUOUS_HIGH_RES_MODE : mode);
+}
+
+uint32_t BH1750::conversionMicros(bool maxWait) const {
+    bool lowRes = mode == CONTINUOUS_LOW_RES_MODE || mode == ONE_TIME_LOW_RES_MODE;
+    uint32_t base = lowRes ? (maxWait ? 24 : 16) : (maxWait ? 180 : 120);
+    return base * 1000u * mtreg / BH1750_DEFAULT_MTREG;
+}
+
+bool BH1750::measurementReady(bool maxWait) {
+    uint64_t ready = startedAt + conversionMicros(maxWait);
+    uint64_t now = host::nowMicros();
+    if (now >= ready) return true;
+    if (maxWait) {
+        host::advanceMicros(ready - now);
+        return true;
+    }
+    return false;
+}
+
+uint16_t BH1750::sampleCounts() {
+    uint32_t conv = conversionMicros(false);
+    uint64_t now = host::nowMicros();
+    bool oneTime = mode >= ONE_TIME_HIGH_RES_MODE;
+    uint64_t at;
+    if (oneTime) {
+        // Незавершенное одиночное преобразование возвращает прошлый результат
+        if (now < startedAt + conv) return lastCounts;
+        at = startedAt + conv;
+    } else {
+        if (now < startedAt + conv) return lastCounts;
+        at = now - (now - startedAt) % conv;
+    }
+    // Датчик за мультиплексором видит свет той зоны, чей канал выбран
+    double lux = host::ambientLux(at, i2c->hostMuxChannel());
+    double counts = lux * 1.2 * mtreg / BH1750_DEFAULT_MTREG;
+    if (mode == CONTINUOUS_HIGH_RES_MODE_2 || mode == ONE_TIME_HIGH_RES_MODE_2) counts *= 2;
+    if (counts > 65535) counts = 65535;
+    lastCounts = (uint16_t)counts;
+    return lastCounts;
+}
+
+float BH1750::readLightLevel() {
+    if (mode == UNCONFIGURED) return -2.0f;
+    uint16_t counts = sampleCounts();
+    uint8_t raw[2] = {(uint8_t)(counts >> 8), (uint8_t)(counts & 0xFF)};
+    i2c->hostSetResponse(address, raw, 2);
+    if (i2c->requestFrom(address, (uint8_t)2) != 2) return -1.0f;
+    unsigned int value = (unsigned int)i2c->read() << 8;
+    value |= (unsigned int)i2c->read();
+
+    float level = value;
+    if (mtreg != BH1750_DEFAULT_MTREG) level *= (float)BH1750_DEFAULT_MTREG / mtreg;
+    if (mode == CONTINUOUS_HIGH_RES_MODE_2 || mode == ONE_TIME_HIGH_RES_MODE_2) level /= 2;
+    return level / 1.2f;
+}
@@ -0,0 +1,43 @@
+// BH1750.h - хостовая замена библиотеки claws/BH1750 с тем же API
+#ifndef HOST_BH1750_H
+#define HOST_BH1750_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define BH1750_DEFAULT_MTREG 69
+#define BH1750_MTREG_MIN 31
+#define BH1750_MTREG_MAX 254
+
+class BH1750 {
+public:
+    enum Mode {
+        UNCONFIGURED = 0,
+        CONTINUOUS_HIGH_RES_MODE = 0x10,
+        CONTINUOUS_HIGH_RES_MODE_2 = 0x11,
+        CONTINUOUS_LOW_RES_MODE = 0x13,
+        ONE_TIME_HIGH_RES_MODE = 0x20,
+        ONE_TIME_HIGH_RES_MODE_2 = 0x21,
+        ONE_TIME_LOW_RES_MODE = 0x23
+    };
+
+    BH1750(byte addr = 0x23) : address(addr) {}
+    bool begin(Mode mode = CONTINUOUS_HIGH_RES_MODE, byte addr = 0x23, TwoWire* i2c = nullptr);
+    bool configure(Mode mode);
+    bool setMTreg(byte MTreg);
+    bool measurementReady(bool maxWait = false);
+    float readLightLevel();
+
+private:
+    uint32_t conversionMicros(bool maxWait) const;
+    uint16_t sampleCounts();
+
+    byte address;
+    TwoWire* i2c = &Wire;
+    Mode mode = UNCONFIGURED;
+    byte mtreg = BH1750_DEFAULT_MTREG;
+    uint64_t startedAt = 0;      // момент начала текущего преобразования (мкс)
+    uint16_t lastCounts = 0;
+};
+
+#endif
@@ -0,0 +1,247 @@
+// FS.cpp - хостовая файловая система поверх каталога на диске
+#include "LittleFS.h"
+#include "HostHal.h"
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+fs::LittleFSFS LittleFS;
+
+namespace host {
+
+static std::string gFsRoot;
+
+const std::string& fsRoot() { return gFsRoot; }
+void setFsRoot(const std::string& dir) { gFsRoot = dir; }
+
+}
+
+namespace fs {
+
+// Размер раздела LittleFS в стандартной схеме разделов ESP32
+static const size_t HOST_FS_TOTAL = 0x160000;
+static const size_t HOST_FS_BLOCK = 4096;
+
+struct FileImpl {
+    FILE* fp = nullptr;
+    DIR* dir = nullptr;
+    std::string path;       // путь внутри LittleFS
+    std::string name;       // последний компонент пути
+    ~FileImpl() {
+        if (fp) fclose(fp);
+        if (dir) closedir(dir);
+    }
+};
+
+static std::string hostPath(const char* path) {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return host::fsRoot() + p;
+}
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    size_t n = fwrite(buf, 1, size, impl->fp);
+    host::stats().fsBytesWritten += n;
+    return n;
+}
+
+int File::available() {
+    if (!impl || !impl->fp) return 0;
+    long pos = ftell(impl->fp);
+    long total = (long)size();
+    return total > pos ? (int)(total - pos) : 0;
+}
+
+int File::read() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if (c != EOF) host::stats().fsBytesRead++;
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if (c == EOF) return -1;
+    ungetc(c, impl->fp);
+    return c;
+}
+
+void File::flush() {
+    if (impl && impl->fp) fflush(impl->fp);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    size_t n = fread(buf, 1, size, impl->fp);
+    host::stats().fsBytesRead += n;
+    return n;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!impl || !impl->fp) return 0;
+    long pos = ftell(impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!impl) return 0;
+    if (impl->fp) {
+        fflush(impl->fp);
+        struct stat st;
+        if (fstat(fileno(impl->fp), &st) == 0) return (size_t)st.st_size;
+    }
+    return 0;
+}
+
+void File::close() {
+    impl.reset();
+}
+
+File::operator bool() const {
+    return impl && (impl->fp || impl->dir);
+}
+
+const char* File::path() const { return impl ? impl->path.c_str() : nullptr; }
+const char* File::name() const { return impl ? impl->name.c_str() : nullptr; }
+bool File::isDirectory() const { return impl && impl->dir; }
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->dir) return File();
+    struct dirent* entry;
+    while ((entry = readdir(impl->dir)) != nullptr) {
+        std::string n = entry->d_name;
+        if (n == "." || n == "..") continue;
+        std::string child = impl->path == "/" ? "/" + n : impl->path + "/" + n;
+        return LittleFS.open(child.c_str(), mode);
+    }
+    return File();
+}
+
+void File::rewindDirectory() {
+    if (impl && impl->dir) rewinddir(impl->dir);
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    (void)create;
+    if (!mounted || !path) return File();
+    std::string full = hostPath(path);
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    impl->name = baseName(impl->path);
+
+    struct stat st;
+    if (stat(full.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        impl->dir = opendir(full.c_str());
+        return impl->dir ? File(impl) : File();
+    }
+
+    // Режимы ESP32 совпадают с fopen; добавляем 'b', чтобы не было преобразований
+    std::string m = mode ? mode : "r";
+    if (m.find('b') == std::string::npos) m += "b";
+    impl->fp = fopen(full.c_str(), m.c_str());
+    if (!impl->fp) return File();
+    host::stats().fsOpens++;
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return mounted && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return mounted && ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return mounted && ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return mounted && (::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char* path) {
+    return mounted && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail; (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+    if (host::fsRoot().empty()) {
+        char tmpl[] = "/tmp/phytofs-XXXXXX";
+        if (!mkdtemp(tmpl)) return false;
+        host::setFsRoot(tmpl);
+    }
+    ::mkdir(host::fsRoot().c_str(), 0755);
+    mounted = true;
+    return true;
+}
+
+void LittleFSFS::end() {
+    mounted = false;
+}
+
+static size_t usedIn(const std::string& dir) {
+    size_t used = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string n = entry->d_name;
+        if (n == "." || n == "..") continue;
+        std::string child = dir + "/" + n;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) used += HOST_FS_BLOCK + usedIn(child);
+        else used += (st.st_size + HOST_FS_BLOCK - 1) / HOST_FS_BLOCK * HOST_FS_BLOCK;
+    }
+    closedir(d);
+    return used;
+}
+
+static void removeTree(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string n = entry->d_name;
+        if (n == "." || n == "..") continue;
+        std::string child = dir + "/" + n;
+        struct stat st;
+        if (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            removeTree(child);
+            ::rmdir(child.c_str());
+        } else {
+            ::remove(child.c_str());
+        }
+    }
+    closedir(d);
+}
+
+bool LittleFSFS::format() {
+    if (host::fsRoot().empty()) return false;
+    removeTree(host::fsRoot());
+    return true;
+}
+
+size_t LittleFSFS::totalBytes() { return HOST_FS_TOTAL; }
+size_t LittleFSFS::usedBytes() { return mounted ? usedIn(host::fsRoot()) : 0; }
+
+}
@@ -0,0 +1,11 @@
+// FastLED.cpp - хостовая замена FastLED
+#include "FastLED.h"
+#include "HostHal.h"
+
+CFastLED FastLED;
+
+void CFastLED::show() {
+    // 24 бита по 1.25 мкс на светодиод плюс 50 мкс сброса
+    host::advanceMicros((uint64_t)count * 30 + 50);
+    shows++;
+}
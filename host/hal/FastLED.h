@@ -0,0 +1,41 @@
+// FastLED.h - хостовая замена FastLED: хранит цвет, show() занимает время передачи WS2812B
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include "Arduino.h"
+
+struct CRGB {
+    uint8_t r = 0, g = 0, b = 0;
+    CRGB() = default;
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+};
+
+enum EOrder { RGB = 0012, RBG = 0021, GRB = 0102, GBR = 0120, BRG = 0201, BGR = 0210 };
+
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2812B {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB> class WS2812 {};
+
+class CFastLED {
+public:
+    template<template<uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED& addLeds(CRGB* data, int nLeds) {
+        leds = data;
+        count = nLeds;
+        return *this;
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    void show();
+
+    uint32_t hostShowCount() const { return shows; }
+
+private:
+    CRGB* leds = nullptr;
+    int count = 0;
+    uint8_t brightness = 255;
+    uint32_t shows = 0;
+};
+
+extern CFastLED FastLED;
+
+#endif
@@ -0,0 +1,253 @@
+// FreeRTOS.cpp - хостовая замена FreeRTOS: потоки по очереди на виртуальных часах
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "HostHal.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+    const char* name = "";
+    UBaseType_t priority = 1;
+    uint32_t stackDepth = 8192;
+    BaseType_t coreId = 1;
+    TaskFunction_t fn = nullptr;
+    void* param = nullptr;
+
+    uint32_t notifications = 0;
+    bool blocked = false;
+    bool waitingNotify = false;
+    uint64_t wakeAt = 0;             // мкс виртуального времени, UINT64_MAX - без таймаута
+    uint64_t cpuNanos = 0;           // реальное время, проведенное задачей на "ядре"
+    std::condition_variable cv;
+};
+
+using SteadyClock = std::chrono::steady_clock;
+
+// Объекты живут до конца процесса: потоки задач не завершаются
+static std::mutex& gLock = *new std::mutex;
+static std::vector<HostTask*>& gTasks = *new std::vector<HostTask*>;
+static HostTask* gLoopTask = nullptr;
+static HostTask* gRunning = nullptr;
+static SteadyClock::time_point gSince = SteadyClock::now();
+static size_t gRoundRobin = 0;
+
+static HostTask* loopTaskLocked() {
+    if (!gLoopTask) {
+        gLoopTask = new HostTask;
+        gLoopTask->name = "loopTask";
+        gTasks.push_back(gLoopTask);
+        gRunning = gLoopTask;
+    }
+    return gLoopTask;
+}
+
+static void accountCpuLocked() {
+    SteadyClock::time_point now = SteadyClock::now();
+    if (gRunning) gRunning->cpuNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(now - gSince).count();
+    gSince = now;
+}
+
+static bool readyLocked(HostTask* t) {
+    if (!t->blocked) return true;
+    if (t->waitingNotify && t->notifications) return true;
+    return t->wakeAt <= host::nowMicros();
+}
+
+static HostTask* pickNextLocked() {
+    size_t n = gTasks.size();
+    HostTask* best = nullptr;
+    size_t bestIndex = 0;
+    for (size_t i = 1; i <= n; i++) {
+        size_t index = (gRoundRobin + i) % n;
+        HostTask* t = gTasks[index];
+        if (readyLocked(t) && (!best || t->priority > best->priority)) {
+            best = t;
+            bestIndex = index;
+        }
+    }
+    if (best) {
+        gRoundRobin = bestIndex;
+        return best;
+    }
+
+    // Все спят: переводим часы на ближайшее пробуждение
+    HostTask* earliest = nullptr;
+    for (HostTask* t : gTasks) {
+        if (t->wakeAt != UINT64_MAX && (!earliest || t->wakeAt < earliest->wakeAt)) earliest = t;
+    }
+    if (!earliest) return loopTaskLocked();   // ждать больше нечего - будим loop()
+    uint64_t now = host::nowMicros();
+    if (earliest->wakeAt > now) host::advanceMicros(earliest->wakeAt - now);
+    return earliest;
+}
+
+// Вызывающая задача уже помечена как заблокированная
+static void switchAwayLocked(std::unique_lock<std::mutex>& lk, HostTask* self) {
+    accountCpuLocked();
+    HostTask* next = pickNextLocked();
+    next->blocked = false;
+    next->waitingNotify = false;
+    gRunning = next;
+    if (next != self) {
+        next->cv.notify_one();
+        self->cv.wait(lk, [self] { return gRunning == self; });
+    }
+}
+
+static void blockCurrent(uint64_t wakeAt, bool waitNotify) {
+    std::unique_lock<std::mutex> lk(gLock);
+    HostTask* self = gRunning ? gRunning : loopTaskLocked();
+    self->blocked = true;
+    self->waitingNotify = waitNotify;
+    self->wakeAt = wakeAt;
+    switchAwayLocked(lk, self);
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)host::nowMicros();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t coreId) {
+    std::unique_lock<std::mutex> lk(gLock);
+    loopTaskLocked();
+    HostTask* t = new HostTask;
+    t->name = name;
+    t->fn = fn;
+    t->param = param;
+    t->priority = priority;
+    t->stackDepth = stackDepth;
+    t->coreId = coreId;
+    gTasks.push_back(t);
+    if (created) *created = t;
+
+    // Новая задача готова, но стартует при ближайшей блокировке текущей
+    std::thread([t] {
+        {
+            std::unique_lock<std::mutex> wait(gLock);
+            t->cv.wait(wait, [t] { return gRunning == t; });
+        }
+        t->fn(t->param);
+        vTaskDelete(nullptr);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                       void* param, UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    std::unique_lock<std::mutex> lk(gLock);
+    HostTask* victim = task ? task : gRunning;
+    for (size_t i = 0; i < gTasks.size(); i++) {
+        if (gTasks[i] == victim) {
+            gTasks.erase(gTasks.begin() + i);
+            break;
+        }
+    }
+    if (victim != gRunning) return;
+    // Поток удаленной задачи больше не получает управление
+    accountCpuLocked();
+    HostTask* next = pickNextLocked();
+    next->blocked = false;
+    next->waitingNotify = false;
+    gRunning = next;
+    next->cv.notify_one();
+    victim->cv.wait(lk, [] { return false; });
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    std::unique_lock<std::mutex> lk(gLock);
+    return gRunning ? gRunning : loopTaskLocked();
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(host::nowMicros() / 1000);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    blockCurrent(host::nowMicros() + (uint64_t)ticks * 1000, false);
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return task ? task->stackDepth : 0;
+}
+
+BaseType_t xPortGetCoreID() {
+    std::unique_lock<std::mutex> lk(gLock);
+    HostTask* self = gRunning ? gRunning : loopTaskLocked();
+    return self->coreId == tskNO_AFFINITY ? 0 : self->coreId;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    HostTask* self = xTaskGetCurrentTaskHandle();
+    if (self->notifications == 0 && ticksToWait > 0) {
+        uint64_t wakeAt = ticksToWait == portMAX_DELAY ? UINT64_MAX
+                                                       : host::nowMicros() + (uint64_t)ticksToWait * 1000;
+        blockCurrent(wakeAt, true);
+    }
+    std::unique_lock<std::mutex> lk(gLock);
+    uint32_t count = self->notifications;
+    if (count) self->notifications = clearCountOnExit ? 0 : count - 1;
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    std::unique_lock<std::mutex> lk(gLock);
+    if (task) task->notifications++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+struct HostSemaphore {
+    HostTask* owner = nullptr;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostSemaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    HostTask* self = xTaskGetCurrentTaskHandle();
+    TickType_t waited = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(gLock);
+            if (!semaphore->owner) {
+                semaphore->owner = self;
+                return pdTRUE;
+            }
+        }
+        if (ticksToWait != portMAX_DELAY && waited >= ticksToWait) return pdFALSE;
+        vTaskDelay(1);
+        waited++;
+    }
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    std::unique_lock<std::mutex> lk(gLock);
+    semaphore->owner = nullptr;
+    return pdTRUE;
+}
+
+uint64_t host::taskCpuNanos(TaskHandle_t task) {
+    std::unique_lock<std::mutex> lk(gLock);
+    HostTask* t = task ? task : loopTaskLocked();
+    uint64_t cpu = t->cpuNanos;
+    if (t == gRunning) {
+        cpu += std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - gSince).count();
+    }
+    return cpu;
+}
@@ -0,0 +1,357 @@
+// HostHal.cpp - виртуальные часы, GPIO, куча и Serial для хостовой сборки
+#include "Arduino.h"
+#include "HostHal.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <new>
+
+namespace host {
+
+static Stats gStats;
+static Environment gEnv;
+static uint64_t gMicros = 0;
+static int64_t gHeapBaseline = 0;
+static int64_t gMinFree = -1;
+static bool gSerialEcho = false;
+static bool gTrackAllocs = true;
+
+Stats& stats() { return gStats; }
+Environment& env() { return gEnv; }
+uint64_t nowMicros() { return gMicros; }
+void advanceMicros(uint64_t us) { gMicros += us; }
+void setSerialEcho(bool echo) { gSerialEcho = echo; }
+void setAllocTracking(bool enabled) { gTrackAllocs = enabled; }
+
+void markHeapBaseline() {
+    gHeapBaseline = gStats.liveBytes;
+    gMinFree = -1;
+}
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352d;
+    x ^= x >> 15; x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// Гладкий шум облачности в диапазоне [0..1], меняется за несколько минут
+static float cloudCover(uint64_t us) {
+    const double period = 180.0e6;
+    double t = us / period;
+    uint32_t i = (uint32_t)t;
+    double frac = t - i;
+    float a = (hash32(i ^ gEnv.seed) & 0xFFFF) / 65535.0f;
+    float b = (hash32((i + 1) ^ gEnv.seed) & 0xFFFF) / 65535.0f;
+    double s = frac * frac * (3 - 2 * frac);
+    return (float)(a + (b - a) * s);
+}
+
+// Датчик, отключившийся посреди байта, держит SDA; отпускает ее через
+// несколько тактов SCL, когда его байт закончится
+static const uint8_t STUCK_CLOCKS = 4;
+static bool gSdaStuck = false;
+static uint8_t gStuckClocks = 0;
+
+static bool inOutage() {
+    return gEnv.outageEnd > gEnv.outageStart && gMicros >= gEnv.outageStart * 1e6 && gMicros < gEnv.outageEnd * 1e6;
+}
+
+bool sensorResponds() {
+    if (!inOutage()) return !gSdaStuck;
+    if (gEnv.outageStuck) {
+        gSdaStuck = true;
+        gStuckClocks = 0;
+    }
+    return false;
+}
+
+float ambientLux(uint64_t us, uint8_t zone) {
+    double hour = fmod(gEnv.startHour + us / 3600.0e6, 24.0);
+    float sun = 0.0f;
+    if (hour > 6.0 && hour < 20.0) {
+        sun = gEnv.peakLux * (float)sin(M_PI * (hour - 6.0) / 14.0);
+        sun *= 1.0f - 0.8f * cloudCover(us);
+    }
+    sun *= 1.0f - zone * gEnv.zoneShade;
+    float lamp = digitalRead(gEnv.lampPins[zone % 8]) ? gEnv.lampLux : 0.0f;
+    if (zone == 0) lamp *= pwmLevel(gEnv.dimPin);
+    return sun + lamp + 2.0f;
+}
+
+}
+
+using host::gStats;
+
+// === Учет аллокаций ===
+namespace {
+struct alignas(16) AllocHeader { size_t size; bool counted; };
+}
+
+static void* countedAlloc(size_t size) {
+    void* raw = std::malloc(sizeof(AllocHeader) + size);
+    if (!raw) throw std::bad_alloc();
+    AllocHeader* header = static_cast<AllocHeader*>(raw);
+    header->size = size;
+    header->counted = host::gTrackAllocs;
+    if (!header->counted) return header + 1;
+    gStats.allocCount++;
+    gStats.allocBytes += size;
+    gStats.liveBytes += size;
+    if (gStats.liveBytes > gStats.peakLiveBytes) gStats.peakLiveBytes = gStats.liveBytes;
+    int64_t freeNow = (int64_t)ESP.getFreeHeap();
+    if (host::gMinFree < 0 || freeNow < host::gMinFree) host::gMinFree = freeNow;
+    return header + 1;
+}
+
+static void countedFree(void* ptr) {
+    if (!ptr) return;
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    if (header->counted) gStats.liveBytes -= header->size;
+    std::free(header);
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+
+// === Время ===
+unsigned long millis() { return (unsigned long)(host::gMicros / 1000); }
+unsigned long micros() { return (unsigned long)host::gMicros; }
+void delay(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+void delayMicroseconds(uint32_t us) { host::gMicros += us; }
+void yield() {}
+
+// SNTP-заглушка: отвечает, только если бенчмарк задал sntpTime (--sntp)
+static bool sntpConfigured = false;
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server1,
+                const char* server2, const char* server3) {
+    (void)gmtOffset_sec; (void)daylightOffset_sec; (void)server1; (void)server2; (void)server3;
+    sntpConfigured = true;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    (void)ms;
+    if (!sntpConfigured || !host::gEnv.sntpTime) return false;
+    time_t t = host::gEnv.sntpTime + (time_t)(host::gMicros / 1000000);
+    gmtime_r(&t, info);
+    return true;
+}
+
+// === GPIO ===
+static uint8_t pinState[64];
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    // Фронт SCL, пока датчик держит SDA: он досылает свой байт
+    if (pin == host::gEnv.sclPin && val && !pinState[pin] && host::gSdaStuck && !host::inOutage() &&
+        ++host::gStuckClocks >= host::STUCK_CLOCKS) {
+        host::gSdaStuck = false;
+    }
+    if (pin < sizeof(pinState)) pinState[pin] = val ? HIGH : LOW;
+    gStats.pinWrites++;
+}
+
+int digitalRead(uint8_t pin) {
+    // SDA с подтяжкой: низкий уровень, только пока ее держит датчик
+    if (pin == host::gEnv.sdaPin) {
+        host::sensorResponds();
+        return host::gSdaStuck ? LOW : HIGH;
+    }
+    return pin < sizeof(pinState) ? pinState[pin] : LOW;
+}
+
+// === LEDC ===
+static const uint8_t LEDC_CHANNELS = 16;
+static uint8_t ledcBits[LEDC_CHANNELS];
+static uint32_t ledcDuty[LEDC_CHANNELS];
+static int8_t pinChannel[64];      // канал LEDC + 1, 0 - пин не подключен
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution_bits) {
+    if (channel >= LEDC_CHANNELS || resolution_bits == 0 || resolution_bits > 20) return 0;
+    ledcBits[channel] = resolution_bits;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (pin < sizeof(pinChannel) && channel < LEDC_CHANNELS) pinChannel[pin] = channel + 1;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNELS) return;
+    ledcDuty[channel] = duty;
+    gStats.pwmWrites++;
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? ledcDuty[channel] : 0;
+}
+
+float host::pwmLevel(uint8_t pin) {
+    if (pin >= sizeof(pinChannel) || !pinChannel[pin]) return 1.0f;
+    uint8_t channel = pinChannel[pin] - 1;
+    uint32_t max = (1UL << ledcBits[channel]) - 1;
+    return max ? std::min(1.0f, (float)ledcDuty[channel] / max) : 0.0f;
+}
+
+// === Случайные числа ===
+static uint32_t rngState = 0x12345678;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed) rngState = (uint32_t)seed;
+}
+
+// === Куча ESP32 (модель: 300 КБ, из них занято столько, сколько живых аллокаций) ===
+static const int64_t HOST_HEAP_SIZE = 300 * 1024;
+static const int64_t HOST_LARGEST_REGION = 110 * 1024;
+
+EspClass ESP;
+
+uint32_t EspClass::getHeapSize() { return (uint32_t)HOST_HEAP_SIZE; }
+
+uint32_t EspClass::getFreeHeap() {
+    int64_t used = gStats.liveBytes - host::gHeapBaseline;
+    int64_t freeBytes = HOST_HEAP_SIZE - (used > 0 ? used : 0);
+    return (uint32_t)(freeBytes > 0 ? freeBytes : 0);
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return host::gMinFree < 0 ? getFreeHeap() : (uint32_t)host::gMinFree;
+}
+
+uint32_t EspClass::getCycleCount() {
+    static const auto origin = std::chrono::steady_clock::now();
+    uint64_t realNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    return (uint32_t)(host::gMicros * 240 + realNanos * 240 / 1000);
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    uint32_t freeBytes = getFreeHeap();
+    return freeBytes < HOST_LARGEST_REGION ? freeBytes : (uint32_t)HOST_LARGEST_REGION;
+}
+
+static shutdown_handler_t gShutdownHandlers[5];
+
+void EspClass::restart() {
+    for (shutdown_handler_t handler : gShutdownHandlers) {
+        if (handler) handler();
+    }
+    fflush(stdout);
+    std::exit(0);
+}
+
+esp_reset_reason_t esp_reset_reason(void) {
+    return (esp_reset_reason_t)host::env().resetReason;
+}
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) {
+    for (shutdown_handler_t& slot : gShutdownHandlers) {
+        if (slot == handler) return ESP_ERR_INVALID_STATE;
+        if (!slot) {
+            slot = handler;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handler) {
+    for (shutdown_handler_t& slot : gShutdownHandlers) {
+        if (slot == handler) {
+            slot = nullptr;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+uint32_t esp_get_free_heap_size() { return ESP.getFreeHeap(); }
+uint32_t esp_get_minimum_free_heap_size() { return ESP.getMinFreeHeap(); }
+
+// === Serial ===
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    gStats.serialBytes += size;
+    if (host::gSerialEcho) fwrite(buffer, 1, size, stdout);
+    return size;
+}
+
+// === Print / Stream ===
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (!write(*buffer++)) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(buf)) return write((const uint8_t*)buf, len);
+
+    char* big = new char[len + 1];
+    va_start(args, format);
+    vsnprintf(big, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)big, len);
+    delete[] big;
+    return n;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String ret;
+    int c;
+    while ((c = read()) >= 0) ret += (char)c;
+    return ret;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String ret;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) ret += (char)c;
+    return ret;
+}
@@ -0,0 +1,95 @@
+// HostHal.h - управление хостовой прослойкой (только для хостовой сборки и бенчмарков)
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <cstdint>
+#include <string>
+
+struct HostTask;
+
+namespace host {
+
+// Счетчики, которые собирает прослойка
+struct Stats {
+    uint64_t allocCount = 0;      // вызовы operator new
+    uint64_t allocBytes = 0;      // суммарно запрошено байт
+    int64_t liveBytes = 0;        // занято сейчас
+    int64_t peakLiveBytes = 0;    // пик занятой кучи
+    uint64_t fsBytesWritten = 0;  // байт записано в LittleFS
+    uint64_t fsBytesRead = 0;     // байт прочитано из LittleFS
+    uint64_t fsOpens = 0;         // открытий файлов
+    uint64_t serialBytes = 0;     // байт выведено в Serial
+    uint64_t i2cTransactions = 0; // транзакций на шине I2C
+    uint64_t pinWrites = 0;       // вызовов digitalWrite
+    uint64_t pwmWrites = 0;       // вызовов ledcWrite
+    uint64_t httpRequests = 0;    // обработанных HTTP-запросов
+    uint64_t lastHttpMicros = 0;  // виртуальное время разбора последнего запроса
+};
+
+enum SensorModel : uint8_t {
+    SENSOR_BH1750,                // модель в BH1750.cpp, за API библиотеки
+    SENSOR_VEML7700               // модель регистров в Wire.cpp
+};
+
+// Модель окружения: солнце, облака и вклад фитолампы в показания датчика
+struct Environment {
+    bool sensorPresent = true;    // отвечает ли датчик на шине
+    SensorModel sensorModel = SENSOR_BH1750;
+    uint8_t sensorAddress = 0x23; // VEML7700 - 0x10
+    uint8_t lampPins[8] = {4, 16, 17, 18, 19, 21, 22, 23};   // лампы зон (ZONE_RELAY_PINS)
+    uint8_t muxZones = 0;         // >0: TCA9548A на muxAddress и BH1750 на каналах 0..muxZones-1
+    uint8_t muxAddress = 0x70;
+    uint8_t dimPin = 25;          // ШИМ-вход драйвера лампы зоны 0 (DIM_PIN)
+    float zoneShade = 0.08f;      // зона z получает солнца в (1 - z * zoneShade) раз меньше
+    float lampLux = 5400.0f;      // прибавка лампы к освещенности; в прошивке lampPpfd / luxToPpfd по умолчанию
+    float peakLux = 20000.0f;     // солнечный максимум в полдень
+    double startHour = 6.0;       // время суток, соответствующее millis() == 0
+    uint32_t sntpTime = 0;        // UTC, которое SNTP отдаст при millis() == 0; 0 - SNTP недоступен
+    uint32_t seed = 1;
+    int resetReason = 1;          // esp_reset_reason(), ESP_RST_POWERON
+    // Отказ датчика: с outageStart по outageEnd секунд от старта он не отвечает (обрыв,
+    // просадка питания). outageStuck - после отказа датчик держит SDA, пока мастер
+    // не прощелкает SCL; до этого не отвечает и после конца отказа
+    double outageStart = 0;
+    double outageEnd = 0;
+    bool outageStuck = false;
+    uint8_t sdaPin = 13;          // I2C_SDA
+    uint8_t sclPin = 14;          // I2C_SCL
+};
+
+Stats& stats();
+Environment& env();
+
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+
+// Свободная куча считается от уровня, зафиксированного этим вызовом
+void markHeapBaseline();
+
+void setSerialEcho(bool echo);
+
+// Аллокации самого бенчмарка не должны попадать в статистику прошивки
+void setAllocTracking(bool enabled);
+
+// Яркость по ШИМ на пине, 0..1; пин без LEDC - 1 (драйвер без диммирования)
+float pwmLevel(uint8_t pin);
+
+// Отвечает ли датчик сейчас: отказ из env() и зависшая SDA
+bool sensorResponds();
+
+// Освещенность на датчике зоны в момент времени us
+float ambientLux(uint64_t us, uint8_t zone = 0);
+
+// Каталог, в котором лежит LittleFS
+const std::string& fsRoot();
+void setFsRoot(const std::string& dir);
+
+// Реальное время, которое задача провела на "ядре" (nullptr - loopTask)
+uint64_t taskCpuNanos(HostTask* task = nullptr);
+
+// Порт, на котором слушает WebServer (после begin())
+int httpPort();
+
+}
+
+#endif
@@ -0,0 +1,23 @@
+// LittleFS.h - хостовая LittleFS: каталог host::fsRoot() (временный по умолчанию)
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end();
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+}
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
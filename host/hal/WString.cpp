@@ -0,0 +1,136 @@
+// WString.cpp - хостовая реализация Arduino String
+#include "WString.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+static std::string formatUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char tmp[72];
+    int pos = sizeof(tmp) - 1;
+    tmp[pos] = '\0';
+    do {
+        unsigned digit = value % base;
+        tmp[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value && pos > 0);
+    return std::string(tmp + pos);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    if (base == 10 && value < 0) {
+        return "-" + formatUnsigned(0ULL - (unsigned long long)value, base);
+    }
+    return formatUnsigned((unsigned long long)value, base);
+}
+
+static std::string formatFloat(double value, unsigned int decimalPlaces) {
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%.*f", (int)decimalPlaces, value);
+    return std::string(tmp);
+}
+
+String::String(unsigned char value, unsigned char base) : buf(formatUnsigned(value, base)) {}
+String::String(int value, unsigned char base) : buf(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buf(formatUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : buf(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buf(formatUnsigned(value, base)) {}
+String::String(long long value, unsigned char base) : buf(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : buf(formatUnsigned(value, base)) {}
+String::String(float value, unsigned int decimalPlaces) : buf(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : buf(formatFloat(value, decimalPlaces)) {}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    if (buf.size() != s.buf.size()) return false;
+    for (size_t i = 0; i < buf.size(); i++) {
+        if (tolower((unsigned char)buf[i]) != tolower((unsigned char)s.buf[i])) return false;
+    }
+    return true;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.buf.size() > buf.size()) return false;
+    return buf.compare(buf.size() - suffix.buf.size(), suffix.buf.size(), suffix.buf) == 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    size_t pos = buf.find(ch, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = buf.find(str.buf, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char ch) const {
+    size_t pos = buf.rfind(ch);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = buf.rfind(str.buf);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, buf.size());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if (beginIndex >= buf.size()) return String();
+    if (endIndex > buf.size()) endIndex = buf.size();
+    String out;
+    out.buf = buf.substr(beginIndex, endIndex - beginIndex);
+    return out;
+}
+
+void String::replace(char find, char replacement) {
+    std::replace(buf.begin(), buf.end(), find, replacement);
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.buf.empty()) return;
+    size_t pos = 0;
+    while ((pos = buf.find(find.buf, pos)) != std::string::npos) {
+        buf.replace(pos, find.buf.size(), replacement.buf);
+        pos += replacement.buf.size();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= buf.size()) return;
+    buf.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (auto& c : buf) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (auto& c : buf) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+    size_t begin = buf.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) { buf.clear(); return; }
+    size_t end = buf.find_last_not_of(" \t\r\n");
+    buf = buf.substr(begin, end - begin + 1);
+}
+
+long String::toInt() const { return strtol(buf.c_str(), nullptr, 10); }
+float String::toFloat() const { return strtof(buf.c_str(), nullptr); }
+double String::toDouble() const { return strtod(buf.c_str(), nullptr); }
+
+String operator+(const String& lhs, const String& rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String& lhs, const char* rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const char* lhs, const String& rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String& lhs, char rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String& lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, float rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, double rhs) { return lhs + String(rhs); }
@@ -0,0 +1,93 @@
+// WString.h - хостовая реализация Arduino String поверх std::string
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+class String {
+public:
+    String(const char* cstr = "") : buf(cstr ? cstr : "") {}
+    String(const char* cstr, unsigned int length) : buf(cstr, length) {}
+    String(const String& other) = default;
+    String(String&& other) noexcept = default;
+    explicit String(char c) : buf(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String& operator=(const String& rhs) = default;
+    String& operator=(String&& rhs) noexcept = default;
+    String& operator=(const char* cstr) { buf = cstr ? cstr : ""; return *this; }
+
+    bool reserve(unsigned int size) { buf.reserve(size); return true; }
+    unsigned int length() const { return buf.length(); }
+    const char* c_str() const { return buf.c_str(); }
+    bool isEmpty() const { return buf.empty(); }
+
+    bool concat(const String& s) { buf += s.buf; return true; }
+    bool concat(const char* cstr) { if (cstr) buf += cstr; return true; }
+    bool concat(const char* cstr, unsigned int length) { buf.append(cstr, length); return true; }
+    bool concat(char c) { buf += c; return true; }
+    template<typename T> bool concat(T value) { return concat(String(value)); }
+
+    template<typename T> String& operator+=(const T& rhs) { concat(rhs); return *this; }
+    String& operator+=(const char* rhs) { concat(rhs); return *this; }
+
+    bool equals(const String& s) const { return buf == s.buf; }
+    bool equals(const char* cstr) const { return buf == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& s) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* rhs) const { return equals(rhs); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* rhs) const { return !equals(rhs); }
+    bool operator<(const String& rhs) const { return buf < rhs.buf; }
+    bool startsWith(const String& prefix) const { return buf.compare(0, prefix.buf.size(), prefix.buf) == 0; }
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const { return index < buf.size() ? buf[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < buf.size()) buf[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return buf[index]; }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(char find, char replacement);
+    void replace(const String& find, const String& replacement);
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+private:
+    std::string buf;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+
+#endif
@@ -0,0 +1,300 @@
+// WebServer.cpp - хостовая замена ESP32 WebServer
+#include "WebServer.h"
+#include "HostHal.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int gHttpPort = 0;
+
+int host::httpPort() { return gHttpPort; }
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static String urlDecode(const String& text) {
+    String out;
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == '+') {
+            out += ' ';
+        } else if (c == '%' && i + 2 < text.length()) {
+            char hex[3] = {text[i + 1], text[i + 2], 0};
+            out += (char)strtol(hex, nullptr, 16);
+            i += 2;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+WebServer::~WebServer() {
+    close();
+}
+
+void WebServer::begin() {
+    int hostPort = port;
+    if (port == 80) {
+        const char* envPort = getenv("PHYTO_HTTP_PORT");
+        hostPort = envPort ? atoi(envPort) : 8080;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) return;
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(hostPort);
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        // Порт занят - берем любой свободный
+        addr.sin_port = 0;
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return;
+        }
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, (sockaddr*)&addr, &len);
+    gHttpPort = ntohs(addr.sin_port);
+
+    listen(listenFd, 16);
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+}
+
+void WebServer::close() {
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+    }
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    routes.push_back(Route{uri, method, fn});
+}
+
+bool WebServer::readRequest(WiFiClient& c) {
+    String head;
+    String body;
+    int contentLength = 0;
+    bool headDone = false;
+    char buf[512];
+
+    while (true) {
+        struct pollfd p = {c.fd(), POLLIN, 0};
+        if (poll(&p, 1, 1000) <= 0) return false;
+        ssize_t n = ::recv(c.fd(), buf, sizeof(buf), 0);
+        if (n <= 0) return false;
+        if (!headDone) {
+            head.concat(buf, (unsigned int)n);
+            int end = head.indexOf("\r\n\r\n");
+            if (end < 0) continue;
+            body = head.substring(end + 4);
+            head = head.substring(0, end);
+            headDone = true;
+            int cl = head.indexOf("Content-Length:");
+            if (cl < 0) cl = head.indexOf("content-length:");
+            if (cl >= 0) contentLength = head.substring(cl + 15, head.indexOf('\r', cl)).toInt();
+        } else {
+            body.concat(buf, (unsigned int)n);
+        }
+        if (headDone && (int)body.length() >= contentLength) break;
+    }
+
+    int lineEnd = head.indexOf("\r\n");
+    String requestLine = lineEnd < 0 ? head : head.substring(0, lineEnd);
+    int sp1 = requestLine.indexOf(' ');
+    int sp2 = requestLine.indexOf(' ', sp1 + 1);
+    if (sp1 < 0 || sp2 < 0) return false;
+    String methodStr = requestLine.substring(0, sp1);
+    String url = requestLine.substring(sp1 + 1, sp2);
+
+    currentMethod = HTTP_ANY;
+    if (methodStr == "GET") currentMethod = HTTP_GET;
+    else if (methodStr == "HEAD") currentMethod = HTTP_HEAD;
+    else if (methodStr == "POST") currentMethod = HTTP_POST;
+    else if (methodStr == "PUT") currentMethod = HTTP_PUT;
+    else if (methodStr == "PATCH") currentMethod = HTTP_PATCH;
+    else if (methodStr == "DELETE") currentMethod = HTTP_DELETE;
+    else if (methodStr == "OPTIONS") currentMethod = HTTP_OPTIONS;
+
+    argList.clear();
+    headerList.clear();
+    int q = url.indexOf('?');
+    currentUri = q < 0 ? url : url.substring(0, q);
+    if (q >= 0) {
+        String query = url.substring(q + 1);
+        unsigned int pos = 0;
+        while (pos <= query.length()) {
+            int amp = query.indexOf('&', pos);
+            String pair = query.substring(pos, amp < 0 ? query.length() : amp);
+            if (pair.length()) {
+                int eq = pair.indexOf('=');
+                argList.push_back(KV{urlDecode(eq < 0 ? pair : pair.substring(0, eq)),
+                                     urlDecode(eq < 0 ? String() : pair.substring(eq + 1))});
+            }
+            if (amp < 0) break;
+            pos = amp + 1;
+        }
+    }
+
+    int pos = lineEnd < 0 ? head.length() : lineEnd + 2;
+    while (pos < (int)head.length()) {
+        int next = head.indexOf("\r\n", pos);
+        String line = head.substring(pos, next < 0 ? head.length() : next);
+        int colon = line.indexOf(':');
+        if (colon > 0) {
+            String value = line.substring(colon + 1);
+            value.trim();
+            headerList.push_back(KV{line.substring(0, colon), value});
+        }
+        if (next < 0) break;
+        pos = next + 2;
+    }
+
+    if (body.length()) argList.push_back(KV{"plain", body});
+    return true;
+}
+
+void WebServer::handleClient() {
+    if (listenFd < 0) return;
+    if (waitingClose) {
+        if (currentClient.connected() && millis() - closeWaitStart <= HTTP_MAX_CLOSE_WAIT) return;
+        waitingClose = false;
+        currentClient = WiFiClient();
+    }
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+
+    currentClient = WiFiClient(fd);
+    extraHeaders = "";
+    contentLengthOverride = CONTENT_LENGTH_NOT_SET;
+    chunked = false;
+
+    if (readRequest(currentClient)) {
+        host::stats().httpRequests++;
+        host::stats().lastHttpMicros = host::nowMicros();
+        bool handled = false;
+        for (auto& route : routes) {
+            if (route.uri == currentUri && (route.method == HTTP_ANY || route.method == currentMethod)) {
+                route.fn();
+                handled = true;
+                break;
+            }
+        }
+        if (!handled) {
+            if (notFoundHandler) notFoundHandler();
+            else send(404, "text/plain", "Not found");
+        }
+        finalizeResponse();
+    }
+
+    // Как HC_WAIT_CLOSE в ESP32 WebServer: соединение, которое осталось открытым
+    // у обработчика (копия WiFiClient для SSE), сервер ждет до HTTP_MAX_CLOSE_WAIT
+    // и других клиентов в это время не принимает. Обычный ответ закрывается здесь же
+    if (currentClient.isShared() && currentClient.connected()) {
+        waitingClose = true;
+        closeWaitStart = millis();
+        return;
+    }
+    currentClient = WiFiClient();
+}
+
+String WebServer::arg(const String& name) {
+    for (auto& kv : argList) if (kv.name == name) return kv.value;
+    return String();
+}
+
+String WebServer::arg(int i) { return i >= 0 && i < (int)argList.size() ? argList[i].value : String(); }
+String WebServer::argName(int i) { return i >= 0 && i < (int)argList.size() ? argList[i].name : String(); }
+
+bool WebServer::hasArg(const String& name) {
+    for (auto& kv : argList) if (kv.name == name) return true;
+    return false;
+}
+
+void WebServer::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+    (void)headerKeys; (void)headerKeysCount; // на хосте собираются все заголовки
+}
+
+String WebServer::header(const String& name) {
+    for (auto& kv : headerList) if (kv.name.equalsIgnoreCase(name)) return kv.value;
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) {
+    for (auto& kv : headerList) if (kv.name.equalsIgnoreCase(name)) return true;
+    return false;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line = name + ": " + value + "\r\n";
+    if (first) extraHeaders = line + extraHeaders;
+    else extraHeaders += line;
+}
+
+void WebServer::sendResponseHeaders(int code, const char* contentType, size_t contentLength) {
+    String head = "HTTP/1.1 " + String(code) + " " + statusText(code) + "\r\n";
+    if (contentType && *contentType) head += "Content-Type: " + String(contentType) + "\r\n";
+    if (contentLengthOverride == CONTENT_LENGTH_UNKNOWN) {
+        chunked = true;
+        head += "Transfer-Encoding: chunked\r\n";
+    } else {
+        size_t len = contentLengthOverride != CONTENT_LENGTH_NOT_SET ? contentLengthOverride : contentLength;
+        head += "Content-Length: " + String((unsigned long)len) + "\r\n";
+    }
+    head += extraHeaders;
+    head += "Connection: close\r\n\r\n";
+    currentClient.write((const uint8_t*)head.c_str(), head.length());
+    extraHeaders = "";
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    send(code, contentType, content.c_str(), content.length());
+}
+
+void WebServer::send(int code, const char* contentType, const char* content, size_t contentLength) {
+    sendResponseHeaders(code, contentType, contentLength);
+    if (contentLength && currentMethod != HTTP_HEAD) sendContent(content, contentLength);
+}
+
+void WebServer::sendContent(const char* content, size_t contentLength) {
+    if (chunked) {
+        if (contentLength == 0) return;
+        char sizeLine[16];
+        int n = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", contentLength);
+        currentClient.write((const uint8_t*)sizeLine, n);
+        currentClient.write((const uint8_t*)content, contentLength);
+        currentClient.write((const uint8_t*)"\r\n", 2);
+    } else {
+        currentClient.write((const uint8_t*)content, contentLength);
+    }
+}
+
+void WebServer::finalizeResponse() {
+    if (chunked) {
+        currentClient.write((const uint8_t*)"0\r\n\r\n", 5);
+        chunked = false;
+    }
+}
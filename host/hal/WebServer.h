@@ -0,0 +1,93 @@
+// WebServer.h - хостовая замена ESP32 WebServer на неблокирующем сокете 127.0.0.1
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include "Arduino.h"
+#include "WiFi.h"
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+#define HTTP_MAX_CLOSE_WAIT 2000   // мс
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    // Порт 80 на хосте заменяется на PHYTO_HTTP_PORT (по умолчанию 8080)
+    WebServer(int port = 80) : port(port) {}
+    ~WebServer();
+
+    void begin();
+    void close();
+    void handleClient();
+
+    void on(const String& uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void onNotFound(THandlerFunction fn) { notFoundHandler = fn; }
+
+    String uri() { return currentUri; }
+    HTTPMethod method() { return currentMethod; }
+    WiFiClient& client() { return currentClient; }
+
+    String arg(const String& name);
+    String arg(int i);
+    String argName(int i);
+    int args() { return (int)argList.size(); }
+    bool hasArg(const String& name);
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+    String header(const String& name);
+    bool hasHeader(const String& name);
+
+    void send(int code, const char* contentType = nullptr, const String& content = String(""));
+    void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+    void send(int code, const char* contentType, const char* content, size_t contentLength);
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength) { send(code, contentType, content, contentLength); }
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(const size_t contentLength) { contentLengthOverride = contentLength; }
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char* content, size_t contentLength);
+    void sendContent_P(PGM_P content, size_t size) { sendContent(content, size); }
+
+    template<typename T>
+    size_t streamFile(T& file, const String& contentType, const int code = 200) {
+        setContentLength(file.size());
+        send(code, contentType, String(""));
+        char buf[512];
+        size_t total = 0;
+        size_t n;
+        while ((n = file.read((uint8_t*)buf, sizeof(buf))) > 0) {
+            sendContent(buf, n);
+            total += n;
+        }
+        return total;
+    }
+
+private:
+    struct Route { String uri; HTTPMethod method; THandlerFunction fn; };
+    struct KV { String name; String value; };
+
+    bool readRequest(WiFiClient& c);
+    void sendResponseHeaders(int code, const char* contentType, size_t contentLength);
+    void finalizeResponse();
+
+    int port;
+    int listenFd = -1;
+    std::vector<Route> routes;
+    THandlerFunction notFoundHandler;
+
+    WiFiClient currentClient;
+    String currentUri;
+    HTTPMethod currentMethod = HTTP_ANY;
+    std::vector<KV> argList;
+    std::vector<KV> headerList;
+    String extraHeaders;
+    size_t contentLengthOverride = CONTENT_LENGTH_NOT_SET;
+    bool chunked = false;
+    bool waitingClose = false;
+    unsigned long closeWaitStart = 0;
+};
+
+#endif
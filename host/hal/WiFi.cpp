@@ -0,0 +1,90 @@
+// WiFi.cpp - хостовая замена WiFi
+#include "WiFi.h"
+#include "esp_system.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+static void stopDriver() {}
+
+void WiFiClass::startDriver() {
+    esp_register_shutdown_handler(stopDriver);
+}
+
+String IPAddress::toString() const {
+    return String(octets[0]) + "." + String(octets[1]) + "." + String(octets[2]) + "." + String(octets[3]);
+}
+
+struct ClientSocket {
+    int fd = -1;
+    explicit ClientSocket(int f) : fd(f) {}
+    ~ClientSocket() { if (fd >= 0) ::close(fd); }
+};
+
+WiFiClient::WiFiClient(int fd) : sock(std::make_shared<ClientSocket>(fd)) {}
+
+int WiFiClient::fd() const { return sock ? sock->fd : -1; }
+
+bool WiFiClient::isShared() const { return sock && sock.use_count() > 1; }
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    if (!sock || sock->fd < 0) return 0;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = ::send(sock->fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Как в ESP32: ждать места в буфере отправки не дольше setTimeout()
+            struct pollfd p = {sock->fd, POLLOUT, 0};
+            if (poll(&p, 1, (int)_timeout) <= 0) break;
+            continue;
+        }
+        if (n <= 0) { stop(); break; }
+        sent += n;
+    }
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (!sock || sock->fd < 0) return 0;
+    uint8_t tmp[512];
+    ssize_t n = ::recv(sock->fd, tmp, sizeof(tmp), MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 ? (int)n : 0;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (!sock || sock->fd < 0) return -1;
+    ssize_t n = ::recv(sock->fd, buf, size, MSG_DONTWAIT);
+    return n > 0 ? (int)n : -1;
+}
+
+int WiFiClient::peek() {
+    if (!sock || sock->fd < 0) return -1;
+    uint8_t c;
+    return ::recv(sock->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1 ? c : -1;
+}
+
+void WiFiClient::stop() {
+    if (sock && sock->fd >= 0) {
+        ::close(sock->fd);
+        sock->fd = -1;
+    }
+}
+
+uint8_t WiFiClient::connected() {
+    if (!sock || sock->fd < 0) return 0;
+    uint8_t c;
+    ssize_t n = ::recv(sock->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return 0;
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return 0;
+    return 1;
+}
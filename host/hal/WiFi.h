@@ -0,0 +1,73 @@
+// WiFi.h - хостовая замена WiFi: точка доступа всегда "поднята", клиенты - сокеты loopback
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+#include <memory>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    String toString() const;
+    uint8_t operator[](int index) const { return octets[index & 3]; }
+
+private:
+    uint8_t octets[4];
+};
+
+class WiFiClass {
+public:
+    bool softAP(const char* ssid, const char* passphrase = nullptr) { (void)ssid; (void)passphrase; startDriver(); return true; }
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr) { (void)ssid; (void)passphrase; startDriver(); return WL_DISCONNECTED; }
+    wl_status_t status() { return hostStatus; }
+    bool isConnected() { return hostStatus == WL_CONNECTED; }
+    IPAddress localIP() { return hostStatus == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress(); }
+
+    wl_status_t hostStatus = WL_DISCONNECTED;
+
+private:
+    // Драйвер WiFi в ESP-IDF занимает один из пяти слотов esp_register_shutdown_handler
+    void startDriver();
+};
+
+extern WiFiClass WiFi;
+
+struct ClientSocket;
+
+// Копии WiFiClient разделяют сокет; он закрывается с последней копией или по stop()
+class WiFiClient : public Stream {
+public:
+    WiFiClient() = default;
+    explicit WiFiClient(int fd);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    int read(uint8_t* buf, size_t size);
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected(); }
+    bool operator==(const WiFiClient& rhs) const { return sock == rhs.sock; }
+    bool operator!=(const WiFiClient& rhs) const { return sock != rhs.sock; }
+    int fd() const;
+    bool isShared() const;   // только хост: у сокета есть другие копии WiFiClient
+
+private:
+    std::shared_ptr<ClientSocket> sock;
+};
+
+#endif
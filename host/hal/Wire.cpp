@@ -0,0 +1,166 @@
+// Wire.cpp - хостовая шина I2C
+#include "Wire.h"
+#include "HostHal.h"
+
+TwoWire Wire;
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda; (void)scl;
+    if (frequency) clock = frequency;
+    started = true;
+    return true;
+}
+
+bool TwoWire::end() {
+    started = false;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    clock = frequency;
+    return true;
+}
+
+// С мультиплексором BH1750 отвечает, только если выбран ровно один канал с датчиком
+bool TwoWire::devicePresent(uint8_t address) const {
+    const host::Environment& e = host::env();
+    if (!started) return false;
+    if (e.muxZones && address == e.muxAddress) return true;
+    if (!e.sensorPresent || address != e.sensorAddress || !host::sensorResponds()) return false;
+    if (!e.muxZones) return true;
+    return muxMask && !(muxMask & (muxMask - 1)) && hostMuxChannel() < e.muxZones;
+}
+
+uint8_t TwoWire::hostMuxChannel() const {
+    return muxMask ? __builtin_ctz(muxMask) : 0;
+}
+
+// Один байт на шине - 9 тактов SCL, плюс старт/стоп и адрес
+void TwoWire::chargeBusTime(size_t bytes) {
+    uint32_t hz = clock ? clock : 100000;
+    host::advanceMicros((uint64_t)(bytes + 2) * 9 * 1000000 / hz);
+    host::stats().i2cTransactions++;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    txLast = data;
+    if (txLength < sizeof(txBuffer)) txBuffer[txLength] = data;
+    txLength++;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    for (size_t i = 0; i < quantity; i++) write(data[i]);
+    return quantity;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    chargeBusTime(txLength);
+    if (!started) return 4;
+    if (!devicePresent(txAddress)) return 2;
+    // TCA9548A: единственный байт - маска каналов
+    if (host::env().muxZones && txAddress == host::env().muxAddress) {
+        if (txLength > 0) muxMask = txLast;
+        return 0;
+    }
+    if (txLength > 0) {
+        lastCmdAddress = txAddress;
+        lastCmd = txLast;
+    }
+    if (host::env().sensorModel == host::SENSOR_VEML7700 && txAddress == host::env().sensorAddress) vemlWrite();
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    chargeBusTime(quantity);
+    rxIndex = rxLength = 0;
+    if (!devicePresent(address)) return 0;
+    if (host::env().sensorModel == host::SENSOR_VEML7700 && address == host::env().sensorAddress) {
+        rxLength = vemlRead(quantity);
+        return (uint8_t)rxLength;
+    }
+    if (address == respAddress) {
+        uint8_t n = quantity < respLength ? quantity : respLength;
+        memcpy(rxBuffer, respData, n);
+        rxLength = n;
+    }
+    return (uint8_t)rxLength;
+}
+
+void TwoWire::hostSetResponse(uint8_t address, const uint8_t* data, uint8_t length) {
+    respAddress = address;
+    respLength = length < sizeof(respData) ? length : sizeof(respData);
+    memcpy(respData, data, respLength);
+}
+
+int TwoWire::hostLastCommand(uint8_t address) const {
+    return address == lastCmdAddress ? lastCmd : -1;
+}
+
+// === VEML7700 ===
+// Регистры 16-битные, младший байт первым. Датчик интегрирует непрерывно: ALS
+// отдает освещенность на конец последнего полного периода IT. Нелинейность при
+// малом усилении моделируется обратной к поправке Vishay, которую применяет драйвер
+
+static uint32_t vemlIntegrationMicros(uint16_t conf) {
+    switch ((conf >> 6) & 0x0F) {
+        case 0x0C: return 25000;
+        case 0x08: return 50000;
+        case 0x01: return 200000;
+        case 0x02: return 400000;
+        case 0x03: return 800000;
+        default: return 100000;
+    }
+}
+
+// lux на отсчет: 0.0042 при x2 и 800 мс
+static double vemlResolution(uint16_t conf) {
+    static const double gainFactor[4] = {2.0, 1.0, 16.0, 8.0};   // x1, x2, x1/8, x1/4 относительно x2
+    return 0.0042 * gainFactor[(conf >> 11) & 0x03] * 800000.0 / vemlIntegrationMicros(conf);
+}
+
+static double vemlCorrection(double x) {
+    return (((6.0135e-13 * x - 9.3924e-9) * x + 8.1488e-5) * x + 1.0023) * x;
+}
+
+void TwoWire::vemlWrite() {
+    if (txLength == 0) return;
+    vemlPointer = txBuffer[0];
+    if (txLength >= 3 && vemlPointer == 0x00) vemlConf = txBuffer[1] | txBuffer[2] << 8;
+}
+
+uint8_t TwoWire::vemlRead(uint8_t quantity) {
+    uint16_t value = 0;
+    if (vemlPointer == 0x00) {
+        value = vemlConf;
+    } else if (vemlPointer == 0x07) {
+        value = 0xC481;
+    } else if (vemlPointer == 0x04 && !(vemlConf & 0x01)) {
+        uint32_t it = vemlIntegrationMicros(vemlConf);
+        uint64_t now = host::nowMicros();
+        double lux = host::ambientLux(now - now % it, hostMuxChannel());
+        // Отклик при x1/8 и x1/4 нелинеен: ищем сырое значение, которое драйвер поправит в lux
+        if ((vemlConf >> 11) & 0x02) {
+            double lo = 0, hi = lux;
+            for (int i = 0; i < 40; i++) {
+                double mid = (lo + hi) / 2;
+                if (vemlCorrection(mid) < lux) lo = mid;
+                else hi = mid;
+            }
+            lux = lo;
+        }
+        double counts = lux / vemlResolution(vemlConf);
+        value = counts > 65535 ? 65535 : (uint16_t)counts;
+    }
+    uint8_t n = quantity < 2 ? quantity : 2;
+    rxBuffer[0] = value & 0xFF;
+    rxBuffer[1] = value >> 8;
+    return n;
+}
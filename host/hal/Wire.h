@@ -0,0 +1,60 @@
+// Wire.h - хостовая шина I2C: устройства из host::env(), время транзакций идет в виртуальные часы
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire : public Stream {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return clock; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+    int available() override { return rxLength - rxIndex; }
+    int read() override { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+    int peek() override { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+
+    // Хостовая сторона: данные, которые вернет следующий requestFrom() к address
+    void hostSetResponse(uint8_t address, const uint8_t* data, uint8_t length);
+    // Последний байт, записанный устройству address (команда BH1750)
+    int hostLastCommand(uint8_t address) const;
+    // Канал TCA9548A, выбранный сейчас (0, если мультиплексора нет)
+    uint8_t hostMuxChannel() const;
+
+private:
+    void chargeBusTime(size_t bytes);
+    bool devicePresent(uint8_t address) const;
+    // VEML7700: запись регистра или указателя на регистр, чтение по указателю
+    void vemlWrite();
+    uint8_t vemlRead(uint8_t quantity);
+
+    bool started = false;
+    uint32_t clock = 100000;
+    uint8_t txAddress = 0;
+    size_t txLength = 0;
+    uint8_t txLast = 0;
+    uint8_t txBuffer[32] = {0};
+    uint8_t rxBuffer[32] = {0};
+    int rxLength = 0;
+    int rxIndex = 0;
+    uint8_t respAddress = 0;
+    uint8_t respData[32] = {0};
+    uint8_t respLength = 0;
+    uint8_t lastCmdAddress = 0;
+    int lastCmd = -1;
+    uint8_t muxMask = 0;          // каналы TCA9548A, подключенные к шине
+    uint8_t vemlPointer = 0;
+    uint16_t vemlConf = 0x0001;   // ALS_CONF после включения питания: SD = 1
+};
+
+extern TwoWire Wire;
+
+#endif
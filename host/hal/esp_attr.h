@@ -0,0 +1,11 @@
+// esp_attr.h - хостовая замена: атрибуты размещения в памяти ESP32 ничего не делают
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+// На ESP32 - RTC slow memory, не очищается при программном сбросе и панике.
+// На хосте процесс каждый раз стартует заново, это обычная статическая память
+#define RTC_NOINIT_ATTR
+
+#endif
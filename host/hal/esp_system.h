@@ -0,0 +1,32 @@
+// esp_system.h - хостовая замена: причина сброса и обработчики перезагрузки
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+typedef int esp_err_t;
+#define ESP_OK                 0
+#define ESP_ERR_NO_MEM         0x101
+#define ESP_ERR_INVALID_STATE  0x103
+
+typedef void (*shutdown_handler_t)(void);
+
+// host::env().resetReason
+esp_reset_reason_t esp_reset_reason(void);
+// Вызываются из ESP.restart() перед выходом; слотов, как и в ESP-IDF, пять
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler);
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handler);
+
+#endif
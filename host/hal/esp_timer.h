@@ -0,0 +1,9 @@
+// esp_timer.h - хостовая замена: 64-битное время с загрузки в микросекундах
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <cstdint>
+
+int64_t esp_timer_get_time();
+
+#endif
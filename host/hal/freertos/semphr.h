@@ -0,0 +1,16 @@
+// semphr.h - хостовая замена мьютексов FreeRTOS.
+// Задачи и так выполняются по одной, поэтому занятый мьютекс ждут через vTaskDelay():
+// владелец получает управление и когда-нибудь его отпустит
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+struct HostSemaphore;
+typedef HostSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#endif
@@ -0,0 +1,57 @@
+// check.h - проверки хостовых тестов без сторонних фреймворков
+//
+// TEST(name) регистрирует функцию; CHECK* печатают место и значения и
+// продолжают тест, чтобы за один прогон были видны все расхождения
+#ifndef HOST_TEST_CHECK_H
+#define HOST_TEST_CHECK_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace test {
+
+typedef void (*TestFunction)();
+
+struct Registrar {
+    Registrar(const char* name, TestFunction fn);
+};
+
+void fail(const char* file, int line, const char* expression);
+void failValues(const char* file, int line, const char* expression, double actual, double expected);
+void failStrings(const char* file, int line, const char* expression, const char* actual, const char* expected);
+
+}
+
+#define TEST(name) \
+    static void name(); \
+    static test::Registrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { if (!(cond)) test::fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        auto a_ = (actual); \
+        auto e_ = (expected); \
+        if (!(a_ == e_)) test::failValues(__FILE__, __LINE__, #actual " == " #expected, (double)a_, (double)e_); \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double a_ = (actual); \
+        double e_ = (expected); \
+        if (!(std::fabs(a_ - e_) <= (tolerance))) { \
+            test::failValues(__FILE__, __LINE__, #actual " ~ " #expected, a_, e_); \
+        } \
+    } while (0)
+
+#define CHECK_STR(actual, expected) \
+    do { \
+        const char* a_ = (actual); \
+        const char* e_ = (expected); \
+        if (strcmp(a_, e_) != 0) test::failStrings(__FILE__, __LINE__, #actual " == " #expected, a_, e_); \
+    } while (0)
+
+#endif
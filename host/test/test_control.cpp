@@ -0,0 +1,157 @@
+// test_control.cpp - ControlEngine (фильтр, гистерезис, минимальное время) и PiController
+#include "check.h"
+#include "ControlEngine.h"
+#include "PiController.h"
+#include <stdint.h>
+
+namespace {
+
+const float THRESHOLD = 500.0f;
+
+// Без EMA фильтр равен медиане: окно заполняется одним значением
+Settings controlSettings() {
+    Settings settings;
+    settings.hysteresis = 50.0f;
+    settings.minOnTime = 60000;
+    settings.minOffTime = 60000;
+    settings.filterAlpha = 1.0f;
+    return settings;
+}
+
+void fill(ControlEngine& engine, float lux, const Settings& settings, uint32_t& now) {
+    for (uint8_t i = 0; i < ControlEngine::MEDIAN_WINDOW; i++) {
+        now += SENSOR_SAMPLE_INTERVAL;
+        engine.addSample(0, lux, settings, now);
+    }
+}
+
+}
+
+TEST(controlMedianRejectsSpike) {
+    Settings settings = controlSettings();
+    ControlEngine engine;
+    uint32_t now = 0;
+    fill(engine, 400.0f, settings, now);
+    now += SENSOR_SAMPLE_INTERVAL;
+    engine.addSample(0, 100000.0f, settings, now);
+    CHECK_NEAR(engine.getFiltered(0), 400.0f, 0.001);
+    CHECK_NEAR(engine.getStats(0).raw, 100000.0f, 0.001);
+
+    // Разрыв дольше sampleMaxAge начинает окно заново
+    now += settings.sampleMaxAge + 1;
+    engine.addSample(0, 700.0f, settings, now);
+    CHECK_NEAR(engine.getFiltered(0), 700.0f, 0.001);
+}
+
+TEST(controlHysteresisBand) {
+    Settings settings = controlSettings();
+    ControlEngine engine;
+    uint32_t now = 0;
+    uint32_t settled = settings.minOffTime;
+
+    fill(engine, 476.0f, settings, now);
+    CHECK(!engine.decide(0, false, settled, THRESHOLD, 0, settings));
+    fill(engine, 474.0f, settings, now);
+    CHECK(engine.decide(0, false, settled, THRESHOLD, 0, settings));
+
+    fill(engine, 525.0f, settings, now);
+    CHECK(engine.decide(0, true, settled, THRESHOLD, 0, settings));
+    fill(engine, 526.0f, settings, now);
+    CHECK(!engine.decide(0, true, settled, THRESHOLD, 0, settings));
+
+    // Внутри полосы состояние сохраняется в обе стороны
+    fill(engine, 500.0f, settings, now);
+    CHECK(engine.decide(0, true, settled, THRESHOLD, 0, settings));
+    CHECK(!engine.decide(0, false, settled, THRESHOLD, 0, settings));
+}
+
+// Включенная лампа сама поднимает показание: выключение сравнивает свет без нее
+TEST(controlSubtractsLampLight) {
+    Settings settings = controlSettings();
+    ControlEngine engine;
+    uint32_t now = 0;
+    float lamp = ControlEngine::getLampLux(settings);
+    CHECK_NEAR(lamp, settings.lampPpfd / settings.luxToPpfd, 0.01);
+
+    fill(engine, 300.0f + lamp, settings, now);
+    CHECK(engine.decide(0, true, settings.minOnTime, THRESHOLD, lamp, settings));
+    fill(engine, 530.0f + lamp, settings, now);
+    CHECK(!engine.decide(0, true, settings.minOnTime, THRESHOLD, lamp, settings));
+
+    settings.luxToPpfd = 0;
+    CHECK_EQ(ControlEngine::getLampLux(settings), 0.0f);
+}
+
+TEST(controlDwellHoldsSwitch) {
+    Settings settings = controlSettings();
+    ControlEngine engine;
+    uint32_t now = 0;
+    fill(engine, 100.0f, settings, now);
+
+    CHECK(!engine.decide(0, false, 1000, THRESHOLD, 0, settings));
+    CHECK(engine.isHolding(0));
+    CHECK(!engine.decide(0, false, 30000, THRESHOLD, 0, settings));
+    CHECK_EQ(engine.getStats(0).dwellHolds, 1u);   // одно ожидание - один счет
+
+    CHECK(engine.decide(0, false, settings.minOffTime, THRESHOLD, 0, settings));
+    CHECK(!engine.isHolding(0));
+
+    // Переключений с загрузки не было - ждать нечего
+    ControlEngine fresh;
+    now = 0;
+    fill(fresh, 100.0f, settings, now);
+    CHECK(fresh.decide(0, false, UINT32_MAX, THRESHOLD, 0, settings));
+    CHECK_EQ(fresh.getStats(0).dwellHolds, 0u);
+
+    // Выключение ждет minOnTime так же
+    fill(engine, 2000.0f, settings, now);
+    CHECK(engine.decide(0, true, settings.minOnTime - 1, THRESHOLD, 0, settings));
+    CHECK(!engine.decide(0, true, settings.minOnTime, THRESHOLD, 0, settings));
+    CHECK_EQ(engine.getStats(0).dwellHolds, 2u);
+}
+
+TEST(piIntegratesWithRealDt) {
+    PiController pi;
+    pi.configure(0, 1.0f, 1000);   // 1 единица выхода на lux в секунду
+    pi.reset();
+    CHECK_EQ(pi.update(10, 0, 1000), 10);
+    CHECK_EQ(pi.update(10, 0, 500), 15);
+    CHECK_EQ(pi.update(10, 0, 0), 15);   // первый шаг после reset(): интеграл не меняется
+    // Пропуск в данных считается как MAX_DT_MS, а не как минуты накопления
+    CHECK_EQ(pi.update(10, 0, 600000), 670);
+}
+
+TEST(piSaturationDoesNotWindUp) {
+    PiController pi;
+    pi.configure(1.0f, 10.0f, 1000);
+    pi.reset();
+
+    // Большая ошибка: выход в упоре, интеграл доходит только до упора
+    for (int i = 0; i < 100; i++) CHECK(pi.update(5000, 0, 100) <= 1000);
+    CHECK_EQ(pi.getOutput(), 1000);
+    PiStats stats = pi.getStats();
+    CHECK(stats.saturated > 90);
+    CHECK(stats.integral <= 1000.0f);
+
+    // Ошибка сменила знак - выход сразу уходит из упора, а не отрабатывает накопленное
+    pi.update(0, 200, 100);
+    CHECK(pi.getOutput() < 1000);
+
+    // Нижний упор: интеграл опускается до нуля выхода, а не замирает выше
+    pi.configure(0, 1.0f, 1000);
+    pi.reset(5);
+    CHECK_EQ(pi.update(0, 100, 1000), 0);
+    CHECK_NEAR(pi.getStats().integral, 0.0f, 0.001);
+    CHECK_EQ(pi.update(0, 100, 1000), 0);
+    CHECK_EQ(pi.update(10, 0, 1000), 10);   // и сразу растет обратно
+}
+
+TEST(piResetIsBumpless) {
+    PiController pi;
+    pi.configure(0.5f, 1.0f, 4095);
+    pi.reset(4095);
+    CHECK_EQ(pi.getOutput(), 4095);
+    CHECK_EQ(pi.update(600, 600, 0), 4095);
+    pi.reset(5000);   // за пределом outMax
+    CHECK_EQ(pi.getOutput(), 4095);
+}
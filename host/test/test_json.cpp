@@ -0,0 +1,299 @@
+// test_json.cpp - JsonReader: escape-последовательности, числа, ошибки разбора; обратный ход JsonWriter
+#include "check.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+
+namespace {
+
+JsonReader reader(const char* text) {
+    return JsonReader(text, strlen(text));
+}
+
+// Разбирает документ до конца; nullptr - без ошибок
+const char* firstError(const char* text, size_t& position) {
+    JsonReader json = reader(text);
+    JsonToken token;
+    while ((token = json.next()) != JSON_END && token != JSON_ERROR) {}
+    position = json.getErrorPosition();
+    return token == JSON_ERROR ? json.getError() : nullptr;
+}
+
+void checkError(const char* file, int line, const char* text, const char* message, size_t position) {
+    size_t actual = 0;
+    const char* error = firstError(text, actual);
+    if (!error) {
+        test::failStrings(file, line, text, "ok", message);
+    } else if (strcmp(error, message) != 0) {
+        test::failStrings(file, line, text, error, message);
+    } else if (actual != position) {
+        test::failValues(file, line, text, (double)actual, (double)position);
+    }
+}
+
+#define CHECK_ERROR(text, message, position) checkError(__FILE__, __LINE__, text, message, position)
+
+}
+
+TEST(jsonDecodesEscapes) {
+    JsonReader json = reader("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\u20AC\\ud83c\\udf31\"");
+    CHECK_EQ(json.next(), JSON_STRING);
+    char out[32];
+    CHECK(json.copyString(out, sizeof(out)));
+    CHECK_STR(out, "\"\\/\b\f\n\r\t\xc3\xa9\xe2\x82\xac\xf0\x9f\x8c\xb1");
+    CHECK_EQ(json.next(), JSON_END);
+
+    // Без escape текст отдается как есть, включая UTF-8
+    JsonReader plain = reader("\"\xd1\x81\xd0\xb2\xd0\xb5\xd1\x82\"");
+    CHECK_EQ(plain.next(), JSON_STRING);
+    CHECK(plain.copyString(out, sizeof(out)));
+    CHECK_STR(out, "\xd1\x81\xd0\xb2\xd0\xb5\xd1\x82");
+}
+
+// NUL оборвал бы C-строку, одиночный суррогат - не UTF-8: такие строки не копируются
+TEST(jsonRejectsUnrepresentableStrings) {
+    const char* texts[] = {"\"\\u0000\"", "\"a\\u0000b\"", "\"\\ud83c\"", "\"\\ud83cx\"", "\"\\udf31\"",
+                           "\"\\ud83c\\u0041\""};
+    for (const char* text : texts) {
+        JsonReader json = reader(text);
+        CHECK_EQ(json.next(), JSON_STRING);
+        char out[16];
+        if (json.copyString(out, sizeof(out))) test::failStrings(__FILE__, __LINE__, "!copyString", out, text);
+        CHECK(strlen(out) < sizeof(out));
+    }
+
+    JsonReader key = reader("{\"a\\u0000\":1}");
+    key.next();
+    CHECK_EQ(key.next(), JSON_KEY);
+    CHECK(!key.keyIs("a"));
+}
+
+TEST(jsonCopyStringTruncation) {
+    JsonReader json = reader("[\"abcdef\",\"ab\\u00e9\",1]");
+    json.next();
+    CHECK_EQ(json.next(), JSON_STRING);
+    char out[8];
+    CHECK(json.copyString(out, 7));
+    CHECK_STR(out, "abcdef");
+    CHECK(!json.copyString(out, 6));
+    CHECK_STR(out, "abcde");   // при отказе в буфере все равно C-строка
+    CHECK(!json.copyString(out, 0));
+
+    // Многобайтовый символ не режется пополам
+    CHECK_EQ(json.next(), JSON_STRING);
+    CHECK(!json.copyString(out, 4));
+    CHECK_STR(out, "ab");
+    CHECK(json.copyString(out, 5));
+    CHECK_STR(out, "ab\xc3\xa9");
+
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(!json.copyString(out, sizeof(out)));
+}
+
+TEST(jsonKeyIs) {
+    JsonReader json = reader("{\"th\\u0072eshold\":1,\"mode\":\"mo\\/de\",\"threshold2\":2}");
+    json.next();
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs("threshold"));
+    CHECK(!json.keyIs("thresholds"));
+    CHECK(!json.keyIs("thr"));
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(!json.keyIs("1"));   // число - не строка
+
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs("mode"));
+    CHECK_EQ(json.next(), JSON_STRING);
+    CHECK(json.keyIs("mo/de"));
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(!json.keyIs("threshold"));
+}
+
+TEST(jsonNumbers) {
+    JsonReader json = reader("[4294967295,4294967296,-1,1.0,1e3,-2147483648,2147483647,2147483648,"
+                             "-2147483649,-0,-12.5e-1,1e39,0]");
+    json.next();
+    uint32_t u = 0;
+    int32_t i = 0;
+    float f = 0;
+
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(json.getUint32(u));
+    CHECK_EQ(u, 4294967295u);
+    CHECK(!json.getInt32(i));
+    json.next();
+    CHECK(!json.getUint32(u));
+    json.next();
+    CHECK(!json.getUint32(u));
+    CHECK(json.getInt32(i));
+    CHECK_EQ(i, -1);
+    json.next();
+    CHECK(!json.getUint32(u));   // дробная запись целого - не целое
+    CHECK(json.getFloat(f));
+    CHECK_EQ(f, 1.0f);
+    json.next();
+    CHECK(!json.getInt32(i));
+    CHECK(json.getFloat(f));
+    CHECK_EQ(f, 1000.0f);
+
+    json.next();
+    CHECK(json.getInt32(i));
+    CHECK_EQ(i, INT32_MIN);
+    json.next();
+    CHECK(json.getInt32(i));
+    CHECK_EQ(i, INT32_MAX);
+    json.next();
+    CHECK(!json.getInt32(i));
+    json.next();
+    CHECK(!json.getInt32(i));
+    json.next();
+    CHECK(json.getInt32(i));
+    CHECK_EQ(i, 0);
+
+    json.next();
+    CHECK(json.getFloat(f));
+    CHECK_NEAR(f, -1.25, 1e-6);
+    json.next();
+    CHECK(!json.getFloat(f));   // за пределом float
+    json.next();
+    CHECK(json.getUint32(u));
+    CHECK_EQ(u, 0u);
+
+    CHECK_EQ(json.next(), JSON_ARRAY_END);
+    CHECK(!json.getUint32(u));
+    CHECK_EQ(json.next(), JSON_END);
+}
+
+TEST(jsonMalformed) {
+    CHECK_ERROR("", "unexpected end of input", 0);
+    CHECK_ERROR("  ", "unexpected end of input", 2);
+    CHECK_ERROR("[1,", "unexpected end of input", 3);
+    CHECK_ERROR("{\"a\":", "unexpected end of input", 5);
+    CHECK_ERROR("{} x", "unexpected data after JSON value", 3);
+    CHECK_ERROR("01", "unexpected data after JSON value", 1);
+    CHECK_ERROR("{\"a\":1,}", "expected string key", 7);
+    CHECK_ERROR("[1,]", "unexpected character", 3);
+    CHECK_ERROR("{\"a\" 1}", "expected ':'", 5);
+    CHECK_ERROR("{1:2}", "expected string key", 1);
+    CHECK_ERROR("{'a':1}", "expected string key", 1);
+
+    CHECK_ERROR("\"abc", "unterminated string", 4);
+    CHECK_ERROR("\"abc\\", "unterminated string", 4);
+    CHECK_ERROR("\"\\u12", "unterminated string", 1);
+    CHECK_ERROR("\"a\x01\"", "control character in string", 2);
+    CHECK_ERROR("\"a\nb\"", "control character in string", 2);
+    CHECK_ERROR("\"\\x\"", "invalid escape", 2);
+    CHECK_ERROR("\"\\U0041\"", "invalid escape", 2);
+    CHECK_ERROR("\"\\u12g4\"", "invalid \\u escape", 5);
+    CHECK_ERROR("\"\\u12\"", "invalid \\u escape", 5);
+
+    CHECK_ERROR("1.", "invalid number", 2);
+    CHECK_ERROR("-", "invalid number", 1);
+    CHECK_ERROR("-a", "invalid number", 1);
+    CHECK_ERROR("1e", "invalid number", 2);
+    CHECK_ERROR("1e+", "invalid number", 3);
+    CHECK_ERROR(".5", "unexpected character", 0);
+    CHECK_ERROR("+1", "unexpected character", 0);
+    CHECK_ERROR("tru", "invalid literal", 0);
+    CHECK_ERROR("[nul]", "invalid literal", 1);
+    CHECK_ERROR("True", "unexpected character", 0);
+}
+
+TEST(jsonNesting) {
+    char text[2 * JsonReader::MAX_DEPTH + 3];
+    memset(text, '[', JsonReader::MAX_DEPTH);
+    memset(text + JsonReader::MAX_DEPTH, ']', JsonReader::MAX_DEPTH);
+    text[2 * JsonReader::MAX_DEPTH] = '\0';
+    size_t position;
+    CHECK(firstError(text, position) == nullptr);
+
+    memset(text, '[', JsonReader::MAX_DEPTH + 1);
+    memset(text + JsonReader::MAX_DEPTH + 1, ']', JsonReader::MAX_DEPTH + 1);
+    text[2 * JsonReader::MAX_DEPTH + 2] = '\0';
+    CHECK_ERROR(text, "nesting too deep", JsonReader::MAX_DEPTH);
+
+    CHECK_ERROR("[1}", "expected ',' or ']'", 2);
+    CHECK_ERROR("{\"a\":1]", "expected ',' or '}'", 6);
+    CHECK_ERROR("[}", "unexpected character", 1);
+    CHECK_ERROR("{]", "expected string key", 1);
+    CHECK_ERROR("[[1]", "unexpected end of input", 4);
+    CHECK_ERROR("[1]]", "unexpected data after JSON value", 3);
+
+    // После ошибки разбор стоит на ней
+    JsonReader json = reader("[1}");
+    json.next();
+    json.next();
+    CHECK_EQ(json.next(), JSON_ERROR);
+    CHECK_EQ(json.next(), JSON_ERROR);
+    CHECK_EQ(json.getErrorPosition(), 2u);
+}
+
+TEST(jsonSkipValue) {
+    JsonReader json = reader("{\"a\":{\"b\":[1,{\"c\":[]}],\"d\":\"}\"},\"e\":2,\"f\":true}");
+    CHECK_EQ(json.next(), JSON_OBJECT_START);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.skipValue());
+    CHECK_EQ(json.getDepth(), 1);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs("e"));
+    CHECK(json.skipValue());
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs("f"));
+    CHECK(json.skipValue());
+    CHECK_EQ(json.next(), JSON_OBJECT_END);
+    CHECK_EQ(json.next(), JSON_END);
+
+    JsonReader broken = reader("{\"a\":[1,{\"b\":}],\"c\":1}");
+    broken.next();
+    broken.next();
+    CHECK(!broken.skipValue());
+    CHECK_STR(broken.getError(), "unexpected character");
+    CHECK_EQ(broken.getErrorPosition(), 13u);
+}
+
+// Что пишет JsonWriter, то JsonReader читает обратно без потерь
+TEST(jsonWriterRoundTrip) {
+    const char* text = "q\"b\\s/\n\r\t\x01\x1f \xc3\xa9\xf0\x9f\x8c\xb1";
+    char buffer[256];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.beginObject()
+        .field(text, text)
+        .field("min", (long long)INT32_MIN)
+        .field("max", (unsigned long long)UINT32_MAX)
+        .field("lux", 1234.5f, 1)
+        .field("nan", NAN)
+        .key("list").beginArray().value(true).value(false).null().beginArray().endArray().endArray()
+        .endObject();
+    CHECK(!writer.overflow());
+
+    JsonReader json(writer.c_str(), writer.length());
+    char out[64];
+    CHECK_EQ(json.next(), JSON_OBJECT_START);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs(text));
+    CHECK_EQ(json.next(), JSON_STRING);
+    CHECK(json.copyString(out, sizeof(out)));
+    CHECK_STR(out, text);
+
+    int32_t i = 0;
+    uint32_t u = 0;
+    float f = 0;
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(json.getInt32(i));
+    CHECK_EQ(i, INT32_MIN);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(json.getUint32(u));
+    CHECK_EQ(u, UINT32_MAX);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK_EQ(json.next(), JSON_NUMBER);
+    CHECK(json.getFloat(f));
+    CHECK_EQ(f, 1234.5f);
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK_EQ(json.next(), JSON_NULL);
+
+    CHECK_EQ(json.next(), JSON_KEY);
+    CHECK(json.keyIs("list"));
+    const JsonToken list[] = {JSON_ARRAY_START, JSON_TRUE, JSON_FALSE, JSON_NULL, JSON_ARRAY_START,
+                              JSON_ARRAY_END, JSON_ARRAY_END, JSON_OBJECT_END, JSON_END};
+    for (JsonToken expected : list) CHECK_EQ(json.next(), expected);
+}
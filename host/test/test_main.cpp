@@ -0,0 +1,58 @@
+// test_main.cpp - хостовые тесты модулей прошивки: build/phyto_test [фильтр]
+//
+// Фильтр - подстрока имени теста. Код возврата 1, если хоть одна проверка не прошла
+#include "check.h"
+#include "HostHal.h"
+#include <vector>
+
+namespace {
+
+struct Entry {
+    const char* name;
+    test::TestFunction fn;
+};
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> tests;
+    return tests;
+}
+
+unsigned failures = 0;
+const char* current = "";
+
+}
+
+test::Registrar::Registrar(const char* name, TestFunction fn) {
+    registry().push_back(Entry{name, fn});
+}
+
+void test::fail(const char* file, int line, const char* expression) {
+    printf("FAIL %s  %s:%d: %s\n", current, file, line, expression);
+    failures++;
+}
+
+void test::failValues(const char* file, int line, const char* expression, double actual, double expected) {
+    printf("FAIL %s  %s:%d: %s (получено %g, ожидалось %g)\n", current, file, line, expression, actual, expected);
+    failures++;
+}
+
+void test::failStrings(const char* file, int line, const char* expression, const char* actual, const char* expected) {
+    printf("FAIL %s  %s:%d: %s (получено \"%s\", ожидалось \"%s\")\n", current, file, line, expression, actual, expected);
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    host::setSerialEcho(false);
+    unsigned run = 0, failed = 0;
+    for (const Entry& entry : registry()) {
+        if (!strstr(entry.name, filter)) continue;
+        current = entry.name;
+        unsigned before = failures;
+        entry.fn();
+        run++;
+        if (failures != before) failed++;
+    }
+    printf("%u тестов, %u с ошибками, %u проверок не прошло\n", run, failed, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+// test_schedule.cpp - Schedule::compile/countActive и местное время Clock
+#include "check.h"
+#include "Clock.h"
+#include "HostHal.h"
+#include "Schedule.h"
+
+namespace {
+
+enum { MO, TU, WE, TH, FR, SA, SU };
+
+uint16_t at(uint8_t hours, uint8_t minutes) {
+    return hours * 60 + minutes;
+}
+
+Schedule compiled(const char* text) {
+    Schedule schedule;
+    bool ok = Schedule::compile(text, &schedule);
+    if (!ok) test::failStrings(__FILE__, __LINE__, "Schedule::compile", "false", text);
+    return schedule;
+}
+
+// countActive() по словам против перебора isActive() по минутам
+uint16_t countSlow(const Schedule& schedule, uint8_t weekday, uint16_t from, uint16_t to) {
+    uint16_t minutes = 0;
+    for (uint16_t m = from; m < to; m++) minutes += schedule.isActive(weekday, m);
+    return minutes;
+}
+
+}
+
+TEST(scheduleSingleWindow) {
+    Schedule s = compiled("08:00-20:00");
+    for (uint8_t d = MO; d <= SU; d++) {
+        CHECK(!s.isActive(d, at(7, 59)));
+        CHECK(s.isActive(d, at(8, 0)));
+        CHECK(s.isActive(d, at(19, 59)));
+        CHECK(!s.isActive(d, at(20, 0)));
+    }
+    CHECK_EQ(s.getMinutesPerWeek(), 720 * 7);
+}
+
+TEST(scheduleEndAt2400) {
+    Schedule s = compiled("20:00-24:00");
+    CHECK(s.isActive(MO, 1439));
+    CHECK(!s.isActive(TU, 0));
+    CHECK_EQ(s.getMinutesPerWeek(), 240 * 7);
+
+    Schedule all = compiled("00:00-24:00");
+    CHECK_EQ(all.getMinutesPerWeek(), Schedule::MINUTES_PER_DAY * 7);
+}
+
+TEST(scheduleCrossesMidnight) {
+    Schedule daily = compiled("22:00-06:00");
+    CHECK(daily.isActive(MO, at(22, 0)));
+    CHECK(daily.isActive(TU, at(5, 59)));
+    CHECK(!daily.isActive(TU, at(6, 0)));
+    CHECK(!daily.isActive(TU, at(21, 59)));
+    CHECK_EQ(daily.getMinutesPerWeek(), 480 * 7);
+
+    // Хвост окна пятницы - утро субботы, а не пятницы
+    Schedule friday = compiled("Fr 22:00-02:00");
+    CHECK(friday.isActive(FR, at(23, 0)));
+    CHECK(friday.isActive(SA, at(1, 59)));
+    CHECK(!friday.isActive(SA, at(2, 0)));
+    CHECK(!friday.isActive(FR, at(1, 0)));
+    CHECK(!friday.isActive(SA, at(23, 0)));
+    CHECK_EQ(friday.getMinutesPerWeek(), 240);
+
+    // Воскресенье переходит в понедельник
+    Schedule sunday = compiled("Su 23:00-01:00");
+    CHECK(sunday.isActive(SU, at(23, 30)));
+    CHECK(sunday.isActive(MO, at(0, 30)));
+    CHECK(!sunday.isActive(MO, at(23, 30)));
+    CHECK(!sunday.isActive(SA, at(23, 30)));
+}
+
+TEST(scheduleWeekdayRanges) {
+    Schedule wrap = compiled("Sa-Mo 10:00-11:00");
+    CHECK(wrap.isActive(SA, at(10, 30)));
+    CHECK(wrap.isActive(SU, at(10, 30)));
+    CHECK(wrap.isActive(MO, at(10, 30)));
+    for (uint8_t d = TU; d <= FR; d++) CHECK(!wrap.isActive(d, at(10, 30)));
+
+    Schedule groups = compiled("Mo-Fr 07:00-12:00,13:00-21:00;Sa,Su 09:00-18:00");
+    CHECK(groups.isActive(WE, at(7, 0)));
+    CHECK(!groups.isActive(WE, at(12, 30)));
+    CHECK(!groups.isActive(SA, at(8, 0)));
+    CHECK(groups.isActive(SU, at(17, 59)));
+    CHECK_EQ(groups.getMinutesPerWeek(), 5 * (300 + 480) + 2 * 540);
+
+    // Группы объединяются, пробелы вокруг разделителей допустимы
+    Schedule merged = compiled("Mo 08:00-10:00 ; Mo 09:00-11:00 , 12:00-12:01");
+    CHECK_EQ(merged.countActive(MO, 0, Schedule::MINUTES_PER_DAY), 181);
+}
+
+TEST(scheduleRejectsBadText) {
+    const char* bad[] = {
+        "", "   ", "8:00-20:00", "08:00-20:0", "08:00 20:00", "08:00-08:00", "24:00-06:00",
+        "08:00-24:01", "08:60-09:00", "25:00-26:00", "08:00-20:00;", "08:00-20:00,", "Xx 08:00-10:00",
+        "Mo08:00-10:00", "Mo- 08:00-10:00", "Mo,08:00-10:00", "08:00-20:00 x",
+    };
+    Schedule s = compiled("08:00-09:00");
+    for (const char* text : bad) {
+        if (Schedule::compile(text, &s)) test::failStrings(__FILE__, __LINE__, "!Schedule::compile", "true", text);
+        CHECK(!Schedule::compile(text, nullptr));
+    }
+    // Ошибка не портит прежнее расписание
+    CHECK_EQ(s.getMinutesPerWeek(), 60 * 7);
+}
+
+// Края слов по 32 минуты: маска первого и последнего слова, целые слова, пустые отрезки
+TEST(scheduleCountActiveWordEdges) {
+    Schedule s = compiled("00:31-01:05,23:28-24:00");
+    CHECK_EQ(s.countActive(MO, 0, Schedule::MINUTES_PER_DAY), 34 + 32);
+    CHECK_EQ(s.countActive(MO, 32, 64), 32);
+    CHECK_EQ(s.countActive(MO, 31, 32), 1);
+    CHECK_EQ(s.countActive(MO, 64, 65), 1);
+    CHECK_EQ(s.countActive(MO, 65, 96), 0);
+    CHECK_EQ(s.countActive(MO, 0, 31), 0);
+    CHECK_EQ(s.countActive(MO, 1408, 1440), 32);
+    CHECK_EQ(s.countActive(MO, 1439, 1440), 1);
+    CHECK_EQ(s.countActive(MO, 100, 100), 0);
+
+    const char* texts[] = {"00:31-01:05,23:28-24:00", "Mo-Fr 07:13-12:47,13:00-21:01;Sa,Su 09:00-18:00",
+                           "22:17-05:43", "00:00-24:00"};
+    uint32_t seed = 12345;
+    for (const char* text : texts) {
+        Schedule schedule = compiled(text);
+        for (int i = 0; i < 2000; i++) {
+            seed = seed * 1103515245 + 12345;
+            uint16_t a = (seed >> 8) % (Schedule::MINUTES_PER_DAY + 1);
+            seed = seed * 1103515245 + 12345;
+            uint16_t b = (seed >> 8) % (Schedule::MINUTES_PER_DAY + 1);
+            uint16_t from = a < b ? a : b, to = a < b ? b : a;
+            uint8_t day = i % 7;
+            CHECK_EQ(schedule.countActive(day, from, to), countSlow(schedule, day, from, to));
+        }
+    }
+}
+
+// Часы: до установки времени нет, дальше UTC идет от виртуального таймера прослойки
+TEST(clockLocalTime) {
+    LocalTime local;
+    if (!Clock::isSet()) CHECK(!Clock::getLocal(0, local));
+    CHECK(!Clock::set(Clock::MIN_VALID_TIME - 1, CLOCK_SOURCE_API));
+
+    // 2024-01-01 00:00 UTC - понедельник
+    CHECK(Clock::set(Clock::MIN_VALID_TIME, CLOCK_SOURCE_API));
+    CHECK_EQ(Clock::getSource(), CLOCK_SOURCE_API);
+    CHECK(Clock::getLocal(180, local));
+    CHECK_EQ(local.weekday, MO);
+    CHECK_EQ(local.minute, at(3, 0));
+    CHECK(Clock::getLocal(-60, local));
+    CHECK_EQ(local.weekday, SU);
+    CHECK_EQ(local.minute, at(23, 0));
+
+    host::advanceMicros(90ULL * 1000000);
+    CHECK_EQ(Clock::now(), Clock::MIN_VALID_TIME + 90);
+    CHECK(Clock::getLocal(0, local));
+    CHECK_EQ(local.minute, 1);
+
+    // Неделя вперед - снова понедельник
+    CHECK(Clock::set(Clock::MIN_VALID_TIME + 7 * 86400 + 86399, CLOCK_SOURCE_SNTP));
+    CHECK(Clock::getLocal(0, local));
+    CHECK_EQ(local.weekday, MO);
+    CHECK_EQ(local.minute, 1439);
+}
@@ -0,0 +1,96 @@
+// trace_decode.cpp - разбор двоичной трассировки EventTrace в текст
+//
+// Источник - снимок с флеша (/logs/trace.bin, /logs/trace-crash.bin) или ответ /api/trace:
+//   curl -s http://192.168.4.1/api/trace > trace.bin && build/trace_decode trace.bin
+//   curl -s http://192.168.4.1/api/trace | build/trace_decode -
+#include "EventTrace.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char* snapshotReasonName(uint16_t reason) {
+    switch (reason) {
+        case 0: return "live";
+        case TRACE_SNAPSHOT_REQUEST: return "request";
+        case TRACE_SNAPSHOT_RESTART: return "restart";
+        case TRACE_SNAPSHOT_CRASH: return "crash";
+        default: return "unknown";
+    }
+}
+
+const char* resetReasonName(uint16_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON: return "poweron";
+        case ESP_RST_EXT: return "ext";
+        case ESP_RST_SW: return "sw";
+        case ESP_RST_PANIC: return "panic";
+        case ESP_RST_INT_WDT: return "int_wdt";
+        case ESP_RST_TASK_WDT: return "task_wdt";
+        case ESP_RST_WDT: return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT: return "brownout";
+        default: return "unknown";
+    }
+}
+
+bool decode(FILE* in, const char* name) {
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != TRACE_FILE_MAGIC) {
+        fprintf(stderr, "%s: не трассировка EventTrace\n", name);
+        return false;
+    }
+    if (header.version != TRACE_FILE_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s: версия %u, запись %u байт - не поддерживается\n",
+                name, header.version, header.recordSize);
+        return false;
+    }
+
+    printf("# %s: %u records, %u dropped, snapshot=%s, reset=%s\n", name,
+           header.count, header.dropped, snapshotReasonName(header.reason),
+           resetReasonName(header.resetReason));
+
+    TraceRecord record;
+    uint32_t read = 0;
+    while (read < header.count && fread(&record, sizeof(record), 1, in) == 1) {
+        uint32_t ms = record.timestamp;
+        printf("[%u:%02u:%02u.%03u] %-18s arg=%-5u ", ms / 3600000, ms / 60000 % 60, ms / 1000 % 60,
+               ms % 1000, EventTrace::getEventName(record.event), record.arg);
+        if (EventTrace::getValueType(record.event) == TRACE_VALUE_FLOAT) {
+            printf("value=%.2f\n", record.value.f);
+        } else {
+            printf("value=%d\n", record.value.i);
+        }
+        read++;
+    }
+    if (read < header.count) {
+        fprintf(stderr, "%s: файл обрезан, прочитано %u из %u записей\n", name, read, header.count);
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s FILE... (- для stdin)\n", argv[0]);
+        return 2;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-") == 0) {
+            ok = decode(stdin, "stdin") && ok;
+            continue;
+        }
+        FILE* in = fopen(argv[i], "rb");
+        if (!in) {
+            perror(argv[i]);
+            ok = false;
+            continue;
+        }
+        ok = decode(in, argv[i]) && ok;
+        fclose(in);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# gen_dashboard.py - упаковывает web/index.html в Dashboard.h (gzip-массив во флеше)
+#
+# Запуск после правки index.html:  python3 web/gen_dashboard.py
+# Хостовая сборка (host/Makefile) перегенерирует Dashboard.h сама.
+# Результат детерминирован (mtime=0), поэтому ETag меняется только вместе со страницей.
+import gzip
+import hashlib
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, "web", "index.html")
+TARGET = os.path.join(ROOT, "Dashboard.h")
+
+
+def main():
+    source = sys.argv[1] if len(sys.argv) > 1 else SOURCE
+    target = sys.argv[2] if len(sys.argv) > 2 else TARGET
+
+    with open(source, "rb") as f:
+        html = f.read()
+    packed = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(packed).hexdigest()[:16]
+
+    lines = [
+        "// Dashboard.h - сгенерировано web/gen_dashboard.py из web/index.html, не редактировать",
+        "#ifndef DASHBOARD_H",
+        "#define DASHBOARD_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// index.html: %d байт, gzip: %d байт" % (len(html), len(packed)),
+        "const char DASHBOARD_ETAG[] = \"\\\"%s\\\"\";" % etag,
+        "const size_t DASHBOARD_GZ_SIZE = %d;" % len(packed),
+        "const uint8_t DASHBOARD_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(packed), 16):
+        chunk = packed[i:i + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif", ""]
+
+    text = "\n".join(lines)
+    # Тот же результат не переписываем, только обновляем время для make
+    if os.path.exists(target):
+        with open(target, encoding="utf-8") as f:
+            if f.read() == text:
+                os.utime(target)
+                return
+    with open(target, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()